@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds the interpreter with both dispatch strategies and prints the time
+# per executed instruction of each VM on every sample program.
+set -e
+cd "$(dirname "$0")/.."
+CXX=${CXX:-g++}
+BUILD=${BUILD:-/tmp/tkom-dispatch}
+SOURCES=$(find src -name '*.cpp')
+mkdir -p "$BUILD"
+$CXX -std=c++20 -O2 -w $SOURCES -o "$BUILD/tkom-goto"
+$CXX -std=c++20 -O2 -w -DTKOM_SWITCH_DISPATCH $SOURCES -o "$BUILD/tkom-switch"
+
+printf '%-26s %-9s %-8s %s\n' program engine dispatch ns/instruction
+for program in benchmarks/*.tkom; do
+  for engine in bytecode register; do
+    for variant in goto switch; do
+      time=$("$BUILD/tkom-$variant" --engine=$engine --stats "$program" 2>&1 \
+        >/dev/null | sed -n 's/^Time per instruction: \(.*\) ns/\1/p')
+      printf '%-26s %-9s %-8s %s\n' "$program" "$engine" "$variant" "$time"
+    done
+  done
+done
@@ -0,0 +1,452 @@
+#include "CEmitter.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/BoolFunction.h"
+#include "../instructions/Case.h"
+#include "../instructions/FloatFunction.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/IntFunction.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/PrintFunction.h"
+#include "../instructions/Program.h"
+#include "../instructions/StringFunction.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/Resolver.h"
+#include "../interpreter/TypeInference.h"
+#include "CRuntime.h"
+#include <iomanip>
+#include <iterator>
+
+CEmitter::CEmitter(size_t inMaxCallDepth) : maxCallDepth(inMaxCallDepth) {}
+
+std::string CEmitter::emit(const Program &inProgram) {
+  Resolver resolver;
+  resolver.resolve(inProgram);
+  TypeInference typeInference;
+  typeInference.infer(inProgram);
+
+  context.reset();
+  output.str("");
+  indentation = 0;
+  output << CRuntimeSource << "\n";
+  inProgram.accept(*this);
+  return output.str();
+}
+
+Completion CEmitter::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &functionName = function->getIdentifier();
+    if (context.findFunction(functionName) != nullptr)
+      throw InterpreterError("Redefinition of function with name " +
+                             functionName + "!");
+    context.insertFunction(function.get());
+  }
+  const Function *main = inProgram.getMain();
+
+  /* Forward declarations let functions call each other in any order */
+  for (const auto &function : inProgram.getFunctions()) {
+    emitLine(signature(*function) + ";");
+  }
+  for (const auto &function : inProgram.getFunctions()) {
+    output << "\n";
+    emitFunction(*function);
+  }
+
+  /* Parameters of main default to 0 */
+  std::string arguments;
+  for (size_t i = 0; i < main->getArguments().size(); ++i) {
+    arguments += i == 0 ? "tkom::Value(0)" : ", tkom::Value(0)";
+  }
+  output << "\nint main() {\n"
+         << "  return tkom::run(" << maxCallDepth << ", [] {\n"
+         << "    return tkom::call(f_main, std::array<tkom::Value, "
+         << main->getArguments().size() << ">{" << arguments << "});\n"
+         << "  });\n"
+         << "}\n";
+  return Completion::Normal;
+}
+
+void CEmitter::emitFunction(const Function &inFunction) {
+  emittedFunction = &inFunction;
+  bLoopsOnOwnCall = returnsOwnCall(*inFunction.getBlock());
+  emitLine(signature(inFunction) + " {");
+  ++indentation;
+  if (bLoopsOnOwnCall) {
+    /* The frame is declared after the label, so every jump starts anew */
+    emitLine("bool bTailCalled = false;");
+    output << "tailCall:\n";
+  }
+  emitLine("std::array<tkom::Local, " +
+           std::to_string(inFunction.getSlotCount()) + "> s{};");
+  const auto &parameters = inFunction.getArguments();
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    emitLine(slot(i) + ".declare(std::move(arguments[" + std::to_string(i) +
+             "]), " + (parameters[i]->isMutable() ? "true" : "false") + ");");
+  }
+  inFunction.getBlock()->accept(*this);
+  /* Falling off the end of a body returns nothing */
+  emitLine(bLoopsOnOwnCall ? "return tkom::returnNothing(bTailCalled);"
+                           : "return tkom::Value();");
+  --indentation;
+  emitLine("}");
+}
+
+void CEmitter::emitNestedBlock(const Block &inBlock) {
+  ++indentation;
+  inBlock.accept(*this);
+  --indentation;
+}
+
+void CEmitter::emitLine(const std::string &inLine) {
+  output << std::string(2 * indentation, ' ') << inLine << "\n";
+}
+
+std::string CEmitter::compileExpression(const Expression &inExpression) {
+  inExpression.accept(*this);
+  return std::move(result);
+}
+
+/* Spelled in Expression::Operator order */
+static const char *operators[] = {
+    "Sum",       "Substraction", "Multiplication", "Division", "Modulo",
+    "LogicalOr", "LogicalAnd",   "Less",           "LessEqual", "More",
+    "MoreEqual", "Equal",        "NotEqual"};
+
+Completion CEmitter::visit(const BinaryExpression &inBinaryExpression) {
+  auto index = static_cast<size_t>(inBinaryExpression.getOperator());
+  if (index >= std::size(operators))
+    throw InterpreterError("Invalid binary operator!");
+
+  std::string lhs = compileExpression(*inBinaryExpression.getLhs());
+  std::string rhs = compileExpression(*inBinaryExpression.getRhs());
+  if (inBinaryExpression.isLogical())
+    result = std::string("tkom::logical(tkom::Op::") + operators[index] +
+             ", " + lhs + ", [&] { return " + rhs + "; })";
+  else
+    result = std::string("tkom::binary(tkom::Op::") + operators[index] +
+             ", tkom::Operands{" + lhs + ", " + rhs + "})";
+  return Completion::Normal;
+}
+
+std::string CEmitter::compileCondition(const Expression &inCondition,
+                                       const char *inTest) {
+  /* || and && over bools become the C++ operators on their operands,
+   * comparisons yield their outcome directly */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isBoolLogical())
+    return "(" + compileCondition(*binaryExpression->getLhs(), inTest) +
+           (binaryExpression->getOperator() == Expression::Operator::LogicalOr
+                ? " || "
+                : " && ") +
+           compileCondition(*binaryExpression->getRhs(), inTest) + ")";
+  if (binaryExpression && binaryExpression->isComparison())
+    return std::string("tkom::compare(tkom::Op::") +
+           operators[static_cast<size_t>(binaryExpression->getOperator())] +
+           ", tkom::Operands{" +
+           compileExpression(*binaryExpression->getLhs()) + ", " +
+           compileExpression(*binaryExpression->getRhs()) + "})";
+  return std::string(inTest) + "(" + compileExpression(inCondition) + ")";
+}
+
+Completion CEmitter::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const Case &inCase) {
+  emitNestedBlock(*inCase.getBlock());
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const Function &inFunction) {
+  std::string arguments;
+  for (size_t i = 0; i < callArguments.size(); ++i) {
+    arguments += (i == 0 ? "" : ", ") + callArguments[i];
+  }
+  result = "tkom::call(f_" + inFunction.getIdentifier() +
+           ", std::array<tkom::Value, " +
+           std::to_string(callArguments.size()) + ">{" + arguments + "})";
+  return Completion::Normal;
+}
+
+Completion
+CEmitter::visit(const FunctionCallExpression &inFunctionCallExpression) {
+  result = "tkom::requireValue(" +
+           compileCall(*static_cast<const InstructionFunctionCall *>(
+               inFunctionCallExpression.getFunctionCall())) +
+           ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const IfElse &inIfElse) {
+  emitLine("if (" +
+           compileCondition(*inIfElse.getExpression(), "tkom::isTrue") +
+           ") {");
+  emitNestedBlock(*inIfElse.getBlockIf());
+  if (inIfElse.getBlockElse()) {
+    emitLine("} else {");
+    emitNestedBlock(*inIfElse.getBlockElse());
+  }
+  emitLine("}");
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const InstructionAssigment &inAssigment) {
+  const std::string variable = slot(inAssigment.getVariable()->getSlot());
+  emitLine(variable + ".requireAssignable(" +
+           quote(inAssigment.getVariable()->toString()) + ");");
+  emitLine(variable + ".value = " +
+           compileExpression(*inAssigment.getExpression()) + ";");
+  return Completion::Normal;
+}
+
+Completion
+CEmitter::visit(const InstructionDeclarationVariable &inDeclarationVariable) {
+  const std::string variable = slot(inDeclarationVariable.getSlot());
+  emitLine(variable + ".requireUndeclared(" +
+           quote(inDeclarationVariable.getIdentifier()) + ");");
+
+  std::string value = "tkom::Value(0)";
+  if (inDeclarationVariable.getExpression())
+    value = compileExpression(*inDeclarationVariable.getExpression());
+  emitLine(variable + ".declare(" + value + ", " +
+           (inDeclarationVariable.isMutable() ? "true" : "false") + ");");
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const InstructionFunctionCall &inFunctionCall) {
+  emitLine(compileCall(inFunctionCall) + ";");
+  return Completion::Normal;
+}
+
+std::string CEmitter::compileCall(const InstructionFunctionCall &inFunctionCall) {
+  /* Calls the interpreter would reject only fail once they are reached */
+  const std::string &name = inFunctionCall.getFunctionName();
+  auto function = context.findFunction(name);
+  if (function == nullptr)
+    return "(tkom::fail(" +
+           quote("No function found with such name: " + name + "!") +
+           "), tkom::Value())";
+  const auto &arguments = inFunctionCall.getExpressions();
+  if (function->getArguments().size() != arguments.size())
+    return "(tkom::fail(" +
+           quote("Invalid number of arguments for function " + name + "!") +
+           "), tkom::Value())";
+
+  std::vector<std::string> compiledArguments;
+  for (const auto &argument : arguments) {
+    compiledArguments.push_back(compileExpression(*argument));
+  }
+  callArguments = std::move(compiledArguments);
+  function->accept(*this);
+  return std::move(result);
+}
+
+Completion CEmitter::visit(const IntFunction &inIntFunction) {
+  result = "tkom::toInt(" + callArguments[0] + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const StringFunction &inStringFunction) {
+  result = "tkom::toString(" + callArguments[0] + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const FloatFunction &inFloatFunction) {
+  result = "tkom::toFloat(" + callArguments[0] + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const BoolFunction &inBoolFunction) {
+  result = "tkom::toBool(" + callArguments[0] + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const PrintFunction &inPrintFunction) {
+  result = "tkom::print(" + callArguments[0] + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const InstructionReturn &inReturn) {
+  if (const auto *ownCall = findOwnCall(inReturn)) {
+    /* Like a tail call of the interpreter, the arguments are evaluated in
+     * the current frame, which the call then replaces */
+    std::string arguments;
+    for (const auto &argument : ownCall->getExpressions()) {
+      arguments += (arguments.empty() ? "" : ", ") +
+                   compileExpression(*argument);
+    }
+    emitLine("arguments = std::array<tkom::Value, " +
+             std::to_string(ownCall->getExpressions().size()) + ">{" +
+             arguments + "};");
+    emitLine("bTailCalled = true;");
+    emitLine("goto tailCall;");
+  } else if (inReturn.getExpression())
+    emitLine("return " + compileExpression(*inReturn.getExpression()) + ";");
+  else
+    emitLine(bLoopsOnOwnCall ? "return tkom::returnNothing(bTailCalled);"
+                             : "return tkom::Value();");
+  return Completion::Normal;
+}
+
+const InstructionFunctionCall *
+CEmitter::findOwnCall(const InstructionReturn &inReturn) const {
+  auto *callExpression =
+      dynamic_cast<const FunctionCallExpression *>(inReturn.getExpression());
+  if (callExpression == nullptr)
+    return nullptr;
+  const auto *call = static_cast<const InstructionFunctionCall *>(
+      callExpression->getFunctionCall());
+  if (context.findFunction(call->getFunctionName()) != emittedFunction ||
+      call->getExpressions().size() != emittedFunction->getArguments().size())
+    return nullptr;
+  return call;
+}
+
+bool CEmitter::returnsOwnCall(const Block &inBlock) const {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    const Instruction *node = instruction.get();
+    if (auto *returnInstruction = dynamic_cast<const InstructionReturn *>(node)) {
+      if (findOwnCall(*returnInstruction))
+        return true;
+    } else if (auto *block = dynamic_cast<const Block *>(node)) {
+      if (returnsOwnCall(*block))
+        return true;
+    } else if (auto *ifElse = dynamic_cast<const IfElse *>(node)) {
+      if (returnsOwnCall(*ifElse->getBlockIf()) ||
+          (ifElse->getBlockElse() && returnsOwnCall(*ifElse->getBlockElse())))
+        return true;
+    } else if (auto *whileInstruction = dynamic_cast<const While *>(node)) {
+      if (returnsOwnCall(*whileInstruction->getBody()))
+        return true;
+    } else if (auto *match = dynamic_cast<const Match *>(node)) {
+      for (const auto &caseInstruction : match->getCases()) {
+        if (returnsOwnCall(*caseInstruction->getBlock()))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+Completion CEmitter::visit(const Match &inMatch) {
+  /* '_' inside the cases reads the subject from its hidden slot */
+  const std::string subject = slot(inMatch.getSlot());
+  emitLine(subject + ".declare(" +
+           compileExpression(*inMatch.getExpression()) + ", false);");
+
+  std::string keyword = "if";
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    std::string caseValue =
+        compileExpression(*caseInstruction->getExpression());
+    emitLine((keyword == "if" ? "" : "} ") + keyword + " (tkom::matchesCase(" +
+             subject + ".value, " + caseValue + ")) {");
+    caseInstruction->accept(*this);
+    keyword = "else if";
+  }
+  if (!inMatch.getCases().empty())
+    emitLine("}");
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const UnaryExpression &inUnaryExpression) {
+  result = "tkom::negate(" +
+           compileExpression(*inUnaryExpression.getExpression()) + ")";
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  const auto *value = variable->getValue();
+  if (value == nullptr) {
+    result = slot(variable->getSlot()) + ".get(" + quote(*variable->getName()) +
+             ")";
+    return Completion::Normal;
+  }
+
+  const RuntimeValue &constant = value->getRuntimeValue();
+  std::ostringstream literal;
+  switch (constant.getType()) {
+  case RuntimeValue::Type::Int:
+    literal << "tkom::Value(" << constant.getInt() << ")";
+    break;
+  case RuntimeValue::Type::Float:
+    /* Hexadecimal literals keep every bit of the float */
+    literal << "tkom::Value(" << std::hexfloat << constant.getFloat() << "f)";
+    break;
+  case RuntimeValue::Type::Bool:
+    literal << "tkom::Value(" << (constant.getBool() ? "true" : "false")
+            << ")";
+    break;
+  case RuntimeValue::Type::String:
+    literal << "tkom::Value(std::string(" << quote(constant.getString())
+            << "))";
+    break;
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+  result = literal.str();
+  return Completion::Normal;
+}
+
+Completion CEmitter::visit(const While &inWhile) {
+  emitLine("while (" +
+           compileCondition(*inWhile.getExpression(), "tkom::whileCondition") +
+           ") {");
+  emitNestedBlock(*inWhile.getBody());
+  emitLine("}");
+  return Completion::Normal;
+}
+
+std::string CEmitter::signature(const Function &inFunction) {
+  return "static tkom::Value f_" + inFunction.getIdentifier() +
+         "(std::array<tkom::Value, " +
+         std::to_string(inFunction.getArguments().size()) + "> arguments)";
+}
+
+std::string CEmitter::slot(size_t inSlot) {
+  return "s[" + std::to_string(inSlot) + "]";
+}
+
+std::string CEmitter::quote(const std::string &inText) {
+  std::ostringstream quoted;
+  quoted << '"';
+  for (unsigned char character : inText) {
+    switch (character) {
+    case '"':
+      quoted << "\\\"";
+      break;
+    case '\\':
+      quoted << "\\\\";
+      break;
+    case '\n':
+      quoted << "\\n";
+      break;
+    case '\t':
+      quoted << "\\t";
+      break;
+    default:
+      if (character < 0x20 || character >= 0x7f)
+        quoted << '\\' << std::oct << std::setw(3) << std::setfill('0')
+               << static_cast<int>(character) << std::dec;
+      else
+        quoted << character;
+    }
+  }
+  quoted << '"';
+  return quoted.str();
+}
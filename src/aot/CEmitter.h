@@ -0,0 +1,77 @@
+#pragma once
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/VisitorInterpreter.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Translates a program into a self-contained C++17 source file. Every
+ * function becomes a C++ function over dynamically typed tkom::Value with
+ * its frame slots as an array of tkom::Local, and every check the tree
+ * walker performs at runtime is kept, so the binary behaves like the
+ * interpreter. */
+class CEmitter : public VisitorInterpreter {
+public:
+  CEmitter() = default;
+  /* Calls in the emitted program fail beyond inMaxCallDepth nested calls */
+  explicit CEmitter(size_t inMaxCallDepth);
+  std::string emit(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  void emitFunction(const class Function &inFunction);
+  void emitNestedBlock(const class Block &inBlock);
+  void emitLine(const std::string &inLine);
+  std::string compileExpression(const class Expression &inExpression);
+  /* C++ condition applying the runtime function inTest to the value */
+  std::string compileCondition(const class Expression &inCondition,
+                               const char *inTest);
+  std::string compileCall(const class InstructionFunctionCall &inFunctionCall);
+  /* Call returned by inReturn when it calls the emitted function itself */
+  const class InstructionFunctionCall *
+  findOwnCall(const class InstructionReturn &inReturn) const;
+  bool returnsOwnCall(const class Block &inBlock) const;
+  static std::string signature(const class Function &inFunction);
+  static std::string slot(size_t inSlot);
+  static std::string quote(const std::string &inText);
+
+  size_t maxCallDepth = Interpreter::DefaultMaxCallDepth;
+  Context context;
+  std::ostringstream output;
+  size_t indentation = 0;
+  /* C++ expression of the last compiled expression or call */
+  std::string result;
+  /* Arguments of the call being compiled, already in C++ */
+  std::vector<std::string> callArguments;
+  const class Function *emittedFunction = nullptr;
+  /* Returned calls of the function itself jump back to its start */
+  bool bLoopsOnOwnCall = false;
+};
@@ -0,0 +1,498 @@
+#include "CRuntime.h"
+
+const char *const CRuntimeSource = R"RUNTIME(#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define TKOM_NATIVE_STACK 1
+#else
+#define TKOM_NATIVE_STACK 0
+#endif
+
+namespace tkom {
+
+struct Error : std::runtime_error {
+  explicit Error(const std::string &inMessage)
+      : std::runtime_error(inMessage) {}
+};
+
+[[noreturn]] inline void fail(const std::string &inMessage) {
+  throw Error(inMessage);
+}
+
+enum class Type { Void, Int, Float, Bool, String };
+
+struct Value {
+  Value() = default;
+  explicit Value(int inValue) : type(Type::Int), integer(inValue) {}
+  explicit Value(float inValue) : type(Type::Float), floating(inValue) {}
+  explicit Value(bool inValue) : type(Type::Bool), boolean(inValue) {}
+  explicit Value(std::string inValue)
+      : type(Type::String), string(std::move(inValue)) {}
+
+  Type type = Type::Void;
+  int integer = 0;
+  float floating = 0;
+  bool boolean = false;
+  std::string string;
+};
+
+/* Operands are aggregates so that they are evaluated left to right */
+struct Operands {
+  Value lhs;
+  Value rhs;
+};
+
+struct Local {
+  const Value &get(const char *inName) const {
+    if (!bDeclared)
+      fail(std::string("No variable with such name ") + inName + "!");
+    return value;
+  }
+  void requireUndeclared(const char *inName) const {
+    if (bDeclared)
+      fail(std::string("New declaration of local variable named ") + inName +
+           " found!");
+  }
+  void requireAssignable(const char *inName) const {
+    if (!bDeclared)
+      fail(std::string("Variable ") + inName + " is not declared!");
+    if (!bMutable)
+      fail(std::string("Not mutable variable ") + inName +
+           " cannot be modified!");
+  }
+  void declare(Value inValue, bool bInIsMutable) {
+    value = std::move(inValue);
+    bDeclared = true;
+    bMutable = bInIsMutable;
+  }
+
+  Value value;
+  bool bDeclared = false;
+  bool bMutable = false;
+};
+
+enum class Op {
+  Sum,
+  Substraction,
+  Multiplication,
+  Division,
+  Modulo,
+  LogicalOr,
+  LogicalAnd,
+  Less,
+  LessEqual,
+  More,
+  MoreEqual,
+  Equal,
+  NotEqual,
+};
+
+[[noreturn]] inline void invalidOperation(Op inOperator) {
+  static const char *symbols[] = {"+",  "-", "*",  "/", "%",  "||", "&&",
+                                  "<", "<=", ">", ">=", "==", "!="};
+  fail(std::string("Cannot calculate (") +
+       symbols[static_cast<int>(inOperator)] + ")!");
+}
+
+template <class T> Value numericOperation(Op inOperator, T inLhs, T inRhs) {
+  constexpr bool bIsFloat = std::is_same_v<T, float>;
+  switch (inOperator) {
+  case Op::Sum:
+    return Value(static_cast<T>(inLhs + inRhs));
+  case Op::Substraction:
+    return Value(static_cast<T>(inLhs - inRhs));
+  case Op::Multiplication:
+    return Value(static_cast<T>(inLhs * inRhs));
+  case Op::Division:
+    if (inRhs == 0)
+      fail(bIsFloat ? "Cannot divide by 0.0!" : "Cannot divide by 0!");
+    if (!bIsFloat && inLhs == -2147483647 - 1 && inRhs == -1)
+      fail("Integer overflow in division!");
+    return Value(static_cast<T>(inLhs / inRhs));
+  case Op::Modulo:
+    if (inRhs == 0)
+      fail(bIsFloat ? "Cannot modulo by 0.0!" : "Cannot modulo by 0!");
+    if (!bIsFloat && inLhs == -2147483647 - 1 && inRhs == -1)
+      fail("Integer overflow in modulo!");
+    if constexpr (bIsFloat)
+      return Value(std::fmod(inLhs, inRhs));
+    else
+      return Value(inLhs % inRhs);
+  case Op::LogicalOr:
+    return Value(inLhs || inRhs);
+  case Op::LogicalAnd:
+    return Value(inLhs && inRhs);
+  case Op::Less:
+    return Value(inLhs < inRhs);
+  case Op::LessEqual:
+    return Value(inLhs <= inRhs);
+  case Op::More:
+    return Value(inLhs > inRhs);
+  case Op::MoreEqual:
+    return Value(inLhs >= inRhs);
+  case Op::Equal:
+    return Value(inLhs == inRhs);
+  case Op::NotEqual:
+    return Value(inLhs != inRhs);
+  }
+  invalidOperation(inOperator);
+}
+
+inline Value binary(Op inOperator, const Operands &inOperands) {
+  const Value &lhs = inOperands.lhs;
+  const Value &rhs = inOperands.rhs;
+  if (lhs.type == rhs.type) {
+    switch (lhs.type) {
+    case Type::Int:
+      return numericOperation(inOperator, lhs.integer, rhs.integer);
+    case Type::Float:
+      return numericOperation(inOperator, lhs.floating, rhs.floating);
+    case Type::Bool:
+      switch (inOperator) {
+      case Op::LogicalOr:
+        return Value(lhs.boolean || rhs.boolean);
+      case Op::LogicalAnd:
+        return Value(lhs.boolean && rhs.boolean);
+      case Op::Equal:
+        return Value(lhs.boolean == rhs.boolean);
+      case Op::NotEqual:
+        return Value(lhs.boolean != rhs.boolean);
+      default:
+        break;
+      }
+      break;
+    case Type::String:
+      switch (inOperator) {
+      case Op::Sum:
+        return Value(lhs.string + rhs.string);
+      case Op::Equal:
+        return Value(lhs.string == rhs.string);
+      case Op::NotEqual:
+        return Value(lhs.string != rhs.string);
+      default:
+        break;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  invalidOperation(inOperator);
+}
+
+template <class T> bool compareNumbers(Op inOperator, T inLhs, T inRhs) {
+  switch (inOperator) {
+  case Op::Less:
+    return inLhs < inRhs;
+  case Op::LessEqual:
+    return inLhs <= inRhs;
+  case Op::More:
+    return inLhs > inRhs;
+  case Op::MoreEqual:
+    return inLhs >= inRhs;
+  case Op::Equal:
+    return inLhs == inRhs;
+  default:
+    return inLhs != inRhs;
+  }
+}
+
+/* Outcome of a comparison in a condition, without building its bool */
+inline bool compare(Op inOperator, const Operands &inOperands) {
+  const Value &lhs = inOperands.lhs;
+  const Value &rhs = inOperands.rhs;
+  if (lhs.type == rhs.type && lhs.type == Type::Int)
+    return compareNumbers(inOperator, lhs.integer, rhs.integer);
+  if (lhs.type == rhs.type && lhs.type == Type::Float)
+    return compareNumbers(inOperator, lhs.floating, rhs.floating);
+  return binary(inOperator, inOperands).boolean;
+}
+
+/* True when inLhs alone decides || or && */
+inline bool shortCircuits(Op inOperator, const Value &inLhs) {
+  bool bLhs = false;
+  switch (inLhs.type) {
+  case Type::Int:
+    bLhs = inLhs.integer != 0;
+    break;
+  case Type::Float:
+    bLhs = inLhs.floating != 0;
+    break;
+  case Type::Bool:
+    bLhs = inLhs.boolean;
+    break;
+  default:
+    invalidOperation(inOperator);
+  }
+  return bLhs == (inOperator == Op::LogicalOr);
+}
+
+/* The right operand is passed as a callable run only when needed */
+template <class Rhs> Value logical(Op inOperator, Value inLhs, Rhs inRhs) {
+  if (shortCircuits(inOperator, inLhs))
+    return Value(inOperator == Op::LogicalOr);
+  return binary(inOperator, Operands{std::move(inLhs), inRhs()});
+}
+
+inline Value negate(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::Float:
+    return Value(-inValue.floating);
+  case Type::Int:
+    return Value(-inValue.integer);
+  case Type::Bool:
+    return Value(!inValue.boolean);
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline bool isTrue(const Value &inValue) {
+  return inValue.type == Type::Bool && inValue.boolean;
+}
+
+inline bool whileCondition(const Value &inValue) {
+  if (inValue.type != Type::Bool)
+    fail("Invalid expression type in while!");
+  return inValue.boolean;
+}
+
+inline bool equal(const Value &inLhs, const Value &inRhs) {
+  if (inLhs.type != inRhs.type)
+    return false;
+  switch (inLhs.type) {
+  case Type::Int:
+    return inLhs.integer == inRhs.integer;
+  case Type::Float:
+    return inLhs.floating == inRhs.floating;
+  case Type::Bool:
+    return inLhs.boolean == inRhs.boolean;
+  case Type::String:
+    return inLhs.string == inRhs.string;
+  default:
+    return true;
+  }
+}
+
+inline bool matchesCase(const Value &inSubject, const Value &inCaseValue) {
+  return isTrue(inCaseValue) || equal(inSubject, inCaseValue);
+}
+
+inline Value requireValue(Value inValue) {
+  if (inValue.type == Type::Void)
+    fail("FunctionCallExpression has to return value");
+  return inValue;
+}
+
+inline Value toInt(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::String:
+    return Value(std::stoi(inValue.string));
+  case Type::Float:
+    return Value(static_cast<int>(inValue.floating));
+  case Type::Int:
+    return inValue;
+  case Type::Bool:
+    return Value(static_cast<int>(inValue.boolean));
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline Value toFloat(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::String:
+    return Value(std::stof(inValue.string));
+  case Type::Float:
+    return inValue;
+  case Type::Int:
+    return Value(static_cast<float>(inValue.integer));
+  case Type::Bool:
+    return Value(static_cast<float>(inValue.boolean));
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline Value toString(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::String:
+    return inValue;
+  case Type::Float:
+    return Value(std::to_string(inValue.floating));
+  case Type::Int:
+    return Value(std::to_string(inValue.integer));
+  case Type::Bool:
+    return Value(std::string(inValue.boolean ? "true" : "false"));
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline Value toBool(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::String:
+    if (inValue.string == "true")
+      return Value(true);
+    if (inValue.string == "false")
+      return Value(false);
+    fail("Cannot convert string to bool!");
+  case Type::Float:
+    return Value(inValue.floating > 0.0);
+  case Type::Int:
+    return Value(inValue.integer > 0);
+  case Type::Bool:
+    return inValue;
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline void write(const Value &inValue) {
+  switch (inValue.type) {
+  case Type::String:
+    std::cout << inValue.string;
+    break;
+  case Type::Float:
+    std::cout << inValue.floating;
+    break;
+  case Type::Int:
+    std::cout << inValue.integer;
+    break;
+  case Type::Bool:
+    std::cout << std::to_string(inValue.boolean);
+    break;
+  default:
+    fail("Invalid expression type!");
+  }
+}
+
+inline Value print(const Value &inValue) {
+  write(inValue);
+  return Value();
+}
+
+/* Calls nest natively like in the tree walker, so they are limited by the
+ * same call depth and run on a chain of stack segments, each one a thread
+ * the caller waits for, instead of overflowing a single fixed stack */
+inline std::size_t maxCallDepth = 0;
+inline std::size_t callDepth = 0;
+inline thread_local std::uintptr_t stackBase = 0;
+inline thread_local std::size_t stackSize = 0;
+constexpr std::size_t SegmentSize = std::size_t(16) << 20;
+constexpr std::size_t StackMargin = std::size_t(64) << 10;
+constexpr std::size_t FallbackSize = std::size_t(512) << 10;
+
+inline bool isStackExhausted() {
+  char marker;
+  return stackBase &&
+         stackBase - reinterpret_cast<std::uintptr_t>(&marker) + StackMargin >
+             stackSize;
+}
+
+template <class Body> void runHere(std::size_t inSize, Body &inBody) {
+  char marker;
+  const std::uintptr_t enclosingBase = stackBase;
+  const std::size_t enclosingSize = stackSize;
+  stackBase = reinterpret_cast<std::uintptr_t>(&marker);
+  stackSize = inSize;
+  try {
+    inBody();
+  } catch (...) {
+    stackBase = enclosingBase;
+    stackSize = enclosingSize;
+    throw;
+  }
+  stackBase = enclosingBase;
+  stackSize = enclosingSize;
+}
+
+template <class Body> void onNewSegment(Body inBody) {
+#if TKOM_NATIVE_STACK
+  struct Task {
+    Body *body;
+    std::exception_ptr error;
+  } task{&inBody, nullptr};
+  auto start = [](void *inTask) -> void * {
+    auto *task = static_cast<Task *>(inTask);
+    try {
+      runHere(SegmentSize, *task->body);
+    } catch (...) {
+      task->error = std::current_exception();
+    }
+    return nullptr;
+  };
+  pthread_attr_t attributes;
+  if (pthread_attr_init(&attributes) == 0) {
+    pthread_t thread;
+    bool bIsStarted =
+        pthread_attr_setstacksize(&attributes, SegmentSize) == 0 &&
+        pthread_create(&thread, &attributes, +start, &task) == 0;
+    pthread_attr_destroy(&attributes);
+    if (bIsStarted) {
+      pthread_join(thread, nullptr);
+      if (task.error)
+        std::rethrow_exception(task.error);
+      return;
+    }
+  }
+#endif
+  if (stackBase)
+    fail("Native stack exhausted!");
+  runHere(FallbackSize, inBody);
+}
+
+template <std::size_t N>
+Value call(Value (*inFunction)(std::array<Value, N>),
+           std::array<Value, N> inArguments) {
+  if (callDepth >= maxCallDepth)
+    fail("Maximum call depth of " + std::to_string(maxCallDepth) +
+         " exceeded!");
+  ++callDepth;
+  Value result;
+  try {
+    if (isStackExhausted())
+      onNewSegment([&] { result = inFunction(std::move(inArguments)); });
+    else
+      result = inFunction(std::move(inArguments));
+  } catch (...) {
+    --callDepth;
+    throw;
+  }
+  --callDepth;
+  return result;
+}
+
+/* Nothing returned by a function whose own returned call looped back into
+ * it, which is an error like returning nothing from any returned call */
+inline Value returnNothing(bool bInTailCalled) {
+  return bInTailCalled ? requireValue(Value()) : Value();
+}
+
+/* Runs main and reports its result or error the way the interpreter does */
+template <class Main> int run(std::size_t inMaxCallDepth, Main inMain) {
+  maxCallDepth = inMaxCallDepth;
+  try {
+    Value result;
+    onNewSegment([&] { result = inMain(); });
+    if (result.type != Type::Void)
+      write(result);
+  } catch (const std::runtime_error &error) {
+    std::cout << "Interpreter error: " << error.what() << std::endl;
+    return -1;
+  }
+  return 0;
+}
+
+} // namespace tkom
+)RUNTIME";
@@ -0,0 +1,7 @@
+#pragma once
+
+/* Source of the runtime library prepended to every program translated by
+ * CEmitter. It implements the value semantics of ValueOperations, the frame
+ * and call depth checks of the tree walker and the builtins, so the generated
+ * file builds on its own with any C++17 compiler. */
+extern const char *const CRuntimeSource;
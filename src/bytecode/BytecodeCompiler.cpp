@@ -0,0 +1,423 @@
+#include "BytecodeCompiler.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/BoolFunction.h"
+#include "../instructions/Case.h"
+#include "../instructions/FloatFunction.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/IntFunction.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/PrintFunction.h"
+#include "../instructions/Program.h"
+#include "../instructions/StringFunction.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "../interpreter/InterpreterError.h"
+
+std::unique_ptr<BytecodeProgram>
+BytecodeCompiler::compile(const Program &inProgram) {
+  context.reset();
+  functionIndices.clear();
+  program = std::make_unique<BytecodeProgram>();
+  inProgram.accept(*this);
+  return std::move(program);
+}
+
+Completion BytecodeCompiler::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &functionName = function->getIdentifier();
+    if (context.findFunction(functionName) != nullptr)
+      throw InterpreterError("Redefinition of function with name " +
+                             functionName + "!");
+    context.insertFunction(function.get());
+    functionIndices[function.get()] = program->addFunction(
+        std::make_unique<BytecodeFunction>(functionName));
+  }
+
+  program->setMainIndex(functionIndices.at(inProgram.getMain()));
+  for (const auto &function : inProgram.getFunctions()) {
+    compileFunction(*function);
+  }
+  return Completion::Normal;
+}
+
+void BytecodeCompiler::compileFunction(const Function &inFunction) {
+  currentFunction = program->getFunction(functionIndices.at(&inFunction));
+  slots.clear();
+  matchSlots.clear();
+  nextSlot = 0;
+
+  /* Parameters always occupy the first slots of the frame */
+  for (const auto &argument : inFunction.getArguments()) {
+    slots[argument->getName()] = nextSlot++;
+    currentFunction->addParameter(argument->isMutable());
+  }
+
+  inFunction.getBlock()->accept(*this);
+  currentFunction->emit(OpCode::ReturnVoid);
+  currentFunction->setSlotCount(nextSlot);
+
+  /* Hidden match slots are never reported, they keep the name of '_' */
+  std::vector<std::string> slotNames(nextSlot, "_");
+  for (const auto &[name, slot] : slots) {
+    slotNames[slot] = name;
+  }
+  currentFunction->setSlotNames(std::move(slotNames));
+}
+
+Completion BytecodeCompiler::visit(const BinaryExpression &inBinaryExpression) {
+  inBinaryExpression.getLhs()->accept(*this);
+  size_t shortCircuitJump = 0;
+  if (inBinaryExpression.isLogical())
+    shortCircuitJump = emitJump(inBinaryExpression.getOperator() ==
+                                        Expression::Operator::LogicalOr
+                                    ? OpCode::ShortCircuitOr
+                                    : OpCode::ShortCircuitAnd);
+  inBinaryExpression.getRhs()->accept(*this);
+  switch (inBinaryExpression.getOperator()) {
+  case Expression::Operator::Sum:
+    currentFunction->emit(OpCode::Sum);
+    break;
+  case Expression::Operator::Substraction:
+    currentFunction->emit(OpCode::Substraction);
+    break;
+  case Expression::Operator::Multiplication:
+    currentFunction->emit(OpCode::Multiplication);
+    break;
+  case Expression::Operator::Division:
+    currentFunction->emit(OpCode::Division);
+    break;
+  case Expression::Operator::Modulo:
+    currentFunction->emit(OpCode::Modulo);
+    break;
+  case Expression::Operator::LogicalOr:
+    currentFunction->emit(OpCode::LogicalOr);
+    patchJump(shortCircuitJump);
+    break;
+  case Expression::Operator::LogicalAnd:
+    currentFunction->emit(OpCode::LogicalAnd);
+    patchJump(shortCircuitJump);
+    break;
+  case Expression::Operator::Less:
+    currentFunction->emit(OpCode::Less);
+    break;
+  case Expression::Operator::LessEqual:
+    currentFunction->emit(OpCode::LessEqual);
+    break;
+  case Expression::Operator::More:
+    currentFunction->emit(OpCode::More);
+    break;
+  case Expression::Operator::MoreEqual:
+    currentFunction->emit(OpCode::MoreEqual);
+    break;
+  case Expression::Operator::Equal:
+    currentFunction->emit(OpCode::Equal);
+    break;
+  case Expression::Operator::NotEqual:
+    currentFunction->emit(OpCode::NotEqual);
+    break;
+  default:
+    throw InterpreterError("Invalid binary operator!");
+  }
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const Case &inCase) {
+  return inCase.getBlock()->accept(*this);
+}
+
+Completion BytecodeCompiler::visit(const Function &inFunction) {
+  currentFunction->emit(OpCode::Call, functionIndices.at(&inFunction));
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  compileCall(*static_cast<const InstructionFunctionCall *>(
+      inFunctionCallExpression.getFunctionCall()));
+  currentFunction->emit(OpCode::RequireValue);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const IfElse &inIfElse) {
+  std::vector<size_t> elseJumps;
+  compileBranch(*inIfElse.getExpression(), false, OpCode::JumpIfFalse,
+                elseJumps);
+  inIfElse.getBlockIf()->accept(*this);
+  if (inIfElse.getBlockElse()) {
+    size_t endJump = emitJump(OpCode::Jump);
+    patchJumps(elseJumps);
+    inIfElse.getBlockElse()->accept(*this);
+    patchJump(endJump);
+  } else {
+    patchJumps(elseJumps);
+  }
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const InstructionAssigment &inAssigment) {
+  inAssigment.getExpression()->accept(*this);
+  currentFunction->emit(OpCode::StoreLocal,
+                        resolveSlot(inAssigment.getVariable()->toString()));
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  if (inDeclarationVariable.getExpression())
+    inDeclarationVariable.getExpression()->accept(*this);
+  else
+    emitConstant(RuntimeValue(0));
+
+  currentFunction->emit(inDeclarationVariable.isMutable()
+                            ? OpCode::DeclareMutableLocal
+                            : OpCode::DeclareLocal,
+                        resolveSlot(inDeclarationVariable.getIdentifier()));
+  return Completion::Normal;
+}
+
+Completion
+BytecodeCompiler::visit(const InstructionFunctionCall &inFunctionCall) {
+  compileCall(inFunctionCall);
+  currentFunction->emit(OpCode::Pop);
+  return Completion::Normal;
+}
+
+void BytecodeCompiler::compileCall(
+    const InstructionFunctionCall &inFunctionCall) {
+  const std::string &name = inFunctionCall.getFunctionName();
+  auto function = context.findFunction(name);
+  if (function == nullptr) {
+    emitThrow("No function found with such name: " + name + "!");
+    return;
+  }
+  if (function->getArguments().size() !=
+      inFunctionCall.getExpressions().size()) {
+    emitThrow("Invalid number of arguments for function " + name + "!");
+    return;
+  }
+
+  for (const auto &argument : inFunctionCall.getExpressions()) {
+    argument->accept(*this);
+  }
+  function->accept(*this);
+}
+
+Completion BytecodeCompiler::visit(const IntFunction &inIntFunction) {
+  currentFunction->emit(OpCode::ToInt);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const StringFunction &inStringFunction) {
+  currentFunction->emit(OpCode::ToString);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const FloatFunction &inFloatFunction) {
+  currentFunction->emit(OpCode::ToFloat);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const BoolFunction &inBoolFunction) {
+  currentFunction->emit(OpCode::ToBool);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const PrintFunction &inPrintFunction) {
+  currentFunction->emit(OpCode::Print);
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const InstructionReturn &inReturn) {
+  /* A returned call to a function of the program reuses the frame of the
+   * caller, which checks the result once the callee returns */
+  if (auto *callExpression = dynamic_cast<const FunctionCallExpression *>(
+          inReturn.getExpression())) {
+    compileCall(*static_cast<const InstructionFunctionCall *>(
+        callExpression->getFunctionCall()));
+    std::vector<uint32_t> &code = currentFunction->getCode();
+    if (decodeOpCode(code.back()) == OpCode::Call) {
+      code.back() = encodeInstruction(OpCode::TailCall,
+                                      decodeOperand(code.back()));
+      return Completion::Normal;
+    }
+    currentFunction->emit(OpCode::RequireValue);
+    currentFunction->emit(OpCode::Return);
+  } else if (inReturn.getExpression()) {
+    inReturn.getExpression()->accept(*this);
+    currentFunction->emit(OpCode::Return);
+  } else {
+    currentFunction->emit(OpCode::ReturnVoid);
+  }
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const Match &inMatch) {
+  inMatch.getExpression()->accept(*this);
+
+  /* The subject lives in a hidden slot that '_' resolves to */
+  uint32_t subjectSlot = resolveSlot("#match" + std::to_string(nextSlot));
+  currentFunction->emit(OpCode::SetLocal, subjectSlot);
+  matchSlots.push_back(subjectSlot);
+
+  /* Literal cases jump straight to the block of the case taken */
+  if (const MatchDispatch *dispatch = inMatch.getDispatch()) {
+    uint32_t table = currentFunction->addSwitch(*dispatch);
+    currentFunction->emit(OpCode::LoadLocal, subjectSlot);
+    currentFunction->emit(OpCode::Switch, table);
+    std::vector<size_t> endJumps;
+    for (const auto &caseInstruction : inMatch.getCases()) {
+      currentFunction->getSwitch(table).targets.push_back(
+          static_cast<uint32_t>(currentFunction->getCode().size()));
+      caseInstruction->accept(*this);
+      endJumps.push_back(emitJump(OpCode::Jump));
+    }
+    for (size_t endJump : endJumps) {
+      patchJump(endJump);
+    }
+    currentFunction->getSwitch(table).targets.push_back(
+        static_cast<uint32_t>(currentFunction->getCode().size()));
+    matchSlots.pop_back();
+    return Completion::Normal;
+  }
+
+  std::vector<size_t> endJumps;
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    caseInstruction->getExpression()->accept(*this);
+    currentFunction->emit(OpCode::MatchCase, subjectSlot);
+    size_t nextCaseJump = emitJump(OpCode::JumpIfFalse);
+    caseInstruction->accept(*this);
+    endJumps.push_back(emitJump(OpCode::Jump));
+    patchJump(nextCaseJump);
+  }
+  for (size_t endJump : endJumps) {
+    patchJump(endJump);
+  }
+
+  matchSlots.pop_back();
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const UnaryExpression &inUnaryExpression) {
+  inUnaryExpression.getExpression()->accept(*this);
+  currentFunction->emit(OpCode::Negation);
+  return Completion::Normal;
+}
+
+Completion
+BytecodeCompiler::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  if (const auto &value = variable->getValue()) {
+    emitConstant(value->getRuntimeValue());
+    return Completion::Normal;
+  }
+
+  const std::string &name = *variable->getName();
+  if (name == "_" && !matchSlots.empty()) {
+    currentFunction->emit(OpCode::LoadLocal, matchSlots.back());
+    return Completion::Normal;
+  }
+
+  currentFunction->emit(OpCode::LoadLocal, resolveSlot(name));
+  return Completion::Normal;
+}
+
+Completion BytecodeCompiler::visit(const While &inWhile) {
+  size_t loopStart = currentFunction->getCode().size();
+  std::vector<size_t> exitJumps;
+  compileBranch(*inWhile.getExpression(), false, OpCode::JumpIfLoopFalse,
+                exitJumps);
+  inWhile.getBody()->accept(*this);
+  currentFunction->emit(OpCode::Jump, static_cast<uint32_t>(loopStart));
+  patchJumps(exitJumps);
+  return Completion::Normal;
+}
+
+void BytecodeCompiler::compileBranch(const Expression &inCondition,
+                                     bool bJumpIf, OpCode inJumpIfFalse,
+                                     std::vector<size_t> &outJumps) {
+  /* || and && over bools become jumps on their operands. The left operand of
+   * || jumps when true and the one of && when false, to the target when that
+   * is the outcome wanted and past the right operand otherwise */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isBoolLogical()) {
+    const bool bIsOr =
+        binaryExpression->getOperator() == Expression::Operator::LogicalOr;
+    std::vector<size_t> skipJumps;
+    compileBranch(*binaryExpression->getLhs(), bIsOr, inJumpIfFalse,
+                  bIsOr == bJumpIf ? outJumps : skipJumps);
+    compileBranch(*binaryExpression->getRhs(), bJumpIf, inJumpIfFalse,
+                  outJumps);
+    patchJumps(skipJumps);
+    return;
+  }
+
+  /* Comparisons always yield a bool, so they branch without one */
+  if (binaryExpression && binaryExpression->isComparison()) {
+    binaryExpression->getLhs()->accept(*this);
+    binaryExpression->getRhs()->accept(*this);
+    currentFunction->emit(
+        static_cast<OpCode>(static_cast<int>(OpCode::TestLess) +
+                            static_cast<int>(binaryExpression->getOperator()) -
+                            static_cast<int>(Expression::Operator::Less)),
+        bJumpIf ? 1 : 0);
+    outJumps.push_back(emitJump(OpCode::Jump));
+    return;
+  }
+
+  inCondition.accept(*this);
+  outJumps.push_back(emitJump(bJumpIf ? OpCode::JumpIfTrue : inJumpIfFalse));
+}
+
+uint32_t BytecodeCompiler::resolveSlot(const std::string &inName) {
+  auto it = slots.find(inName);
+  if (it != slots.end())
+    return it->second;
+
+  slots[inName] = nextSlot;
+  return nextSlot++;
+}
+
+void BytecodeCompiler::emitThrow(const std::string &inMessage) {
+  currentFunction->emit(
+      OpCode::Throw,
+      currentFunction->addConstant(
+          RuntimeValue(inMessage)));
+}
+
+void BytecodeCompiler::emitConstant(const RuntimeValue &inValue) {
+  currentFunction->emit(OpCode::Constant,
+                        currentFunction->addConstant(inValue));
+}
+
+size_t BytecodeCompiler::emitJump(OpCode inOpCode) {
+  return currentFunction->emit(inOpCode);
+}
+
+void BytecodeCompiler::patchJump(size_t inPosition) {
+  currentFunction->patch(
+      inPosition, static_cast<uint32_t>(currentFunction->getCode().size()));
+}
+
+void BytecodeCompiler::patchJumps(const std::vector<size_t> &inPositions) {
+  for (size_t position : inPositions) {
+    patchJump(position);
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "../interpreter/VisitorInterpreter.h"
+#include "BytecodeProgram.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Lowers the parsed AST into linear stack bytecode. Statements leave the
+ * operand stack balanced, expressions push exactly one value. Visiting a
+ * Function emits a call to it, function bodies are compiled by compile(). */
+class BytecodeCompiler : public VisitorInterpreter {
+public:
+  BytecodeCompiler() = default;
+  std::unique_ptr<BytecodeProgram> compile(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  void compileFunction(const class Function &inFunction);
+  void compileCall(const class InstructionFunctionCall &inFunctionCall);
+  uint32_t resolveSlot(const std::string &inName);
+  void emitThrow(const std::string &inMessage);
+  void emitConstant(const RuntimeValue &inValue);
+  /* Emits the jumps to outJumps taken when inCondition is bJumpIf, a false
+   * condition is tested by inJumpIfFalse */
+  void compileBranch(const class Expression &inCondition, bool bJumpIf,
+                     OpCode inJumpIfFalse, std::vector<size_t> &outJumps);
+  size_t emitJump(OpCode inOpCode);
+  void patchJump(size_t inPosition);
+  void patchJumps(const std::vector<size_t> &inPositions);
+
+  Context context;
+  std::unique_ptr<BytecodeProgram> program;
+  std::unordered_map<const class Function *, uint32_t> functionIndices;
+  BytecodeFunction *currentFunction = nullptr;
+  std::unordered_map<std::string, uint32_t> slots;
+  std::vector<uint32_t> matchSlots;
+  uint32_t nextSlot = 0;
+};
@@ -0,0 +1,107 @@
+#include "BytecodeFunction.h"
+#include "../interpreter/InterpreterError.h"
+#include <cmath>
+
+static const char *opCodeNames[] = {
+    "Constant", "LoadLocal", "StoreLocal", "DeclareLocal",
+    "DeclareMutableLocal", "SetLocal", "Pop", "Sum", "Substraction",
+    "Multiplication", "Division", "Modulo", "LogicalOr", "LogicalAnd", "Less",
+    "LessEqual", "More", "MoreEqual", "Equal", "NotEqual", "Negation", "Jump",
+    "JumpIfFalse", "JumpIfLoopFalse", "JumpIfTrue", "ShortCircuitOr",
+    "ShortCircuitAnd", "TestLess", "TestLessEqual", "TestMore",
+    "TestMoreEqual", "TestEqual", "TestNotEqual", "MatchCase", "Switch", "Call", "TailCall", "Return", "ReturnVoid",
+    "RequireValue", "ToInt", "ToFloat", "ToString", "ToBool", "Print",
+    "Throw", "SumInt", "SubstractionInt", "MultiplicationInt",
+    "DivisionInt", "ModuloInt", "LogicalOrInt", "LogicalAndInt", "LessInt",
+    "LessEqualInt", "MoreInt", "MoreEqualInt", "EqualInt", "NotEqualInt",
+    "SumFloat", "SubstractionFloat", "MultiplicationFloat", "DivisionFloat",
+    "ModuloFloat", "LogicalOrFloat", "LogicalAndFloat", "LessFloat",
+    "LessEqualFloat", "MoreFloat", "MoreEqualFloat", "EqualFloat",
+    "NotEqualFloat",
+};
+
+BytecodeFunction::BytecodeFunction(const std::string &inName) : name(inName) {}
+
+size_t BytecodeFunction::emit(OpCode inOpCode, uint32_t inOperand) {
+  if (inOperand > MaxOperand)
+    throw InterpreterError("Bytecode operand out of range in function " +
+                           name + "!");
+  code.push_back(encodeInstruction(inOpCode, inOperand));
+  return code.size() - 1;
+}
+
+void BytecodeFunction::patch(size_t inPosition, uint32_t inOperand) {
+  code[inPosition] = encodeInstruction(decodeOpCode(code[inPosition]), inOperand);
+}
+
+uint32_t BytecodeFunction::addConstant(const RuntimeValue &inConstant) {
+  for (size_t i = 0; i < constants.size(); ++i) {
+    if (constants[i] == inConstant &&
+        (inConstant.getType() != RuntimeValue::Type::Float ||
+         std::signbit(constants[i].getFloat()) ==
+             std::signbit(inConstant.getFloat())))
+      return static_cast<uint32_t>(i);
+  }
+  constants.push_back(inConstant);
+  return static_cast<uint32_t>(constants.size() - 1);
+}
+
+uint32_t BytecodeFunction::addSwitch(const MatchDispatch &inDispatch) {
+  switches.push_back(SwitchTable{inDispatch, {}});
+  return static_cast<uint32_t>(switches.size() - 1);
+}
+
+SwitchTable &BytecodeFunction::getSwitch(uint32_t inIndex) {
+  return switches[inIndex];
+}
+
+void BytecodeFunction::addParameter(bool bInIsMutable) {
+  parameters.push_back(bInIsMutable);
+}
+
+void BytecodeFunction::setSlotCount(size_t inSlotCount) {
+  slotCount = inSlotCount;
+}
+
+const std::string &BytecodeFunction::getName() const { return name; }
+
+const std::vector<uint32_t> &BytecodeFunction::getCode() const { return code; }
+
+std::vector<uint32_t> &BytecodeFunction::getCode() { return code; }
+
+const std::vector<RuntimeValue> &BytecodeFunction::getConstants() const {
+  return constants;
+}
+
+const std::vector<SwitchTable> &BytecodeFunction::getSwitches() const {
+  return switches;
+}
+
+const std::vector<bool> &BytecodeFunction::getParameters() const {
+  return parameters;
+}
+
+size_t BytecodeFunction::getSlotCount() const { return slotCount; }
+
+void BytecodeFunction::setSlotNames(std::vector<std::string> inSlotNames) {
+  slotNames = std::move(inSlotNames);
+}
+
+const std::string &BytecodeFunction::getSlotName(size_t inSlot) const {
+  return slotNames[inSlot];
+}
+
+std::string BytecodeFunction::toString() const {
+  std::string result = "fn " + name + " (slots: " + std::to_string(slotCount) +
+                       ")\n";
+  for (size_t i = 0; i < code.size(); ++i) {
+    result += "  " + std::to_string(i) + ": " +
+              opCodeNames[static_cast<size_t>(decodeOpCode(code[i]))] + " " +
+              std::to_string(decodeOperand(code[i]));
+    if (decodeOpCode(code[i]) == OpCode::Switch)
+      result += " (" + switches[decodeOperand(code[i])].dispatch.toString() +
+                ")";
+    result += "\n";
+  }
+  return result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "OpCode.h"
+#include "SwitchTable.h"
+#include "../interpreter/Context.h"
+#include <string>
+#include <vector>
+
+class BytecodeFunction {
+public:
+  explicit BytecodeFunction(const std::string &inName);
+  size_t emit(OpCode inOpCode, uint32_t inOperand = 0);
+  void patch(size_t inPosition, uint32_t inOperand);
+  uint32_t addConstant(const RuntimeValue &inConstant);
+  uint32_t addSwitch(const MatchDispatch &inDispatch);
+  SwitchTable &getSwitch(uint32_t inIndex);
+  void addParameter(bool bInIsMutable);
+  void setSlotCount(size_t inSlotCount);
+  /* Variable name of every slot, for runtime error messages */
+  void setSlotNames(std::vector<std::string> inSlotNames);
+
+  const std::string &getName() const;
+  const std::vector<uint32_t> &getCode() const;
+  /* Rewritten in place by the interpreter when it quickens instructions */
+  std::vector<uint32_t> &getCode();
+  const std::vector<RuntimeValue> &getConstants() const;
+  const std::vector<SwitchTable> &getSwitches() const;
+  const std::vector<bool> &getParameters() const;
+  size_t getSlotCount() const;
+  const std::string &getSlotName(size_t inSlot) const;
+  std::string toString() const;
+
+private:
+  std::string name;
+  std::vector<uint32_t> code;
+  std::vector<RuntimeValue> constants;
+  std::vector<SwitchTable> switches;
+  std::vector<bool> parameters;
+  std::vector<std::string> slotNames;
+  size_t slotCount = 0;
+};
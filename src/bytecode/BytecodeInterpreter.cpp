@@ -0,0 +1,443 @@
+#include "BytecodeInterpreter.h"
+#include "../lexer/Lexer.h"
+#include "../instructions/Program.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/Resolver.h"
+#include "../interpreter/TypeInference.h"
+#include "../interpreter/ValueOperations.h"
+#include "../parser/Parser.h"
+#include "BytecodeCompiler.h"
+#include "Dispatch.h"
+#include <cmath>
+
+BytecodeInterpreter::BytecodeInterpreter(std::unique_ptr<Parser> inParser)
+    : parser(std::move(inParser)) {}
+
+std::optional<ValueType> BytecodeInterpreter::execute() {
+  if (!program) {
+    Program *parsedProgram = parser->parseProgram();
+    /* Statically guaranteed type errors are reported before anything runs */
+    Resolver resolver;
+    resolver.resolve(*parsedProgram);
+    TypeInference typeInference;
+    typeInference.infer(*parsedProgram);
+    BytecodeCompiler compiler;
+    program = compiler.compile(*parsedProgram);
+  }
+  auto result = run(*program->getFunction(program->getMainIndex()));
+  if (!result)
+    return std::nullopt;
+  return result->toValueType();
+}
+
+size_t BytecodeInterpreter::getExecutedInstructionCount() const {
+  return executedInstructions;
+}
+
+size_t BytecodeInterpreter::getQuickenedInstructionCount() const {
+  return quickenedInstructions;
+}
+
+size_t BytecodeInterpreter::getDeoptimizedInstructionCount() const {
+  return deoptimizedInstructions;
+}
+
+const BytecodeProgram *BytecodeInterpreter::getProgram() const {
+  return program.get();
+}
+
+void BytecodeInterpreter::pushFrame(BytecodeFunction &inFunction) {
+  size_t argumentCount = inFunction.getParameters().size();
+  size_t slotBase = locals.size();
+  locals.resize(slotBase + inFunction.getSlotCount());
+  localStates.resize(slotBase + inFunction.getSlotCount(), Undeclared);
+
+  /* Arguments were pushed left to right by the caller */
+  size_t argumentBase = stack.size() - argumentCount;
+  for (size_t i = 0; i < argumentCount; ++i) {
+    locals[slotBase + i] = std::move(stack[argumentBase + i]);
+    localStates[slotBase + i] =
+        Declared | (inFunction.getParameters()[i] ? Mutable : 0);
+  }
+  stack.resize(argumentBase);
+  frames.push_back(CallFrame{&inFunction, 0, slotBase, false});
+}
+
+/* FETCH loads the next instruction, DISPATCH jumps to its handler and NEXT
+ * finishes a handler. */
+#define FETCH()                                                                \
+  ++executedInstructions;                                                      \
+  instruction = code[ip++];                                                    \
+  operand = decodeOperand(instruction)
+#if TKOM_COMPUTED_GOTO
+#define DISPATCH()                                                             \
+  goto *dispatchTable[static_cast<size_t>(decodeOpCode(instruction))];
+#define HANDLER(name) handle##name:
+#define NEXT()                                                                 \
+  do {                                                                         \
+    FETCH();                                                                   \
+    DISPATCH()                                                                 \
+  } while (0)
+#else
+#define DISPATCH() switch (decodeOpCode(instruction))
+#define HANDLER(name) case OpCode::name:
+#define NEXT() break
+#endif
+
+/* Quickened handlers compute in place when both operands have the type of
+ * the opcode and the guard holds, anything else deoptimizes the site */
+#define QUICKENED_HANDLER(name, type, guard, value)                            \
+  HANDLER(name)                                                                \
+  if (stack[stack.size() - 2].getType() == RuntimeValue::Type::type &&         \
+      stack.back().getType() == RuntimeValue::Type::type) {                    \
+    auto lhs = stack[stack.size() - 2].get##type();                            \
+    auto rhs = stack.back().get##type();                                       \
+    if (guard) {                                                               \
+      stack[stack.size() - 2] = RuntimeValue(value);                           \
+      stack.pop_back();                                                        \
+      NEXT();                                                                  \
+    }                                                                          \
+  }                                                                            \
+  goto deoptimize;
+/* Fused compare and branch, ints and floats are compared in place */
+#define TEST_HANDLER(name, op)                                                 \
+  HANDLER(Test##name) {                                                        \
+    const RuntimeValue &lhs = stack[stack.size() - 2];                         \
+    const RuntimeValue &rhs = stack.back();                                    \
+    bool bOutcome;                                                             \
+    if (lhs.getType() == RuntimeValue::Type::Int &&                            \
+        rhs.getType() == RuntimeValue::Type::Int)                              \
+      bOutcome = lhs.getInt() op rhs.getInt();                                 \
+    else if (lhs.getType() == RuntimeValue::Type::Float &&                     \
+             rhs.getType() == RuntimeValue::Type::Float)                       \
+      bOutcome = lhs.getFloat() op rhs.getFloat();                             \
+    else                                                                       \
+      bOutcome = ValueOperations::compare(Expression::Operator::name, lhs,     \
+                                          rhs);                                \
+    stack.resize(stack.size() - 2);                                            \
+    ip = bOutcome == (operand != 0) ? decodeOperand(code[ip]) : ip + 1;        \
+    NEXT();                                                                    \
+  }
+#define QUICKENED_HANDLERS(type)                                               \
+  QUICKENED_HANDLER(Sum##type, type, true, lhs + rhs)                          \
+  QUICKENED_HANDLER(Substraction##type, type, true, lhs - rhs)                 \
+  QUICKENED_HANDLER(Multiplication##type, type, true, lhs * rhs)               \
+  QUICKENED_HANDLER(Division##type, type, canDivide(lhs, rhs), lhs / rhs)      \
+  QUICKENED_HANDLER(Modulo##type, type, canDivide(lhs, rhs), modulo(lhs, rhs)) \
+  QUICKENED_HANDLER(LogicalOr##type, type, true, lhs || rhs)                   \
+  QUICKENED_HANDLER(LogicalAnd##type, type, true, lhs && rhs)                  \
+  QUICKENED_HANDLER(Less##type, type, true, lhs < rhs)                         \
+  QUICKENED_HANDLER(LessEqual##type, type, true, lhs <= rhs)                   \
+  QUICKENED_HANDLER(More##type, type, true, lhs > rhs)                         \
+  QUICKENED_HANDLER(MoreEqual##type, type, true, lhs >= rhs)                   \
+  QUICKENED_HANDLER(Equal##type, type, true, lhs == rhs)                       \
+  QUICKENED_HANDLER(NotEqual##type, type, true, lhs != rhs)
+
+/* Division by zero and overflow are left to ValueOperations for its errors */
+template <class T> static bool canDivide(T inLhs, T inRhs) {
+  return inRhs != 0 && !ValueOperations::overflowsDivision(inLhs, inRhs);
+}
+
+static int modulo(int inLhs, int inRhs) { return inLhs % inRhs; }
+
+static float modulo(float inLhs, float inRhs) {
+  return std::fmod(inLhs, inRhs);
+}
+
+std::optional<RuntimeValue>
+BytecodeInterpreter::run(BytecodeFunction &inMain) {
+  stack.clear();
+  locals.clear();
+  localStates.clear();
+  frames.clear();
+  executedInstructions = 0;
+  /* Parameters of main default to 0 */
+  stack.resize(inMain.getParameters().size(), RuntimeValue(0));
+  pushFrame(inMain);
+
+  BytecodeFunction *function = &inMain;
+  uint32_t *code = function->getCode().data();
+  const RuntimeValue *constants = function->getConstants().data();
+  size_t ip = 0;
+  size_t slotBase = 0;
+  const RuntimeValue voidValue;
+
+#if TKOM_COMPUTED_GOTO
+  /* Handler addresses in OpCode order */
+  static void *const dispatchTable[] = {
+      &&handleConstant, &&handleLoadLocal, &&handleStoreLocal,
+      &&handleDeclareLocal, &&handleDeclareMutableLocal, &&handleSetLocal,
+      &&handlePop, &&handleSum, &&handleSubstraction, &&handleMultiplication,
+      &&handleDivision, &&handleModulo, &&handleLogicalOr, &&handleLogicalAnd,
+      &&handleLess, &&handleLessEqual, &&handleMore, &&handleMoreEqual,
+      &&handleEqual, &&handleNotEqual, &&handleNegation, &&handleJump,
+      &&handleJumpIfFalse, &&handleJumpIfLoopFalse, &&handleJumpIfTrue,
+      &&handleShortCircuitOr, &&handleShortCircuitAnd, &&handleTestLess,
+      &&handleTestLessEqual, &&handleTestMore, &&handleTestMoreEqual,
+      &&handleTestEqual, &&handleTestNotEqual, &&handleMatchCase,
+      &&handleSwitch, &&handleCall, &&handleTailCall, &&handleReturn, &&handleReturnVoid,
+      &&handleRequireValue, &&handleToInt, &&handleToFloat, &&handleToString, &&handleToBool,
+      &&handlePrint, &&handleThrow, &&handleSumInt, &&handleSubstractionInt,
+      &&handleMultiplicationInt, &&handleDivisionInt, &&handleModuloInt,
+      &&handleLogicalOrInt, &&handleLogicalAndInt, &&handleLessInt,
+      &&handleLessEqualInt, &&handleMoreInt, &&handleMoreEqualInt,
+      &&handleEqualInt, &&handleNotEqualInt, &&handleSumFloat,
+      &&handleSubstractionFloat, &&handleMultiplicationFloat,
+      &&handleDivisionFloat, &&handleModuloFloat, &&handleLogicalOrFloat,
+      &&handleLogicalAndFloat, &&handleLessFloat, &&handleLessEqualFloat,
+      &&handleMoreFloat, &&handleMoreEqualFloat, &&handleEqualFloat,
+      &&handleNotEqualFloat};
+  static_assert(sizeof(dispatchTable) / sizeof(*dispatchTable) ==
+                static_cast<size_t>(OpCode::NotEqualFloat) + 1);
+#endif
+
+  uint32_t instruction;
+  uint32_t operand;
+  for (;;) {
+    FETCH();
+    DISPATCH() {
+    HANDLER(Constant)
+      stack.push_back(constants[operand]);
+      NEXT();
+    HANDLER(LoadLocal)
+      if (localStates[slotBase + operand] == Undeclared)
+        throw InterpreterError("No variable with such name " +
+                               function->getSlotName(operand) + "!");
+      stack.push_back(locals[slotBase + operand]);
+      NEXT();
+    HANDLER(StoreLocal)
+      if (localStates[slotBase + operand] == Undeclared)
+        throw InterpreterError("Variable " + function->getSlotName(operand) +
+                               " is not declared!");
+      if (!(localStates[slotBase + operand] & Mutable))
+        throw InterpreterError("Not mutable variable " +
+                               function->getSlotName(operand) +
+                               " cannot be modified!");
+      locals[slotBase + operand] = std::move(stack.back());
+      stack.pop_back();
+      NEXT();
+    HANDLER(DeclareLocal)
+    HANDLER(DeclareMutableLocal)
+      if (localStates[slotBase + operand] != Undeclared)
+        throw InterpreterError("New declaration of local variable named " +
+                               function->getSlotName(operand) + " found!");
+      locals[slotBase + operand] = std::move(stack.back());
+      localStates[slotBase + operand] =
+          decodeOpCode(instruction) == OpCode::DeclareMutableLocal
+              ? Declared | Mutable
+              : Declared;
+      stack.pop_back();
+      NEXT();
+    HANDLER(SetLocal)
+      locals[slotBase + operand] = std::move(stack.back());
+      localStates[slotBase + operand] = Declared;
+      stack.pop_back();
+      NEXT();
+    HANDLER(Pop)
+      stack.pop_back();
+      NEXT();
+    HANDLER(Sum)
+    HANDLER(Substraction)
+    HANDLER(Multiplication)
+    HANDLER(Division)
+    HANDLER(Modulo)
+    HANDLER(LogicalOr)
+    HANDLER(LogicalAnd)
+    HANDLER(Less)
+    HANDLER(LessEqual)
+    HANDLER(More)
+    HANDLER(MoreEqual)
+    HANDLER(Equal)
+    HANDLER(NotEqual) {
+      /* Binary opcodes are laid out in Expression::Operator order */
+      auto op = static_cast<Expression::Operator>(
+          static_cast<int>(decodeOpCode(instruction)) -
+          static_cast<int>(OpCode::Sum));
+      RuntimeValue &lhs = stack[stack.size() - 2];
+      if (operand != Unquickenable)
+        profileBinary(code[ip - 1], lhs, stack.back());
+      lhs = ValueOperations::binaryOperation(op, lhs, stack.back());
+      stack.pop_back();
+      NEXT();
+    }
+    QUICKENED_HANDLERS(Int)
+    QUICKENED_HANDLERS(Float)
+    deoptimize: {
+      /* The site goes back to the generic opcode for good */
+      auto op = static_cast<Expression::Operator>(
+          (static_cast<int>(decodeOpCode(instruction)) -
+           static_cast<int>(OpCode::SumInt)) %
+          (static_cast<int>(OpCode::SumFloat) -
+           static_cast<int>(OpCode::SumInt)));
+      code[ip - 1] = encodeInstruction(
+          static_cast<OpCode>(static_cast<int>(OpCode::Sum) +
+                              static_cast<int>(op)),
+          Unquickenable);
+      ++deoptimizedInstructions;
+      RuntimeValue &lhs = stack[stack.size() - 2];
+      lhs = ValueOperations::binaryOperation(op, lhs, stack.back());
+      stack.pop_back();
+      NEXT();
+    }
+    HANDLER(Negation)
+      stack.back() = ValueOperations::unaryOperation(stack.back());
+      NEXT();
+    HANDLER(Jump)
+      ip = operand;
+      NEXT();
+    HANDLER(JumpIfFalse)
+      if (!ValueOperations::isTrue(stack.back()))
+        ip = operand;
+      stack.pop_back();
+      NEXT();
+    HANDLER(JumpIfLoopFalse)
+      if (stack.back().getType() != RuntimeValue::Type::Bool)
+        throw InterpreterError("Invalid expression type in while!");
+      if (!stack.back().getBool())
+        ip = operand;
+      stack.pop_back();
+      NEXT();
+    HANDLER(JumpIfTrue)
+      if (ValueOperations::isTrue(stack.back()))
+        ip = operand;
+      stack.pop_back();
+      NEXT();
+    HANDLER(ShortCircuitOr)
+    HANDLER(ShortCircuitAnd) {
+      const bool bIsOr = decodeOpCode(instruction) == OpCode::ShortCircuitOr;
+      if (ValueOperations::shortCircuits(
+              bIsOr ? Expression::Operator::LogicalOr
+                    : Expression::Operator::LogicalAnd,
+              stack.back())) {
+        stack.back() = RuntimeValue(bIsOr);
+        ip = operand;
+      }
+      NEXT();
+    }
+    TEST_HANDLER(Less, <)
+    TEST_HANDLER(LessEqual, <=)
+    TEST_HANDLER(More, >)
+    TEST_HANDLER(MoreEqual, >=)
+    TEST_HANDLER(Equal, ==)
+    TEST_HANDLER(NotEqual, !=)
+    HANDLER(MatchCase)
+      stack.back() = RuntimeValue(
+          ValueOperations::matchesCase(locals[slotBase + operand], stack.back()));
+      NEXT();
+    HANDLER(Switch)
+      ip = function->getSwitches()[operand].getTarget(stack.back());
+      stack.pop_back();
+      NEXT();
+    HANDLER(Call) {
+      checkCallDepth(frames.size(), maxCallDepth);
+      frames.back().ip = ip;
+      function = program->getFunction(operand);
+      pushFrame(*function);
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      ip = 0;
+      slotBase = frames.back().slotBase;
+      NEXT();
+    }
+    HANDLER(TailCall) {
+      /* The callee takes over the frame, so the depth does not grow */
+      locals.resize(slotBase);
+      localStates.resize(slotBase);
+      frames.pop_back();
+      function = program->getFunction(operand);
+      pushFrame(*function);
+      frames.back().bRequiresValue = true;
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      ip = 0;
+      slotBase = frames.back().slotBase;
+      NEXT();
+    }
+    HANDLER(Return)
+    HANDLER(ReturnVoid) {
+      RuntimeValue result;
+      if (decodeOpCode(instruction) == OpCode::Return) {
+        result = std::move(stack.back());
+        stack.pop_back();
+      }
+      if (frames.back().bRequiresValue &&
+          result.getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("FunctionCallExpression has to return value");
+      locals.resize(slotBase);
+      localStates.resize(slotBase);
+      frames.pop_back();
+      if (frames.empty()) {
+        if (result.getType() == RuntimeValue::Type::Void)
+          return std::nullopt;
+        return result;
+      }
+      const CallFrame &caller = frames.back();
+      function = caller.function;
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      ip = caller.ip;
+      slotBase = caller.slotBase;
+      stack.push_back(std::move(result));
+      NEXT();
+    }
+    HANDLER(RequireValue)
+      if (stack.back().getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("FunctionCallExpression has to return value");
+      NEXT();
+    HANDLER(ToInt)
+      stack.back() = ValueOperations::toInt(stack.back());
+      NEXT();
+    HANDLER(ToFloat)
+      stack.back() = ValueOperations::toFloat(stack.back());
+      NEXT();
+    HANDLER(ToString)
+      stack.back() = ValueOperations::toString(stack.back());
+      NEXT();
+    HANDLER(ToBool)
+      stack.back() = ValueOperations::toBool(stack.back());
+      NEXT();
+    HANDLER(Print)
+      ValueOperations::print(stack.back());
+      stack.back() = voidValue;
+      NEXT();
+    HANDLER(Throw)
+      throw InterpreterError(constants[operand].getString());
+    }
+  }
+}
+
+#undef FETCH
+#undef DISPATCH
+#undef HANDLER
+#undef NEXT
+#undef TEST_HANDLER
+#undef QUICKENED_HANDLER
+#undef QUICKENED_HANDLERS
+
+void BytecodeInterpreter::profileBinary(uint32_t &inInstruction,
+                                        const RuntimeValue &inLhs,
+                                        const RuntimeValue &inRhs) {
+  /* The operand of a generic binary site counts consecutive executions in
+   * its upper bits and remembers whether they saw floats in the lowest */
+  OpCode opCode = decodeOpCode(inInstruction);
+  uint32_t profile = decodeOperand(inInstruction);
+  if (inLhs.getType() != inRhs.getType() ||
+      (inLhs.getType() != RuntimeValue::Type::Int &&
+       inLhs.getType() != RuntimeValue::Type::Float)) {
+    inInstruction = encodeInstruction(opCode);
+    return;
+  }
+
+  uint32_t bIsFloat = inLhs.getType() == RuntimeValue::Type::Float ? 1 : 0;
+  uint32_t count = (profile & 1) == bIsFloat ? (profile >> 1) + 1 : 1;
+  if (count < QuickeningThreshold) {
+    inInstruction = encodeInstruction(opCode, (count << 1) | bIsFloat);
+    return;
+  }
+
+  OpCode quickened = bIsFloat ? OpCode::SumFloat : OpCode::SumInt;
+  inInstruction = encodeInstruction(static_cast<OpCode>(
+      static_cast<int>(quickened) + static_cast<int>(opCode) -
+      static_cast<int>(OpCode::Sum)));
+  ++quickenedInstructions;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "../interpreter/Interpreter.h"
+#include "BytecodeProgram.h"
+#include <memory>
+#include <vector>
+
+/* Stack machine executing the output of BytecodeCompiler */
+class BytecodeInterpreter : public Interpreter {
+public:
+  explicit BytecodeInterpreter(std::unique_ptr<class Parser> inParser);
+  virtual std::optional<ValueType> execute() override;
+  virtual size_t getExecutedInstructionCount() const override;
+  /* Binary sites rewritten to a type specialised opcode, and the ones of
+   * them sent back to the generic opcode by a failed guard */
+  size_t getQuickenedInstructionCount() const;
+  size_t getDeoptimizedInstructionCount() const;
+  const BytecodeProgram *getProgram() const;
+
+private:
+  enum LocalState : uint8_t {
+    Undeclared = 0,
+    Declared = 1,
+    Mutable = 2,
+  };
+
+  struct CallFrame {
+    BytecodeFunction *function;
+    size_t ip;
+    size_t slotBase;
+    /* Entered by a returned call, so its result has to be a value */
+    bool bRequiresValue;
+  };
+
+  std::optional<RuntimeValue> run(BytecodeFunction &inMain);
+  void pushFrame(BytecodeFunction &inFunction);
+  /* Counts executions of a generic binary site and quickens it once they
+   * keep seeing the same numeric type */
+  void profileBinary(uint32_t &inInstruction, const RuntimeValue &inLhs,
+                     const RuntimeValue &inRhs);
+
+  std::unique_ptr<Parser> parser;
+  std::unique_ptr<BytecodeProgram> program;
+  std::vector<RuntimeValue> stack;
+  std::vector<RuntimeValue> locals;
+  std::vector<uint8_t> localStates;
+  std::vector<CallFrame> frames;
+  size_t executedInstructions = 0;
+  size_t quickenedInstructions = 0;
+  size_t deoptimizedInstructions = 0;
+};
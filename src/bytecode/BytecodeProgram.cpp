@@ -0,0 +1,28 @@
+#include "BytecodeProgram.h"
+
+uint32_t
+BytecodeProgram::addFunction(std::unique_ptr<BytecodeFunction> inFunction) {
+  functions.push_back(std::move(inFunction));
+  return static_cast<uint32_t>(functions.size() - 1);
+}
+
+BytecodeFunction *BytecodeProgram::getFunction(uint32_t inIndex) const {
+  return functions[inIndex].get();
+}
+
+const std::vector<std::unique_ptr<BytecodeFunction>> &
+BytecodeProgram::getFunctions() const {
+  return functions;
+}
+
+void BytecodeProgram::setMainIndex(uint32_t inIndex) { mainIndex = inIndex; }
+
+uint32_t BytecodeProgram::getMainIndex() const { return mainIndex; }
+
+std::string BytecodeProgram::toString() const {
+  std::string result = "";
+  for (const auto &function : functions) {
+    result += function->toString();
+  }
+  return result;
+}
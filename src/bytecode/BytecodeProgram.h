@@ -0,0 +1,19 @@
+#pragma once
+#include "BytecodeFunction.h"
+#include <memory>
+#include <vector>
+
+class BytecodeProgram {
+public:
+  BytecodeProgram() = default;
+  uint32_t addFunction(std::unique_ptr<BytecodeFunction> inFunction);
+  BytecodeFunction *getFunction(uint32_t inIndex) const;
+  const std::vector<std::unique_ptr<BytecodeFunction>> &getFunctions() const;
+  void setMainIndex(uint32_t inIndex);
+  uint32_t getMainIndex() const;
+  std::string toString() const;
+
+private:
+  std::vector<std::unique_ptr<BytecodeFunction>> functions;
+  uint32_t mainIndex = 0;
+};
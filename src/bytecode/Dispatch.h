@@ -0,0 +1,14 @@
+#pragma once
+
+/* Dispatch strategy of the virtual machine loops. With GCC and Clang every
+ * handler jumps straight to the next one through a table of label addresses
+ * (computed goto), other compilers use a switch. Defining
+ * TKOM_SWITCH_DISPATCH forces the switch everywhere. */
+#if defined(__GNUC__) && !defined(TKOM_SWITCH_DISPATCH)
+#define TKOM_COMPUTED_GOTO 1
+#else
+#define TKOM_COMPUTED_GOTO 0
+#endif
+
+constexpr const char *DispatchStrategy =
+    TKOM_COMPUTED_GOTO ? "computed goto" : "switch";
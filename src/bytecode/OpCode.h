@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+
+/* Every instruction is a single 32-bit word: opcode in the low byte and an
+ * unsigned 24-bit operand (slot, constant, jump target, function index or
+ * switch table). */
+enum class OpCode : uint8_t {
+  Constant,
+  LoadLocal,
+  StoreLocal,
+  DeclareLocal,
+  DeclareMutableLocal,
+  SetLocal,
+  Pop,
+  Sum,
+  Substraction,
+  Multiplication,
+  Division,
+  Modulo,
+  LogicalOr,
+  LogicalAnd,
+  Less,
+  LessEqual,
+  More,
+  MoreEqual,
+  Equal,
+  NotEqual,
+  Negation,
+  Jump,
+  JumpIfFalse,
+  JumpIfLoopFalse,
+  JumpIfTrue,
+  /* Jump when the operand on top decides || or &&, which is then replaced
+   * by the result, otherwise keep it for the binary opcode */
+  ShortCircuitOr,
+  ShortCircuitAnd,
+  /* Compare the two operands on top, in Expression::Operator order, and
+   * jump to the target of the Jump that follows when the outcome equals the
+   * operand, skipping that Jump otherwise */
+  TestLess,
+  TestLessEqual,
+  TestMore,
+  TestMoreEqual,
+  TestEqual,
+  TestNotEqual,
+  MatchCase,
+  Switch,
+  Call,
+  TailCall,
+  Return,
+  ReturnVoid,
+  RequireValue,
+  ToInt,
+  ToFloat,
+  ToString,
+  ToBool,
+  Print,
+  Throw,
+  /* Binary opcodes quickened for two int or two float operands, in
+   * Expression::Operator order */
+  SumInt,
+  SubstractionInt,
+  MultiplicationInt,
+  DivisionInt,
+  ModuloInt,
+  LogicalOrInt,
+  LogicalAndInt,
+  LessInt,
+  LessEqualInt,
+  MoreInt,
+  MoreEqualInt,
+  EqualInt,
+  NotEqualInt,
+  SumFloat,
+  SubstractionFloat,
+  MultiplicationFloat,
+  DivisionFloat,
+  ModuloFloat,
+  LogicalOrFloat,
+  LogicalAndFloat,
+  LessFloat,
+  LessEqualFloat,
+  MoreFloat,
+  MoreEqualFloat,
+  EqualFloat,
+  NotEqualFloat,
+};
+
+constexpr uint32_t MaxOperand = (1u << 24) - 1;
+
+/* Executions of a generic binary site seeing the same operand types before
+ * it is quickened */
+constexpr uint32_t QuickeningThreshold = 8;
+/* Operand of a generic binary site whose quickened form failed its guard */
+constexpr uint32_t Unquickenable = MaxOperand;
+
+inline uint32_t encodeInstruction(OpCode inOpCode, uint32_t inOperand = 0) {
+  return (inOperand << 8) | static_cast<uint32_t>(inOpCode);
+}
+
+inline OpCode decodeOpCode(uint32_t inInstruction) {
+  return static_cast<OpCode>(inInstruction & 0xFF);
+}
+
+inline uint32_t decodeOperand(uint32_t inInstruction) {
+  return inInstruction >> 8;
+}
@@ -0,0 +1,584 @@
+#include "RegisterCompiler.h"
+#include "../interpreter/InterpreterError.h"
+#include "../ir/IrDominators.h"
+#include <algorithm>
+
+/* Index of the phi operands that inBlock passes through successor inIndex,
+ * a block may reach the same successor on several edges */
+static size_t getPredecessorIndex(const IrBlock &inBlock, size_t inIndex) {
+  const auto &successors = inBlock.getTerminator()->getSuccessors();
+  const IrBlock *successor = successors[inIndex];
+  size_t occurrence =
+      std::count(successors.begin(), successors.begin() + inIndex, successor);
+  const auto &predecessors = successor->getPredecessors();
+  for (size_t i = 0; i < predecessors.size(); ++i) {
+    if (predecessors[i] == &inBlock && occurrence-- == 0)
+      return i;
+  }
+  throw InterpreterError("Block is missing from the predecessors of its "
+                         "successor!");
+}
+
+std::unique_ptr<RegisterProgram>
+RegisterCompiler::compile(const IrProgram &inProgram) {
+  program = std::make_unique<RegisterProgram>();
+  functionIndices.clear();
+  for (const auto &function : inProgram.getFunctions()) {
+    functionIndices[function->getName()] = program->addFunction(
+        std::make_unique<RegisterFunction>(function->getName()));
+  }
+  auto main = functionIndices.find("main");
+  if (main == functionIndices.end())
+    throw InterpreterError("No function with name main found!");
+  program->setMainIndex(main->second);
+
+  for (const auto &function : inProgram.getFunctions()) {
+    compileFunction(*function);
+  }
+  return std::move(program);
+}
+
+void RegisterCompiler::compileFunction(const IrFunction &inFunction) {
+  currentFunction =
+      program->getFunction(functionIndices.at(inFunction.getName()));
+  for (const auto &parameter : inFunction.getParameters()) {
+    currentFunction->addParameter(parameter.second);
+  }
+
+  /* Blocks follow their dominators, so the first successor of a branch
+   * usually comes right after it */
+  IrDominators dominators(inFunction);
+  const auto &order = dominators.getReversePostOrder();
+  layout.assign(order.begin(), order.end());
+  labels.clear();
+  for (size_t i = 0; i < layout.size(); ++i) {
+    labels[layout[i]] = i;
+  }
+
+  computeIntervals();
+  allocateRegisters();
+
+  edgeBlocks.clear();
+  labelPositions.clear();
+  jumps.clear();
+  switchLabels.clear();
+  for (size_t i = 0; i < layout.size(); ++i) {
+    labelPositions.push_back(
+        static_cast<uint32_t>(currentFunction->getCode().size()));
+    compileBlock(*layout[i], i + 1);
+  }
+  for (size_t i = 0; i < edgeBlocks.size(); ++i) {
+    labelPositions.push_back(
+        static_cast<uint32_t>(currentFunction->getCode().size()));
+    emitMoves(edgeBlocks[i].moves);
+    emitJump(RegisterOpCode::Jump, labels.at(edgeBlocks[i].target));
+  }
+
+  for (const auto &[position, label] : jumps) {
+    currentFunction->patchTarget(position, labelPositions[label]);
+  }
+  for (const auto &[table, tableLabels] : switchLabels) {
+    for (size_t label : tableLabels) {
+      currentFunction->getSwitch(table).targets.push_back(
+          labelPositions[label]);
+    }
+  }
+}
+
+void RegisterCompiler::computeIntervals() {
+  /* Every instruction takes two positions, its operands are read at the
+   * even one and its value is defined at the odd one. Phis are defined
+   * together at the start of their block. */
+  positions.clear();
+  useCounts.clear();
+  hints.clear();
+  callArguments = 0;
+  std::vector<size_t> blockStarts;
+  std::vector<size_t> blockEnds;
+  size_t position = 0;
+  for (const IrBlock *block : layout) {
+    blockStarts.push_back(position);
+    for (const auto &instruction : block->getInstructions()) {
+      positions[instruction.get()] = position;
+      position += 2;
+      for (const IrInstruction *operand : instruction->getOperands()) {
+        ++useCounts[operand];
+      }
+      if (instruction->getOpCode() == IrOpCode::Call)
+        callArguments =
+            std::max(callArguments, instruction->getOperands().size());
+    }
+    blockEnds.push_back(position - 2);
+  }
+
+  /* Values living in registers, comparisons fused with their branch and
+   * constants are read in place */
+  std::vector<const IrInstruction *> values;
+  std::unordered_map<const IrInstruction *, size_t> valueIndices;
+  for (const IrBlock *block : layout) {
+    for (const auto &instruction : block->getInstructions()) {
+      const IrOpCode opCode = instruction->getOpCode();
+      if (!instruction->hasValue() || opCode == IrOpCode::Constant ||
+          opCode == IrOpCode::Undefined || isFused(instruction.get()) ||
+          isTailCall(instruction.get()))
+        continue;
+      valueIndices[instruction.get()] = values.size();
+      values.push_back(instruction.get());
+      if (opCode != IrOpCode::Phi)
+        continue;
+      /* A phi and its operands are best kept in one register, which saves
+       * the move between them */
+      for (const IrInstruction *operand : instruction->getOperands()) {
+        hints[instruction.get()].push_back(operand);
+        hints[operand].push_back(instruction.get());
+      }
+    }
+  }
+
+  /* Values live at the start of every block, a phi is live in the
+   * predecessors its operand comes from */
+  std::vector<std::vector<bool>> liveIn(layout.size(),
+                                        std::vector<bool>(values.size()));
+  std::vector<std::vector<bool>> liveOut(layout.size());
+  bool bIsChanged = true;
+  while (bIsChanged) {
+    bIsChanged = false;
+    for (size_t i = layout.size(); i-- > 0;) {
+      const IrBlock *block = layout[i];
+      std::vector<bool> live(values.size());
+      const auto &successors = block->getTerminator()->getSuccessors();
+      for (size_t j = 0; j < successors.size(); ++j) {
+        const std::vector<bool> &successorLive =
+            liveIn[labels.at(successors[j])];
+        for (size_t k = 0; k < values.size(); ++k) {
+          if (successorLive[k])
+            live[k] = true;
+        }
+        const size_t predecessor = getPredecessorIndex(*block, j);
+        for (const auto &instruction : successors[j]->getInstructions()) {
+          if (instruction->getOpCode() != IrOpCode::Phi)
+            break;
+          auto operand = valueIndices.find(instruction->getOperand(predecessor));
+          if (operand != valueIndices.end())
+            live[operand->second] = true;
+        }
+      }
+      liveOut[i] = live;
+
+      const auto &instructions = block->getInstructions();
+      for (auto instruction = instructions.rbegin();
+           instruction != instructions.rend(); ++instruction) {
+        auto value = valueIndices.find(instruction->get());
+        if (value != valueIndices.end())
+          live[value->second] = false;
+        if ((*instruction)->getOpCode() == IrOpCode::Phi)
+          continue;
+        for (const IrInstruction *operand : (*instruction)->getOperands()) {
+          auto read = valueIndices.find(operand);
+          if (read != valueIndices.end())
+            live[read->second] = true;
+        }
+      }
+      if (live != liveIn[i]) {
+        liveIn[i] = std::move(live);
+        bIsChanged = true;
+      }
+    }
+  }
+
+  /* A value is live in one range of every block it is live in, so it
+   * leaves holes where another value may take its register */
+  intervals.assign(values.size(), Interval{});
+  for (size_t k = 0; k < values.size(); ++k) {
+    intervals[k].value = values[k];
+  }
+  for (size_t i = 0; i < layout.size(); ++i) {
+    std::unordered_map<size_t, LiveRange> ranges;
+    for (size_t k = 0; k < values.size(); ++k) {
+      if (liveIn[i][k])
+        ranges[k] = LiveRange{blockStarts[i], blockStarts[i]};
+    }
+    for (const auto &instruction : layout[i]->getInstructions()) {
+      const size_t position = positions.at(instruction.get());
+      if (instruction->getOpCode() != IrOpCode::Phi) {
+        for (const IrInstruction *operand : instruction->getOperands()) {
+          auto read = valueIndices.find(operand);
+          if (read != valueIndices.end())
+            ranges[read->second].end = position;
+        }
+      }
+      auto value = valueIndices.find(instruction.get());
+      if (value == valueIndices.end())
+        continue;
+      size_t start = position + 1;
+      if (instruction->getOpCode() == IrOpCode::Parameter)
+        start = 0;
+      else if (instruction->getOpCode() == IrOpCode::Phi)
+        start = blockStarts[i];
+      ranges[value->second] = LiveRange{start, start};
+    }
+    for (size_t k = 0; k < values.size(); ++k) {
+      if (liveOut[i][k])
+        ranges[k].end = blockEnds[i];
+    }
+    for (const auto &[k, range] : ranges) {
+      intervals[k].ranges.push_back(range);
+    }
+  }
+}
+
+void RegisterCompiler::allocateRegisters() {
+  /* Values are placed in the order they are defined, in the lowest
+   * register no value live at the same time holds. Parameters stay where
+   * the caller placed them. */
+  std::stable_sort(intervals.begin(), intervals.end(),
+                   [](const Interval &inLhs, const Interval &inRhs) {
+                     return inLhs.ranges.front().start <
+                            inRhs.ranges.front().start;
+                   });
+  registers.clear();
+  std::vector<std::vector<LiveRange>> occupied(
+      currentFunction->getParameters().size());
+  auto isFree = [&](uint16_t inRegister, const Interval &inInterval) {
+    if (inRegister >= occupied.size())
+      return true;
+    for (const LiveRange &range : inInterval.ranges) {
+      for (const LiveRange &other : occupied[inRegister]) {
+        if (range.start <= other.end && other.start <= range.end)
+          return false;
+      }
+    }
+    return true;
+  };
+
+  for (const Interval &interval : intervals) {
+    const IrInstruction *value = interval.value;
+    uint16_t allocated = 0;
+    if (value->getOpCode() == IrOpCode::Parameter) {
+      allocated = static_cast<uint16_t>(value->getIndex());
+    } else {
+      bool bIsHinted = false;
+      for (const IrInstruction *hint : hints[value]) {
+        auto found = registers.find(hint);
+        if (found != registers.end() && isFree(found->second, interval)) {
+          allocated = found->second;
+          bIsHinted = true;
+          break;
+        }
+      }
+      while (!bIsHinted && !isFree(allocated, interval)) {
+        ++allocated;
+      }
+    }
+    if (allocated >= occupied.size())
+      occupied.resize(allocated + 1);
+    occupied[allocated].insert(occupied[allocated].end(),
+                               interval.ranges.begin(), interval.ranges.end());
+    registers[value] = allocated;
+  }
+
+  currentFunction->setFrameSize(occupied.size() +
+                                std::max<size_t>(callArguments, 1));
+  scratch = static_cast<uint16_t>(occupied.size());
+}
+
+void RegisterCompiler::compileBlock(const IrBlock &inBlock, size_t inNext) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    if (instruction->getOpCode() == IrOpCode::Call &&
+        isTailCall(instruction.get())) {
+      /* The callee returns in place of the caller, the check of the result
+       * moves to its return */
+      const auto &operands = instruction->getOperands();
+      for (size_t i = 0; i < operands.size(); ++i) {
+        emit(RegisterOpCode::Move, static_cast<uint16_t>(scratch + i),
+             getOperand(operands[i]));
+      }
+      emit(RegisterOpCode::TailCall, 0,
+           functionIndices.at(instruction->getName()), scratch);
+      return;
+    }
+    if (instruction->isTerminator())
+      compileTerminator(inBlock, inNext);
+    else if (!isFused(instruction.get()))
+      compileInstruction(*instruction);
+  }
+}
+
+void RegisterCompiler::compileInstruction(const IrInstruction &inInstruction) {
+  const IrOpCode opCode = inInstruction.getOpCode();
+  const auto &operands = inInstruction.getOperands();
+  switch (opCode) {
+  case IrOpCode::Constant:
+  case IrOpCode::Parameter:
+  case IrOpCode::Undefined:
+  case IrOpCode::Phi:
+    return;
+  case IrOpCode::MatchCase: {
+    uint16_t subject = getRegister(operands[0]);
+    emit(RegisterOpCode::MatchCase, registers.at(&inInstruction), subject,
+         getOperand(operands[1]));
+    return;
+  }
+  case IrOpCode::Call:
+    for (size_t i = 0; i < operands.size(); ++i) {
+      emit(RegisterOpCode::Move, static_cast<uint16_t>(scratch + i),
+           getOperand(operands[i]));
+    }
+    emit(RegisterOpCode::Call, registers.at(&inInstruction),
+         functionIndices.at(inInstruction.getName()), scratch);
+    return;
+  case IrOpCode::Print:
+    emit(RegisterOpCode::Print, scratch, getOperand(operands[0]));
+    return;
+  case IrOpCode::RequireValue:
+    emit(RegisterOpCode::RequireValue, getRegister(operands[0]));
+    return;
+  case IrOpCode::CheckDeclared:
+  case IrOpCode::CheckAssignable:
+  case IrOpCode::CheckUndeclared:
+    emit(static_cast<RegisterOpCode>(
+             static_cast<int>(RegisterOpCode::CheckDeclared) +
+             static_cast<int>(opCode) -
+             static_cast<int>(IrOpCode::CheckDeclared)),
+         getOperand(operands[0]),
+         currentFunction->addConstant(RuntimeValue(inInstruction.getName())));
+    return;
+  case IrOpCode::Negation:
+    emit(RegisterOpCode::Negation, registers.at(&inInstruction),
+         getOperand(operands[0]));
+    return;
+  case IrOpCode::ToInt:
+  case IrOpCode::ToFloat:
+  case IrOpCode::ToString:
+  case IrOpCode::ToBool:
+    emit(static_cast<RegisterOpCode>(static_cast<int>(RegisterOpCode::ToInt) +
+                                     static_cast<int>(opCode) -
+                                     static_cast<int>(IrOpCode::ToInt)),
+         registers.at(&inInstruction), getOperand(operands[0]));
+    return;
+  default:
+    /* Binary opcodes are laid out in the same order */
+    emit(static_cast<RegisterOpCode>(static_cast<int>(RegisterOpCode::Sum) +
+                                     static_cast<int>(opCode) -
+                                     static_cast<int>(IrOpCode::Sum)),
+         registers.at(&inInstruction), getOperand(operands[0]),
+         getOperand(operands[1]));
+    return;
+  }
+}
+
+void RegisterCompiler::compileTerminator(const IrBlock &inBlock,
+                                         size_t inNext) {
+  const IrInstruction &terminator = *inBlock.getTerminator();
+  const IrOpCode opCode = terminator.getOpCode();
+  switch (opCode) {
+  case IrOpCode::Jump: {
+    emitMoves(getPhiMoves(inBlock, 0));
+    const size_t target = labels.at(terminator.getSuccessors()[0]);
+    if (target != inNext)
+      emitJump(RegisterOpCode::Jump, target);
+    return;
+  }
+  case IrOpCode::Branch:
+  case IrOpCode::LoopBranch:
+  case IrOpCode::ShortCircuitOr:
+  case IrOpCode::ShortCircuitAnd: {
+    const size_t trueLabel = getEdgeLabel(inBlock, 0);
+    const size_t falseLabel = getEdgeLabel(inBlock, 1);
+    compileBranch(opCode, terminator.getOperand(0), trueLabel, falseLabel,
+                  inNext);
+    return;
+  }
+  case IrOpCode::Switch: {
+    uint16_t subject = getRegister(terminator.getOperand(0));
+    uint16_t table = currentFunction->addSwitch(*terminator.getDispatch());
+    std::vector<size_t> tableLabels;
+    for (size_t i = 0; i < terminator.getSuccessors().size(); ++i) {
+      tableLabels.push_back(getEdgeLabel(inBlock, i));
+    }
+    switchLabels.emplace_back(table, std::move(tableLabels));
+    emit(RegisterOpCode::Switch, subject, table);
+    return;
+  }
+  case IrOpCode::Return:
+    emit(RegisterOpCode::Return, getOperand(terminator.getOperand(0)));
+    return;
+  case IrOpCode::ReturnVoid:
+    emit(RegisterOpCode::ReturnVoid);
+    return;
+  default:
+    emit(RegisterOpCode::Throw, 0,
+         currentFunction->addConstant(RuntimeValue(terminator.getName())));
+    return;
+  }
+}
+
+void RegisterCompiler::compileBranch(IrOpCode inOpCode,
+                                     const IrInstruction *inCondition,
+                                     size_t inTrue, size_t inFalse,
+                                     size_t inNext) {
+  if (inOpCode == IrOpCode::ShortCircuitOr ||
+      inOpCode == IrOpCode::ShortCircuitAnd) {
+    emitJump(inOpCode == IrOpCode::ShortCircuitOr
+                 ? RegisterOpCode::ShortCircuitOr
+                 : RegisterOpCode::ShortCircuitAnd,
+             inTrue, getOperand(inCondition));
+    if (inFalse != inNext)
+      emitJump(RegisterOpCode::Jump, inFalse);
+    return;
+  }
+
+  /* Comparisons always yield a bool, so they branch without one */
+  if (isFused(inCondition)) {
+    const auto opCode = static_cast<RegisterOpCode>(
+        static_cast<int>(RegisterOpCode::TestLess) +
+        static_cast<int>(inCondition->getOpCode()) -
+        static_cast<int>(IrOpCode::Less));
+    uint16_t lhs = getOperand(inCondition->getOperand(0));
+    uint16_t rhs = getOperand(inCondition->getOperand(1));
+    if (inFalse == inNext) {
+      emit(opCode, lhs, rhs, 1);
+      emitJump(RegisterOpCode::Jump, inTrue);
+      return;
+    }
+    emit(opCode, lhs, rhs, 0);
+    emitJump(RegisterOpCode::Jump, inFalse);
+    if (inTrue != inNext)
+      emitJump(RegisterOpCode::Jump, inTrue);
+    return;
+  }
+
+  uint16_t condition = getOperand(inCondition);
+  if (inOpCode == IrOpCode::Branch && inTrue != inNext &&
+      inFalse == inNext) {
+    emitJump(RegisterOpCode::JumpIfTrue, inTrue, condition);
+    return;
+  }
+  emitJump(inOpCode == IrOpCode::LoopBranch ? RegisterOpCode::JumpIfLoopFalse
+                                            : RegisterOpCode::JumpIfFalse,
+           inFalse, condition);
+  if (inTrue != inNext)
+    emitJump(RegisterOpCode::Jump, inTrue);
+}
+
+std::vector<RegisterCompiler::Move>
+RegisterCompiler::getPhiMoves(const IrBlock &inBlock, size_t inIndex) {
+  const IrBlock *successor = inBlock.getTerminator()->getSuccessors()[inIndex];
+  const size_t predecessor = getPredecessorIndex(inBlock, inIndex);
+  std::vector<Move> moves;
+  for (const auto &instruction : successor->getInstructions()) {
+    if (instruction->getOpCode() != IrOpCode::Phi)
+      break;
+    uint16_t destination = registers.at(instruction.get());
+    uint16_t source = getOperand(instruction->getOperand(predecessor));
+    if (destination != source)
+      moves.push_back(Move{destination, source});
+  }
+  return moves;
+}
+
+size_t RegisterCompiler::getEdgeLabel(const IrBlock &inBlock, size_t inIndex) {
+  const IrBlock *successor = inBlock.getTerminator()->getSuccessors()[inIndex];
+  std::vector<Move> moves = getPhiMoves(inBlock, inIndex);
+  if (moves.empty())
+    return labels.at(successor);
+  edgeBlocks.push_back(EdgeBlock{std::move(moves), successor});
+  return layout.size() + edgeBlocks.size() - 1;
+}
+
+void RegisterCompiler::emitMoves(std::vector<Move> inMoves) {
+  while (!inMoves.empty()) {
+    /* A move is safe once no other one still reads its destination */
+    auto ready = std::find_if(
+        inMoves.begin(), inMoves.end(), [&](const Move &inMove) {
+          return std::none_of(inMoves.begin(), inMoves.end(),
+                              [&](const Move &inOther) {
+                                return inOther.source == inMove.destination;
+                              });
+        });
+    if (ready == inMoves.end()) {
+      /* Only cycles are left, one of their registers is saved to break
+       * them */
+      const uint16_t saved = inMoves.front().destination;
+      emit(RegisterOpCode::Move, scratch, saved);
+      for (Move &move : inMoves) {
+        if (move.source == saved)
+          move.source = scratch;
+      }
+      continue;
+    }
+    emit(RegisterOpCode::Move, ready->destination, ready->source);
+    inMoves.erase(ready);
+  }
+}
+
+uint16_t RegisterCompiler::getOperand(const IrInstruction *inValue) {
+  if (inValue->getOpCode() == IrOpCode::Constant)
+    return currentFunction->addConstant(inValue->getConstant());
+  /* Undefined reads as void, which the checks reject */
+  if (inValue->getOpCode() == IrOpCode::Undefined)
+    return currentFunction->addConstant(RuntimeValue());
+  return registers.at(inValue);
+}
+
+uint16_t RegisterCompiler::getRegister(const IrInstruction *inValue) {
+  uint16_t operand = getOperand(inValue);
+  if (!(operand & ConstantOperand))
+    return operand;
+  emit(RegisterOpCode::Move, scratch, operand);
+  return scratch;
+}
+
+bool RegisterCompiler::isFused(const IrInstruction *inValue) const {
+  if (inValue->getOpCode() < IrOpCode::Less ||
+      inValue->getOpCode() > IrOpCode::NotEqual)
+    return false;
+  auto count = useCounts.find(inValue);
+  if (count == useCounts.end() || count->second != 1)
+    return false;
+
+  /* Only a comparison right before the branch reading it */
+  const auto &instructions = inValue->getBlock()->getInstructions();
+  const IrInstruction *terminator = instructions.back().get();
+  return instructions.size() >= 2 &&
+         instructions[instructions.size() - 2].get() == inValue &&
+         (terminator->getOpCode() == IrOpCode::Branch ||
+          terminator->getOpCode() == IrOpCode::LoopBranch) &&
+         terminator->getOperand(0) == inValue;
+}
+
+bool RegisterCompiler::isTailCall(const IrInstruction *inValue) const {
+  if (inValue->getOpCode() != IrOpCode::Call)
+    return false;
+  const auto &instructions = inValue->getBlock()->getInstructions();
+  const IrInstruction *terminator = instructions.back().get();
+  if (terminator->getOpCode() != IrOpCode::Return ||
+      terminator->getOperand(0) != inValue)
+    return false;
+
+  /* Only checks of the call may follow it, and nothing else reads it */
+  auto instruction = std::find_if(
+      instructions.begin(), instructions.end(),
+      [inValue](const auto &inInstruction) {
+        return inInstruction.get() == inValue;
+      });
+  size_t uses = 1;
+  for (++instruction; instruction->get() != terminator; ++instruction) {
+    if ((*instruction)->getOpCode() != IrOpCode::RequireValue ||
+        (*instruction)->getOperand(0) != inValue)
+      return false;
+    ++uses;
+  }
+  return useCounts.at(inValue) == uses;
+}
+
+void RegisterCompiler::emit(RegisterOpCode inOpCode, uint16_t inA,
+                            uint16_t inB, uint16_t inC) {
+  currentFunction->emit(RegisterInstruction(inOpCode, inA, inB, inC));
+}
+
+void RegisterCompiler::emitJump(RegisterOpCode inOpCode, size_t inLabel,
+                                uint16_t inA) {
+  jumps.emplace_back(
+      currentFunction->emit(RegisterInstruction(inOpCode, inA)), inLabel);
+}
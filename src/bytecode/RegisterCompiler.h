@@ -0,0 +1,102 @@
+#pragma once
+#include "../ir/IrProgram.h"
+#include "RegisterProgram.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Lowers the SSA form into three address register code. Blocks are laid out
+ * in reverse post order. Values are live in one range of every block, each
+ * takes the lowest register no value live at the same time holds, so values
+ * whose lifetimes do not overlap share a register. Phis become moves at the
+ * end of their predecessors, in blocks of their own on edges leaving a block
+ * with several successors. Constants are read from the constant pool in
+ * place and the arguments of a call are moved into the registers past the
+ * allocated ones, which become the parameter registers of the callee
+ * frame. */
+class RegisterCompiler {
+public:
+  RegisterCompiler() = default;
+  std::unique_ptr<RegisterProgram> compile(const IrProgram &inProgram);
+
+private:
+  /* Positions a value is live at, even ones read operands and odd ones
+   * define results */
+  struct LiveRange {
+    size_t start;
+    size_t end;
+  };
+
+  struct Interval {
+    const IrInstruction *value;
+    /* One range per block, in layout order */
+    std::vector<LiveRange> ranges;
+  };
+
+  struct Move {
+    uint16_t destination;
+    uint16_t source;
+  };
+
+  /* Moves of a phi edge placed after the code of every block */
+  struct EdgeBlock {
+    std::vector<Move> moves;
+    const IrBlock *target;
+  };
+
+  void compileFunction(const IrFunction &inFunction);
+  void computeIntervals();
+  void allocateRegisters();
+  void compileBlock(const IrBlock &inBlock, size_t inNext);
+  void compileInstruction(const IrInstruction &inInstruction);
+  void compileTerminator(const IrBlock &inBlock, size_t inNext);
+  /* Emits the branch of inOpCode on inCondition to inTrue when it holds and
+   * to inFalse otherwise */
+  void compileBranch(IrOpCode inOpCode, const IrInstruction *inCondition,
+                     size_t inTrue, size_t inFalse, size_t inNext);
+  /* Moves the phis of successor inIndex of inBlock read */
+  std::vector<Move> getPhiMoves(const IrBlock &inBlock, size_t inIndex);
+  /* Label control reaches when inBlock leaves through successor inIndex */
+  size_t getEdgeLabel(const IrBlock &inBlock, size_t inIndex);
+  /* Emits the moves in an order that reads every source before it is
+   * overwritten, cycles go through the scratch register */
+  void emitMoves(std::vector<Move> inMoves);
+  /* Register or constant holding inValue */
+  uint16_t getOperand(const IrInstruction *inValue);
+  /* Register holding inValue, constants are moved to the scratch register */
+  uint16_t getRegister(const IrInstruction *inValue);
+  bool isFused(const IrInstruction *inValue) const;
+  /* Whether inValue is a call its block only checks and returns, which then
+   * runs in the frame of the caller */
+  bool isTailCall(const IrInstruction *inValue) const;
+  void emit(RegisterOpCode inOpCode, uint16_t inA = 0, uint16_t inB = 0,
+            uint16_t inC = 0);
+  void emitJump(RegisterOpCode inOpCode, size_t inLabel, uint16_t inA = 0);
+
+  std::unique_ptr<RegisterProgram> program;
+  std::unordered_map<std::string, uint16_t> functionIndices;
+  RegisterFunction *currentFunction = nullptr;
+
+  std::vector<const IrBlock *> layout;
+  std::unordered_map<const IrBlock *, size_t> labels;
+  std::unordered_map<const IrInstruction *, size_t> positions;
+  std::unordered_map<const IrInstruction *, size_t> useCounts;
+  std::vector<Interval> intervals;
+  /* Values whose register a value would best share */
+  std::unordered_map<const IrInstruction *, std::vector<const IrInstruction *>>
+      hints;
+  /* Most arguments any call of the function passes */
+  size_t callArguments = 0;
+  std::unordered_map<const IrInstruction *, uint16_t> registers;
+  /* First register past the allocated ones, the scratch register and the
+   * start of the arguments of calls */
+  uint16_t scratch = 0;
+
+  std::vector<EdgeBlock> edgeBlocks;
+  /* Code position of every label, the blocks in layout order followed by
+   * the edge blocks */
+  std::vector<uint32_t> labelPositions;
+  std::vector<std::pair<size_t, size_t>> jumps;
+  std::vector<std::pair<uint16_t, std::vector<size_t>>> switchLabels;
+};
@@ -0,0 +1,137 @@
+#include "RegisterFunction.h"
+#include "../interpreter/InterpreterError.h"
+#include <cmath>
+
+static const char *registerOpCodeNames[] = {
+    "Move", "CheckDeclared", "CheckAssignable", "CheckUndeclared", "Sum",
+    "Substraction", "Multiplication", "Division", "Modulo", "LogicalOr",
+    "LogicalAnd", "Less", "LessEqual", "More", "MoreEqual", "Equal",
+    "NotEqual", "Negation", "Jump", "JumpIfFalse", "JumpIfLoopFalse",
+    "JumpIfTrue", "ShortCircuitOr", "ShortCircuitAnd", "TestLess",
+    "TestLessEqual", "TestMore", "TestMoreEqual", "TestEqual", "TestNotEqual",
+    "MatchCase", "Switch", "Call", "TailCall", "Return", "ReturnVoid", "RequireValue", "ToInt",
+    "ToFloat", "ToString", "ToBool", "Print", "Throw",
+};
+
+RegisterFunction::RegisterFunction(const std::string &inName) : name(inName) {}
+
+size_t RegisterFunction::emit(const RegisterInstruction &inInstruction) {
+  code.push_back(inInstruction);
+  return code.size() - 1;
+}
+
+void RegisterFunction::patchTarget(size_t inPosition, uint32_t inTarget) {
+  code[inPosition].setTarget(inTarget);
+}
+
+uint16_t RegisterFunction::addConstant(const RuntimeValue &inConstant) {
+  for (size_t i = 0; i < constants.size(); ++i) {
+    if (constants[i] == inConstant &&
+        (inConstant.getType() != RuntimeValue::Type::Float ||
+         std::signbit(constants[i].getFloat()) ==
+             std::signbit(inConstant.getFloat())))
+      return static_cast<uint16_t>(i) | ConstantOperand;
+  }
+  if (constants.size() > MaxRegisterOperand)
+    throw InterpreterError("Too many constants in function " + name + "!");
+  constants.push_back(inConstant);
+  return static_cast<uint16_t>(constants.size() - 1) | ConstantOperand;
+}
+
+uint16_t RegisterFunction::addSwitch(const MatchDispatch &inDispatch) {
+  if (switches.size() > MaxRegisterOperand)
+    throw InterpreterError("Too many matches in function " + name + "!");
+  switches.push_back(SwitchTable{inDispatch, {}});
+  return static_cast<uint16_t>(switches.size() - 1);
+}
+
+SwitchTable &RegisterFunction::getSwitch(uint16_t inIndex) {
+  return switches[inIndex];
+}
+
+void RegisterFunction::addParameter(bool bInIsMutable) {
+  parameters.push_back(bInIsMutable);
+}
+
+void RegisterFunction::setFrameSize(size_t inFrameSize) {
+  if (inFrameSize > MaxRegisterOperand)
+    throw InterpreterError("Too many registers in function " + name + "!");
+  frameSize = inFrameSize;
+}
+
+void RegisterFunction::clear() {
+  code.clear();
+  constants.clear();
+  switches.clear();
+  parameters.clear();
+  frameSize = 0;
+}
+
+const std::string &RegisterFunction::getName() const { return name; }
+
+const std::vector<RegisterInstruction> &RegisterFunction::getCode() const {
+  return code;
+}
+
+const std::vector<RuntimeValue> &RegisterFunction::getConstants() const {
+  return constants;
+}
+
+const std::vector<SwitchTable> &RegisterFunction::getSwitches() const {
+  return switches;
+}
+
+const std::vector<bool> &RegisterFunction::getParameters() const {
+  return parameters;
+}
+
+size_t RegisterFunction::getFrameSize() const { return frameSize; }
+
+std::string RegisterFunction::toString() const {
+  auto operand = [](uint16_t inOperand) {
+    if (inOperand & ConstantOperand)
+      return "k" + std::to_string(inOperand & ~ConstantOperand);
+    return "r" + std::to_string(inOperand);
+  };
+
+  std::string result =
+      "fn " + name + " (frame: " + std::to_string(frameSize) + ")\n";
+  for (size_t i = 0; i < code.size(); ++i) {
+    const RegisterInstruction &instruction = code[i];
+    result += "  " + std::to_string(i) + ": " +
+              registerOpCodeNames[static_cast<size_t>(instruction.opCode)];
+    switch (instruction.opCode) {
+    case RegisterOpCode::Jump:
+      result += " " + std::to_string(instruction.getTarget());
+      break;
+    case RegisterOpCode::JumpIfFalse:
+    case RegisterOpCode::JumpIfLoopFalse:
+    case RegisterOpCode::JumpIfTrue:
+    case RegisterOpCode::ShortCircuitOr:
+    case RegisterOpCode::ShortCircuitAnd:
+      result += " " + operand(instruction.a) + ", " +
+                std::to_string(instruction.getTarget());
+      break;
+    case RegisterOpCode::TestLess:
+    case RegisterOpCode::TestLessEqual:
+    case RegisterOpCode::TestMore:
+    case RegisterOpCode::TestMoreEqual:
+    case RegisterOpCode::TestEqual:
+    case RegisterOpCode::TestNotEqual:
+      result += " " + operand(instruction.a) + ", " + operand(instruction.b) +
+                ", " + std::to_string(instruction.c);
+      break;
+    case RegisterOpCode::Switch:
+      result += " " + operand(instruction.a) + ", " +
+                std::to_string(instruction.b) + " (" +
+                switches[instruction.b].dispatch.toString() + ")";
+      break;
+    default:
+      result += " " + operand(instruction.a) + ", " + operand(instruction.b) +
+                ", " + operand(instruction.c);
+      break;
+    }
+    result += "\n";
+  }
+  return result;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "RegisterOpCode.h"
+#include "SwitchTable.h"
+#include "../interpreter/Context.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class RegisterFunction {
+public:
+  explicit RegisterFunction(const std::string &inName);
+  size_t emit(const RegisterInstruction &inInstruction);
+  void patchTarget(size_t inPosition, uint32_t inTarget);
+  uint16_t addConstant(const RuntimeValue &inConstant);
+  uint16_t addSwitch(const MatchDispatch &inDispatch);
+  SwitchTable &getSwitch(uint16_t inIndex);
+  void addParameter(bool bInIsMutable);
+  void setFrameSize(size_t inFrameSize);
+  void clear();
+
+  const std::string &getName() const;
+  const std::vector<RegisterInstruction> &getCode() const;
+  const std::vector<RuntimeValue> &getConstants() const;
+  const std::vector<SwitchTable> &getSwitches() const;
+  const std::vector<bool> &getParameters() const;
+  size_t getFrameSize() const;
+  std::string toString() const;
+
+private:
+  std::string name;
+  std::vector<RegisterInstruction> code;
+  std::vector<RuntimeValue> constants;
+  std::vector<SwitchTable> switches;
+  std::vector<bool> parameters;
+  size_t frameSize = 0;
+};
@@ -0,0 +1,327 @@
+#include "RegisterInterpreter.h"
+#include "../lexer/Lexer.h"
+#include "../instructions/Program.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/Resolver.h"
+#include "../interpreter/TypeInference.h"
+#include "../interpreter/ValueOperations.h"
+#include "../ir/IrBuilder.h"
+#include "../ir/IrOptimizer.h"
+#include "../ir/IrVerifier.h"
+#include "../parser/Parser.h"
+#include "RegisterCompiler.h"
+#include "Dispatch.h"
+
+RegisterInterpreter::RegisterInterpreter(std::unique_ptr<Parser> inParser,
+                                         bool bInOptimize)
+    : parser(std::move(inParser)), bOptimize(bInOptimize) {}
+
+std::optional<ValueType> RegisterInterpreter::execute() {
+  if (!program) {
+    Program *parsedProgram = parser->parseProgram();
+    /* Statically guaranteed type errors are reported before anything runs */
+    Resolver resolver;
+    resolver.resolve(*parsedProgram);
+    TypeInference typeInference;
+    typeInference.infer(*parsedProgram);
+    auto ir = IrBuilder().build(*parsedProgram);
+    if (bOptimize)
+      IrOptimizer().optimize(*ir);
+    else
+      IrVerifier().verify(*ir);
+    RegisterCompiler compiler;
+    program = compiler.compile(*ir);
+  }
+  auto result = run(*program->getFunction(program->getMainIndex()));
+  if (!result)
+    return std::nullopt;
+  return result->toValueType();
+}
+
+size_t RegisterInterpreter::getExecutedInstructionCount() const {
+  return executedInstructions;
+}
+
+const RegisterProgram *RegisterInterpreter::getProgram() const {
+  return program.get();
+}
+
+void RegisterInterpreter::enterFrame(const RegisterFunction &inFunction,
+                                     size_t inBase) {
+  /* Arguments are already in place, every other register is written
+   * before it is read */
+  size_t frameEnd = inBase + inFunction.getFrameSize();
+  if (registers.size() < frameEnd)
+    registers.resize(frameEnd);
+}
+
+/* FETCH loads the next instruction, DISPATCH jumps to its handler and NEXT
+ * finishes a handler. */
+#define FETCH()                                                                \
+  ++executedInstructions;                                                      \
+  instruction = &code[ip++]
+#if TKOM_COMPUTED_GOTO
+#define DISPATCH()                                                             \
+  goto *dispatchTable[static_cast<size_t>(instruction->opCode)];
+#define HANDLER(name) handle##name:
+#define NEXT()                                                                 \
+  do {                                                                         \
+    FETCH();                                                                   \
+    DISPATCH()                                                                 \
+  } while (0)
+#else
+#define DISPATCH() switch (instruction->opCode)
+#define HANDLER(name) case RegisterOpCode::name:
+#define NEXT() break
+#endif
+
+/* Fused compare and branch, ints and floats are compared in place */
+#define TEST_HANDLER(name, op)                                                 \
+  HANDLER(Test##name) {                                                        \
+    const RuntimeValue &lhs = operand(instruction->a);                         \
+    const RuntimeValue &rhs = operand(instruction->b);                         \
+    bool bOutcome;                                                             \
+    if (lhs.getType() == RuntimeValue::Type::Int &&                            \
+        rhs.getType() == RuntimeValue::Type::Int)                              \
+      bOutcome = lhs.getInt() op rhs.getInt();                                 \
+    else if (lhs.getType() == RuntimeValue::Type::Float &&                     \
+             rhs.getType() == RuntimeValue::Type::Float)                       \
+      bOutcome = lhs.getFloat() op rhs.getFloat();                             \
+    else                                                                       \
+      bOutcome = ValueOperations::compare(Expression::Operator::name, lhs,     \
+                                          rhs);                                \
+    ip = bOutcome == (instruction->c != 0) ? code[ip].getTarget() : ip + 1;    \
+    NEXT();                                                                    \
+  }
+
+std::optional<RuntimeValue>
+RegisterInterpreter::run(const RegisterFunction &inMain) {
+  registers.clear();
+  frames.clear();
+  executedInstructions = 0;
+  registers.reserve(1024);
+
+  const RegisterFunction *function = &inMain;
+  size_t base = 0;
+  enterFrame(inMain, base);
+  /* Parameters of main default to 0 */
+  for (size_t i = 0; i < inMain.getParameters().size(); ++i) {
+    registers[i] = RuntimeValue(0);
+  }
+  frames.push_back(CallFrame{function, 0, base, 0, false});
+
+  const RegisterInstruction *code = function->getCode().data();
+  const RuntimeValue *constants = function->getConstants().data();
+  RuntimeValue *frame = registers.data();
+  size_t ip = 0;
+  const RuntimeValue voidValue;
+
+  auto operand = [&](uint16_t inOperand) -> const RuntimeValue & {
+    return inOperand & ConstantOperand
+               ? constants[inOperand & MaxRegisterOperand]
+               : frame[inOperand];
+  };
+
+#if TKOM_COMPUTED_GOTO
+  /* Handler addresses in RegisterOpCode order */
+  static void *const dispatchTable[] = {
+      &&handleMove, &&handleCheckDeclared, &&handleCheckAssignable,
+      &&handleCheckUndeclared, &&handleSum, &&handleSubstraction,
+      &&handleMultiplication, &&handleDivision, &&handleModulo,
+      &&handleLogicalOr, &&handleLogicalAnd, &&handleLess, &&handleLessEqual,
+      &&handleMore, &&handleMoreEqual, &&handleEqual, &&handleNotEqual,
+      &&handleNegation, &&handleJump, &&handleJumpIfFalse,
+      &&handleJumpIfLoopFalse, &&handleJumpIfTrue, &&handleShortCircuitOr,
+      &&handleShortCircuitAnd, &&handleTestLess, &&handleTestLessEqual,
+      &&handleTestMore, &&handleTestMoreEqual, &&handleTestEqual,
+      &&handleTestNotEqual, &&handleMatchCase, &&handleSwitch,
+      &&handleCall, &&handleTailCall, &&handleReturn, &&handleReturnVoid, &&handleRequireValue, &&handleToInt, &&handleToFloat,
+      &&handleToString, &&handleToBool, &&handlePrint, &&handleThrow};
+  static_assert(sizeof(dispatchTable) / sizeof(*dispatchTable) ==
+                static_cast<size_t>(RegisterOpCode::Throw) + 1);
+#endif
+
+  const RegisterInstruction *instruction;
+  for (;;) {
+    FETCH();
+    DISPATCH() {
+    HANDLER(Move)
+      frame[instruction->a] = operand(instruction->b);
+      NEXT();
+    HANDLER(CheckDeclared)
+      if (operand(instruction->a).getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("No variable with such name " +
+                               operand(instruction->b).getString() + "!");
+      NEXT();
+    HANDLER(CheckAssignable) {
+      const RuntimeValue &flag = operand(instruction->a);
+      if (flag.getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("Variable " +
+                               operand(instruction->b).getString() +
+                               " is not declared!");
+      if (!flag.getBool())
+        throw InterpreterError("Not mutable variable " +
+                               operand(instruction->b).getString() +
+                               " cannot be modified!");
+      NEXT();
+    }
+    HANDLER(CheckUndeclared)
+      if (operand(instruction->a).getType() != RuntimeValue::Type::Void)
+        throw InterpreterError("New declaration of local variable named " +
+                               operand(instruction->b).getString() +
+                               " found!");
+      NEXT();
+    HANDLER(Sum)
+    HANDLER(Substraction)
+    HANDLER(Multiplication)
+    HANDLER(Division)
+    HANDLER(Modulo)
+    HANDLER(LogicalOr)
+    HANDLER(LogicalAnd)
+    HANDLER(Less)
+    HANDLER(LessEqual)
+    HANDLER(More)
+    HANDLER(MoreEqual)
+    HANDLER(Equal)
+    HANDLER(NotEqual) {
+      /* Binary opcodes are laid out in Expression::Operator order */
+      auto op = static_cast<Expression::Operator>(
+          static_cast<int>(instruction->opCode) -
+          static_cast<int>(RegisterOpCode::Sum));
+      frame[instruction->a] = ValueOperations::binaryOperation(
+          op, operand(instruction->b), operand(instruction->c));
+      NEXT();
+    }
+    HANDLER(Negation)
+      frame[instruction->a] =
+          ValueOperations::unaryOperation(operand(instruction->b));
+      NEXT();
+    HANDLER(Jump)
+      ip = instruction->getTarget();
+      NEXT();
+    HANDLER(JumpIfFalse)
+      if (!ValueOperations::isTrue(operand(instruction->a)))
+        ip = instruction->getTarget();
+      NEXT();
+    HANDLER(JumpIfLoopFalse) {
+      const RuntimeValue &condition = operand(instruction->a);
+      if (condition.getType() != RuntimeValue::Type::Bool)
+        throw InterpreterError("Invalid expression type in while!");
+      if (!condition.getBool())
+        ip = instruction->getTarget();
+      NEXT();
+    }
+    HANDLER(JumpIfTrue)
+      if (ValueOperations::isTrue(operand(instruction->a)))
+        ip = instruction->getTarget();
+      NEXT();
+    HANDLER(ShortCircuitOr)
+    HANDLER(ShortCircuitAnd)
+      if (ValueOperations::shortCircuits(
+              instruction->opCode == RegisterOpCode::ShortCircuitOr
+                  ? Expression::Operator::LogicalOr
+                  : Expression::Operator::LogicalAnd,
+              operand(instruction->a)))
+        ip = instruction->getTarget();
+      NEXT();
+    TEST_HANDLER(Less, <)
+    TEST_HANDLER(LessEqual, <=)
+    TEST_HANDLER(More, >)
+    TEST_HANDLER(MoreEqual, >=)
+    TEST_HANDLER(Equal, ==)
+    TEST_HANDLER(NotEqual, !=)
+    HANDLER(MatchCase)
+      frame[instruction->a] = RuntimeValue(ValueOperations::matchesCase(
+          frame[instruction->b], operand(instruction->c)));
+      NEXT();
+    HANDLER(Switch)
+      ip = function->getSwitches()[instruction->b].getTarget(
+          frame[instruction->a]);
+      NEXT();
+    HANDLER(Call) {
+      checkCallDepth(frames.size(), maxCallDepth);
+      frames.back().ip = ip;
+      function = program->getFunction(instruction->b);
+      base += instruction->c;
+      enterFrame(*function, base);
+      frames.push_back(CallFrame{function, 0, base, instruction->a, false});
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      frame = registers.data() + base;
+      ip = 0;
+      NEXT();
+    }
+    HANDLER(TailCall) {
+      /* The callee takes over the frame, so the depth does not grow. The
+       * arguments are past the parameter registers they move down to. */
+      function = program->getFunction(instruction->b);
+      for (size_t i = 0; i < function->getParameters().size(); ++i) {
+        frame[i] = std::move(frame[instruction->c + i]);
+      }
+      enterFrame(*function, base);
+      frames.back().function = function;
+      frames.back().bRequiresValue = true;
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      frame = registers.data() + base;
+      ip = 0;
+      NEXT();
+    }
+    HANDLER(Return)
+    HANDLER(ReturnVoid) {
+      RuntimeValue result = instruction->opCode == RegisterOpCode::Return
+                             ? operand(instruction->a)
+                             : voidValue;
+      if (frames.back().bRequiresValue &&
+          result.getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("FunctionCallExpression has to return value");
+      uint16_t resultRegister = frames.back().resultRegister;
+      frames.pop_back();
+      if (frames.empty()) {
+        if (result.getType() == RuntimeValue::Type::Void)
+          return std::nullopt;
+        return result;
+      }
+      const CallFrame &caller = frames.back();
+      function = caller.function;
+      code = function->getCode().data();
+      constants = function->getConstants().data();
+      ip = caller.ip;
+      base = caller.base;
+      frame = registers.data() + base;
+      frame[resultRegister] = std::move(result);
+      NEXT();
+    }
+    HANDLER(RequireValue)
+      if (frame[instruction->a].getType() == RuntimeValue::Type::Void)
+        throw InterpreterError("FunctionCallExpression has to return value");
+      NEXT();
+    HANDLER(ToInt)
+      frame[instruction->a] = ValueOperations::toInt(operand(instruction->b));
+      NEXT();
+    HANDLER(ToFloat)
+      frame[instruction->a] = ValueOperations::toFloat(operand(instruction->b));
+      NEXT();
+    HANDLER(ToString)
+      frame[instruction->a] =
+          ValueOperations::toString(operand(instruction->b));
+      NEXT();
+    HANDLER(ToBool)
+      frame[instruction->a] = ValueOperations::toBool(operand(instruction->b));
+      NEXT();
+    HANDLER(Print)
+      ValueOperations::print(operand(instruction->b));
+      frame[instruction->a] = voidValue;
+      NEXT();
+    HANDLER(Throw)
+      throw InterpreterError(
+          constants[instruction->b & MaxRegisterOperand].getString());
+    }
+  }
+}
+
+#undef FETCH
+#undef DISPATCH
+#undef HANDLER
+#undef NEXT
+#undef TEST_HANDLER
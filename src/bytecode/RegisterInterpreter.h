@@ -0,0 +1,38 @@
+#pragma once
+#include "../interpreter/Interpreter.h"
+#include "RegisterProgram.h"
+#include <memory>
+#include <vector>
+
+/* Register machine executing the output of RegisterCompiler, which lowers
+ * the SSA form of the program, optimized by the IR passes when bInOptimize
+ * is set. Frames are windows into a single register file, a callee window
+ * starts at the argument registers of its caller. */
+class RegisterInterpreter : public Interpreter {
+public:
+  explicit RegisterInterpreter(std::unique_ptr<class Parser> inParser,
+                               bool bInOptimize = false);
+  virtual std::optional<ValueType> execute() override;
+  virtual size_t getExecutedInstructionCount() const override;
+  const RegisterProgram *getProgram() const;
+
+private:
+  struct CallFrame {
+    const RegisterFunction *function;
+    size_t ip;
+    size_t base;
+    uint16_t resultRegister;
+    /* Entered by a returned call, so its result has to be a value */
+    bool bRequiresValue;
+  };
+
+  std::optional<RuntimeValue> run(const RegisterFunction &inMain);
+  void enterFrame(const RegisterFunction &inFunction, size_t inBase);
+
+  std::unique_ptr<Parser> parser;
+  bool bOptimize;
+  std::unique_ptr<RegisterProgram> program;
+  std::vector<RuntimeValue> registers;
+  std::vector<CallFrame> frames;
+  size_t executedInstructions = 0;
+};
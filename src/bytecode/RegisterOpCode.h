@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+
+/* Three address instructions. Operands marked RK name either a register of
+ * the current frame or, with ConstantOperand set, an entry of the constant
+ * pool. Jump targets are stored across the B and C fields. The checks read
+ * the declaration flag of a variable, void before it is declared and its
+ * mutability after, and name it by the string constant B. */
+enum class RegisterOpCode : uint8_t {
+  Move,            // A = RK(B)
+  CheckDeclared,   // flag RK(A) has to be declared
+  CheckAssignable, // flag RK(A) has to be declared and mutable
+  CheckUndeclared, // flag RK(A) cannot be declared yet
+  Sum,             // A = RK(B) + RK(C)
+  Substraction,
+  Multiplication,
+  Division,
+  Modulo,
+  LogicalOr,
+  LogicalAnd,
+  Less,
+  LessEqual,
+  More,
+  MoreEqual,
+  Equal,
+  NotEqual,
+  Negation,        // A = -RK(B)
+  Jump,            // goto target
+  JumpIfFalse,     // if !RK(A) goto target
+  JumpIfLoopFalse, // like JumpIfFalse but RK(A) has to be a bool
+  JumpIfTrue,      // if RK(A) goto target
+  ShortCircuitOr,  // goto target when RK(A) alone decides ||
+  ShortCircuitAnd, // goto target when RK(A) alone decides &&
+  TestLess,        // if (RK(A) < RK(B)) == C take the next Jump, else skip it
+  TestLessEqual,
+  TestMore,
+  TestMoreEqual,
+  TestEqual,
+  TestNotEqual,
+  MatchCase,       // A = R(B) matches RK(C)
+  Switch,          // goto the case of R(A) in switch table B
+  Call,            // A = function B called with arguments from R(C)
+  TailCall,        // return function B called in this frame with arguments from R(C)
+  Return,          // return RK(A)
+  ReturnVoid,
+  RequireValue,    // R(A) cannot be void
+  ToInt,           // A = int(RK(B))
+  ToFloat,
+  ToString,
+  ToBool,
+  Print,           // print RK(B), A = void
+  Throw,           // throw message constant B
+};
+
+constexpr uint16_t ConstantOperand = 0x8000;
+constexpr uint16_t MaxRegisterOperand = ConstantOperand - 1;
+
+class RegisterInstruction {
+public:
+  RegisterInstruction(RegisterOpCode inOpCode, uint16_t inA = 0,
+                      uint16_t inB = 0, uint16_t inC = 0)
+      : opCode(inOpCode), a(inA), b(inB), c(inC) {}
+
+  uint32_t getTarget() const { return (static_cast<uint32_t>(c) << 16) | b; }
+  void setTarget(uint32_t inTarget) {
+    b = static_cast<uint16_t>(inTarget & 0xFFFF);
+    c = static_cast<uint16_t>(inTarget >> 16);
+  }
+
+  RegisterOpCode opCode;
+  uint16_t a;
+  uint16_t b;
+  uint16_t c;
+};
@@ -0,0 +1,31 @@
+#include "RegisterProgram.h"
+#include "../interpreter/InterpreterError.h"
+
+uint16_t
+RegisterProgram::addFunction(std::unique_ptr<RegisterFunction> inFunction) {
+  functions.push_back(std::move(inFunction));
+  if (functions.size() > MaxRegisterOperand)
+    throw InterpreterError("Too many functions in program!");
+  return static_cast<uint16_t>(functions.size() - 1);
+}
+
+RegisterFunction *RegisterProgram::getFunction(uint16_t inIndex) const {
+  return functions[inIndex].get();
+}
+
+const std::vector<std::unique_ptr<RegisterFunction>> &
+RegisterProgram::getFunctions() const {
+  return functions;
+}
+
+void RegisterProgram::setMainIndex(uint16_t inIndex) { mainIndex = inIndex; }
+
+uint16_t RegisterProgram::getMainIndex() const { return mainIndex; }
+
+std::string RegisterProgram::toString() const {
+  std::string result = "";
+  for (const auto &function : functions) {
+    result += function->toString();
+  }
+  return result;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "RegisterFunction.h"
+#include <memory>
+#include <vector>
+
+class RegisterProgram {
+public:
+  RegisterProgram() = default;
+  uint16_t addFunction(std::unique_ptr<RegisterFunction> inFunction);
+  RegisterFunction *getFunction(uint16_t inIndex) const;
+  const std::vector<std::unique_ptr<RegisterFunction>> &getFunctions() const;
+  void setMainIndex(uint16_t inIndex);
+  uint16_t getMainIndex() const;
+  std::string toString() const;
+
+private:
+  std::vector<std::unique_ptr<RegisterFunction>> functions;
+  uint16_t mainIndex = 0;
+};
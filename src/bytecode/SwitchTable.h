@@ -0,0 +1,16 @@
+#pragma once
+#include "../interpreter/MatchDispatch.h"
+#include <cstdint>
+#include <vector>
+
+/* Jump targets of a match lowered to a MatchDispatch */
+struct SwitchTable {
+  MatchDispatch dispatch;
+  /* Code position of the block of every case, the last one ends the match */
+  std::vector<uint32_t> targets;
+
+  uint32_t getTarget(const RuntimeValue &inSubject) const {
+    size_t index = dispatch.find(inSubject);
+    return index == MatchDispatch::NoCase ? targets.back() : targets[index];
+  }
+};
@@ -0,0 +1,58 @@
+#include "Closure.h"
+#include "../interpreter/Interpreter.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/NativeStack.h"
+#include <algorithm>
+
+size_t ClosureState::allocateFrame(const ClosureFunction &inFunction) {
+  size_t frame = locals.size();
+  locals.resize(frame + inFunction.slotCount);
+  localStates.resize(frame + inFunction.slotCount, Undeclared);
+  return frame;
+}
+
+void ClosureState::setArgument(const ClosureFunction &inFunction,
+                               size_t inFrame, size_t inIndex,
+                               RuntimeValue inValue) {
+  locals[inFrame + inIndex] = std::move(inValue);
+  localStates[inFrame + inIndex] =
+      Declared | (inFunction.parameters[inIndex] ? Mutable : 0);
+}
+
+RuntimeValue ClosureState::call(const ClosureFunction &inFunction,
+                                size_t inFrame) {
+  Interpreter::checkCallDepth(depth++, maxDepth);
+  size_t callerFrame = frameBase;
+  frameBase = inFrame;
+  /* Falling off the end of a body returns nothing */
+  RuntimeValue result;
+  Completion completion;
+  bool bTailCalled = false;
+  NativeStack::call([&]() {
+    completion = inFunction.body(*this);
+    while (const ClosureFunction *callee = tailCallee) {
+      tailCallee = nullptr;
+      bTailCalled = true;
+      completion = callee->body(*this);
+    }
+  });
+  if (completion == Completion::Return)
+    result = std::move(returnValue);
+  /* A returned call is an expression, checked once the last callee is done */
+  if (bTailCalled && result.getType() == RuntimeValue::Type::Void)
+    throw InterpreterError("FunctionCallExpression has to return value");
+  --depth;
+  frameBase = callerFrame;
+  locals.resize(inFrame);
+  localStates.resize(inFrame);
+  return result;
+}
+
+void ClosureState::replaceFrame(size_t inFrame) {
+  const size_t slotCount = locals.size() - inFrame;
+  std::move(locals.begin() + inFrame, locals.end(), locals.begin() + frameBase);
+  std::move(localStates.begin() + inFrame, localStates.end(),
+            localStates.begin() + frameBase);
+  locals.resize(frameBase + slotCount);
+  localStates.resize(frameBase + slotCount);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "../interpreter/RuntimeValue.h"
+#include "../interpreter/VisitorInterpreter.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Locals of every active call back to back, the current frame starts at
+ * frameBase */
+struct ClosureState {
+  enum LocalState : uint8_t {
+    Undeclared = 0,
+    Declared = 1,
+    Mutable = 2,
+  };
+
+  /* Grows the locals by the frame of inFunction, the caller writes the
+   * arguments into its first slots before calling */
+  size_t allocateFrame(const struct ClosureFunction &inFunction);
+  void setArgument(const struct ClosureFunction &inFunction, size_t inFrame,
+                   size_t inIndex, RuntimeValue inValue);
+  /* Runs inFunction in the allocated frame and releases it, then every
+   * function a return statement left in tailCallee */
+  RuntimeValue call(const struct ClosureFunction &inFunction, size_t inFrame);
+  /* Moves the frame allocated at inFrame over the current one */
+  void replaceFrame(size_t inFrame);
+
+  std::vector<RuntimeValue> locals;
+  std::vector<uint8_t> localStates;
+  size_t frameBase = 0;
+  /* Number of active calls and the most allowed */
+  size_t depth = 0;
+  size_t maxDepth = 0;
+  /* Set by a return statement before it completes with Completion::Return */
+  RuntimeValue returnValue;
+  /* Function a returned call runs next in the current frame */
+  const struct ClosureFunction *tailCallee = nullptr;
+};
+
+typedef std::function<RuntimeValue(ClosureState &)> ExpressionClosure;
+typedef std::function<Completion(ClosureState &)> StatementClosure;
+typedef std::function<bool(ClosureState &)> ConditionClosure;
+
+struct ClosureFunction {
+  std::string name;
+  /* Mutability of each parameter */
+  std::vector<bool> parameters;
+  size_t slotCount = 0;
+  /* Filled once every function is known, so calls can be bound earlier */
+  StatementClosure body;
+};
+
+struct ClosureProgram {
+  std::vector<std::unique_ptr<ClosureFunction>> functions;
+  const ClosureFunction *main = nullptr;
+};
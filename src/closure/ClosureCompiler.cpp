@@ -0,0 +1,709 @@
+#include "ClosureCompiler.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/BoolFunction.h"
+#include "../instructions/Case.h"
+#include "../instructions/FloatFunction.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/IntFunction.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/PrintFunction.h"
+#include "../instructions/Program.h"
+#include "../instructions/StringFunction.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/Resolver.h"
+#include "../interpreter/TypeInference.h"
+#include "../interpreter/ValueOperations.h"
+#include <cmath>
+#include <type_traits>
+
+/* Division and modulo by zero or overflowing are left to ValueOperations for
+ * its errors */
+template <Expression::Operator Operator, class T>
+static bool isInlineOperation(T inLhs, T inRhs) {
+  if constexpr (Operator == Expression::Operator::Division ||
+                Operator == Expression::Operator::Modulo)
+    return inRhs != 0 && !ValueOperations::overflowsDivision(inLhs, inRhs);
+  else
+    return true;
+}
+
+template <Expression::Operator Operator, class T>
+static RuntimeValue inlineOperation(T inLhs, T inRhs) {
+  using Op = Expression::Operator;
+  if constexpr (Operator == Op::Sum)
+    return RuntimeValue(static_cast<T>(inLhs + inRhs));
+  else if constexpr (Operator == Op::Substraction)
+    return RuntimeValue(static_cast<T>(inLhs - inRhs));
+  else if constexpr (Operator == Op::Multiplication)
+    return RuntimeValue(static_cast<T>(inLhs * inRhs));
+  else if constexpr (Operator == Op::Division)
+    return RuntimeValue(static_cast<T>(inLhs / inRhs));
+  else if constexpr (Operator == Op::Modulo && std::is_same_v<T, float>)
+    return RuntimeValue(std::fmod(inLhs, inRhs));
+  else if constexpr (Operator == Op::Modulo)
+    return RuntimeValue(inLhs % inRhs);
+  else if constexpr (Operator == Op::Less)
+    return RuntimeValue(inLhs < inRhs);
+  else if constexpr (Operator == Op::LessEqual)
+    return RuntimeValue(inLhs <= inRhs);
+  else if constexpr (Operator == Op::More)
+    return RuntimeValue(inLhs > inRhs);
+  else if constexpr (Operator == Op::MoreEqual)
+    return RuntimeValue(inLhs >= inRhs);
+  else if constexpr (Operator == Op::Equal)
+    return RuntimeValue(inLhs == inRhs);
+  else
+    return RuntimeValue(inLhs != inRhs);
+}
+
+template <class T> static T getNumber(const RuntimeValue &inValue) {
+  if constexpr (std::is_same_v<T, int>)
+    return inValue.getInt();
+  else
+    return inValue.getFloat();
+}
+
+/* Operands typed by TypeInference are read without checking their type */
+template <Expression::Operator Operator, class T>
+static ExpressionClosure bindTypedBinary(ExpressionClosure inLhs,
+                                        ExpressionClosure inRhs) {
+  return [lhs = std::move(inLhs),
+          rhs = std::move(inRhs)](ClosureState &inState) {
+    RuntimeValue left = lhs(inState);
+    RuntimeValue right = rhs(inState);
+    if (isInlineOperation<Operator>(getNumber<T>(left), getNumber<T>(right)))
+      return inlineOperation<Operator>(getNumber<T>(left),
+                                       getNumber<T>(right));
+    return ValueOperations::binaryOperation(Operator, left, right);
+  };
+}
+
+/* Ints and floats are computed inline by a closure specialised for its
+ * operator, other operands go through ValueOperations */
+template <Expression::Operator Operator>
+static ExpressionClosure bindBinary(ExpressionClosure inLhs,
+                                   ExpressionClosure inRhs,
+                                   RuntimeValue::Type inOperandType) {
+  if (inOperandType == RuntimeValue::Type::Int)
+    return bindTypedBinary<Operator, int>(std::move(inLhs), std::move(inRhs));
+  if (inOperandType == RuntimeValue::Type::Float)
+    return bindTypedBinary<Operator, float>(std::move(inLhs),
+                                            std::move(inRhs));
+
+  return [lhs = std::move(inLhs),
+          rhs = std::move(inRhs)](ClosureState &inState) {
+    RuntimeValue left = lhs(inState);
+    RuntimeValue right = rhs(inState);
+    if (left.getType() == right.getType()) {
+      if (left.getType() == RuntimeValue::Type::Int &&
+          isInlineOperation<Operator>(left.getInt(), right.getInt()))
+        return inlineOperation<Operator>(left.getInt(), right.getInt());
+      if (left.getType() == RuntimeValue::Type::Float &&
+          isInlineOperation<Operator>(left.getFloat(), right.getFloat()))
+        return inlineOperation<Operator>(left.getFloat(), right.getFloat());
+    }
+    return ValueOperations::binaryOperation(Operator, left, right);
+  };
+}
+
+/* The right operand only runs when the left one does not decide, bools need
+ * no further check then */
+template <Expression::Operator Operator>
+static ExpressionClosure bindLogical(ExpressionClosure inLhs,
+                                    ExpressionClosure inRhs,
+                                    RuntimeValue::Type inOperandType) {
+  constexpr bool bIsOr = Operator == Expression::Operator::LogicalOr;
+  if (inOperandType == RuntimeValue::Type::Bool)
+    return [lhs = std::move(inLhs),
+            rhs = std::move(inRhs)](ClosureState &inState) {
+      RuntimeValue left = lhs(inState);
+      if (left.getBool() == bIsOr)
+        return left;
+      return rhs(inState);
+    };
+
+  return [lhs = std::move(inLhs),
+          rhs = std::move(inRhs)](ClosureState &inState) {
+    RuntimeValue left = lhs(inState);
+    if (ValueOperations::shortCircuits(Operator, left))
+      return RuntimeValue(bIsOr);
+    return ValueOperations::binaryOperation(Operator, left, rhs(inState));
+  };
+}
+
+template <class T> using NumberClosure = std::function<T(ClosureState &)>;
+
+/* Literals and locals are read in place, other operands are computed */
+template <class T>
+static NumberClosure<T> bindNumber(const Expression &inExpression,
+                                   ExpressionClosure inValue) {
+  auto *variableExpression =
+      dynamic_cast<const VariableExpression *>(&inExpression);
+  if (!variableExpression)
+    return [value = std::move(inValue)](ClosureState &inState) {
+      return getNumber<T>(value(inState));
+    };
+
+  const auto &variable = variableExpression->getVariable();
+  if (const auto &value = variable->getValue())
+    return [constant = getNumber<T>(value->getRuntimeValue())](
+               ClosureState &) { return constant; };
+  return [name = *variable->getName(),
+          slot = variable->getSlot()](ClosureState &inState) {
+    size_t index = inState.frameBase + slot;
+    if (!(inState.localStates[index] & ClosureState::Declared))
+      throw InterpreterError("No variable with such name " + name + "!");
+    return getNumber<T>(inState.locals[index]);
+  };
+}
+
+/* A comparison in a condition yields its outcome instead of a bool value,
+ * typed operands are compared as numbers */
+template <Expression::Operator Operator>
+static ConditionClosure bindComparison(const BinaryExpression &inComparison,
+                                       ExpressionClosure inLhs,
+                                       ExpressionClosure inRhs) {
+  auto bindTyped = [&](auto inZero) -> ConditionClosure {
+    using T = decltype(inZero);
+    return [lhs = bindNumber<T>(*inComparison.getLhs(), std::move(inLhs)),
+            rhs = bindNumber<T>(*inComparison.getRhs(), std::move(inRhs))](
+               ClosureState &inState) {
+      T left = lhs(inState);
+      return ValueOperations::compareNumbers(Operator, left, rhs(inState));
+    };
+  };
+  if (inComparison.getOperandType() == RuntimeValue::Type::Int)
+    return bindTyped(0);
+  if (inComparison.getOperandType() == RuntimeValue::Type::Float)
+    return bindTyped(0.0f);
+
+  return [lhs = std::move(inLhs),
+          rhs = std::move(inRhs)](ClosureState &inState) {
+    RuntimeValue left = lhs(inState);
+    return ValueOperations::compare(Operator, left, rhs(inState));
+  };
+}
+
+static ExpressionClosure bindThrow(const std::string &inMessage) {
+  return [inMessage](ClosureState &) -> RuntimeValue {
+    throw InterpreterError(inMessage);
+  };
+}
+
+std::unique_ptr<ClosureProgram>
+ClosureCompiler::compile(const Program &inProgram) {
+  Resolver resolver;
+  resolver.resolve(inProgram);
+  TypeInference typeInference;
+  typeInference.infer(inProgram);
+
+  context.reset();
+  functions.clear();
+  program = std::make_unique<ClosureProgram>();
+  inProgram.accept(*this);
+  return std::move(program);
+}
+
+Completion ClosureCompiler::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &functionName = function->getIdentifier();
+    if (context.findFunction(functionName) != nullptr)
+      throw InterpreterError("Redefinition of function with name " +
+                             functionName + "!");
+    context.insertFunction(function.get());
+
+    auto closureFunction = std::make_unique<ClosureFunction>();
+    closureFunction->name = functionName;
+    for (const auto &argument : function->getArguments()) {
+      closureFunction->parameters.push_back(argument->isMutable());
+    }
+    closureFunction->slotCount = function->getSlotCount();
+    functions[function.get()] = closureFunction.get();
+    program->functions.push_back(std::move(closureFunction));
+  }
+  program->main = functions.at(inProgram.getMain());
+
+  /* Bodies are bound once every function exists, so calls in any order
+   * capture their callee directly */
+  for (size_t i = 0; i < inProgram.getFunctions().size(); ++i) {
+    program->functions[i]->body =
+        compileBlock(*inProgram.getFunctions()[i]->getBlock());
+  }
+  return Completion::Normal;
+}
+
+ExpressionClosure
+ClosureCompiler::compileExpression(const Expression &inExpression) {
+  inExpression.accept(*this);
+  return std::move(expression);
+}
+
+ConditionClosure
+ClosureCompiler::compileCondition(const Expression &inCondition,
+                                  bool bRequireBool) {
+  /* || and && over bools test their operands in turn and comparisons yield
+   * their outcome, without building the intermediate values */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isBoolLogical()) {
+    ConditionClosure lhs =
+        compileCondition(*binaryExpression->getLhs(), bRequireBool);
+    ConditionClosure rhs =
+        compileCondition(*binaryExpression->getRhs(), bRequireBool);
+    if (binaryExpression->getOperator() == Expression::Operator::LogicalOr)
+      return [lhs = std::move(lhs), rhs = std::move(rhs)](
+                 ClosureState &inState) { return lhs(inState) || rhs(inState); };
+    return [lhs = std::move(lhs), rhs = std::move(rhs)](
+               ClosureState &inState) { return lhs(inState) && rhs(inState); };
+  }
+
+  if (binaryExpression && binaryExpression->isComparison()) {
+    using Op = Expression::Operator;
+    ExpressionClosure lhs = compileExpression(*binaryExpression->getLhs());
+    ExpressionClosure rhs = compileExpression(*binaryExpression->getRhs());
+    switch (binaryExpression->getOperator()) {
+    case Op::Less:
+      return bindComparison<Op::Less>(*binaryExpression, std::move(lhs),
+                                      std::move(rhs));
+    case Op::LessEqual:
+      return bindComparison<Op::LessEqual>(*binaryExpression, std::move(lhs),
+                                           std::move(rhs));
+    case Op::More:
+      return bindComparison<Op::More>(*binaryExpression, std::move(lhs),
+                                      std::move(rhs));
+    case Op::MoreEqual:
+      return bindComparison<Op::MoreEqual>(*binaryExpression, std::move(lhs),
+                                           std::move(rhs));
+    case Op::Equal:
+      return bindComparison<Op::Equal>(*binaryExpression, std::move(lhs),
+                                       std::move(rhs));
+    default:
+      return bindComparison<Op::NotEqual>(*binaryExpression, std::move(lhs),
+                                          std::move(rhs));
+    }
+  }
+
+  ExpressionClosure value = compileExpression(inCondition);
+  if (!bRequireBool)
+    return [value = std::move(value)](ClosureState &inState) {
+      return ValueOperations::isTrue(value(inState));
+    };
+  return [value = std::move(value)](ClosureState &inState) {
+    RuntimeValue result = value(inState);
+    if (result.getType() != RuntimeValue::Type::Bool)
+      throw InterpreterError("Invalid expression type in while!");
+    return result.getBool();
+  };
+}
+
+StatementClosure ClosureCompiler::compileBlock(const Block &inBlock) {
+  inBlock.accept(*this);
+  return std::move(statement);
+}
+
+Completion ClosureCompiler::visit(const BinaryExpression &inBinaryExpression) {
+  using Op = Expression::Operator;
+  ExpressionClosure lhs = compileExpression(*inBinaryExpression.getLhs());
+  ExpressionClosure rhs = compileExpression(*inBinaryExpression.getRhs());
+  const RuntimeValue::Type type = inBinaryExpression.getOperandType();
+  switch (inBinaryExpression.getOperator()) {
+  case Op::Sum:
+    expression = bindBinary<Op::Sum>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Substraction:
+    expression =
+        bindBinary<Op::Substraction>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Multiplication:
+    expression =
+        bindBinary<Op::Multiplication>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Division:
+    expression = bindBinary<Op::Division>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Modulo:
+    expression = bindBinary<Op::Modulo>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::LogicalOr:
+    expression =
+        bindLogical<Op::LogicalOr>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::LogicalAnd:
+    expression =
+        bindLogical<Op::LogicalAnd>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Less:
+    expression = bindBinary<Op::Less>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::LessEqual:
+    expression =
+        bindBinary<Op::LessEqual>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::More:
+    expression = bindBinary<Op::More>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::MoreEqual:
+    expression =
+        bindBinary<Op::MoreEqual>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::Equal:
+    expression = bindBinary<Op::Equal>(std::move(lhs), std::move(rhs), type);
+    break;
+  case Op::NotEqual:
+    expression = bindBinary<Op::NotEqual>(std::move(lhs), std::move(rhs), type);
+    break;
+  default:
+    throw InterpreterError("Invalid binary operator!");
+  }
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const Block &inBlock) {
+  std::vector<StatementClosure> instructions;
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+    instructions.push_back(std::move(statement));
+  }
+
+  if (instructions.empty())
+    statement = [](ClosureState &) { return Completion::Normal; };
+  else if (instructions.size() == 1)
+    statement = std::move(instructions.front());
+  else
+    statement = [instructions =
+                     std::move(instructions)](ClosureState &inState) {
+      for (const auto &instruction : instructions) {
+        if (instruction(inState) == Completion::Return)
+          return Completion::Return;
+      }
+      return Completion::Normal;
+    };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const Case &inCase) {
+  statement = compileBlock(*inCase.getBlock());
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const Function &inFunction) {
+  /* Arguments are evaluated straight into the callee frame */
+  expression = [function = functions.at(&inFunction),
+                arguments = std::move(callArguments)](ClosureState &inState) {
+    size_t frame = inState.allocateFrame(*function);
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      inState.setArgument(*function, frame, i, arguments[i](inState));
+    }
+    return inState.call(*function, frame);
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  ExpressionClosure call =
+      compileCall(*static_cast<const InstructionFunctionCall *>(
+          inFunctionCallExpression.getFunctionCall()));
+  expression = [call = std::move(call)](ClosureState &inState) {
+    RuntimeValue value = call(inState);
+    if (value.getType() == RuntimeValue::Type::Void)
+      throw InterpreterError("FunctionCallExpression has to return value");
+    return value;
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const IfElse &inIfElse) {
+  ConditionClosure condition =
+      compileCondition(*inIfElse.getExpression(), false);
+  StatementClosure blockIf = compileBlock(*inIfElse.getBlockIf());
+  if (!inIfElse.getBlockElse()) {
+    statement = [condition = std::move(condition),
+                 blockIf = std::move(blockIf)](ClosureState &inState) {
+      if (condition(inState))
+        return blockIf(inState);
+      return Completion::Normal;
+    };
+    return Completion::Normal;
+  }
+
+  statement = [condition = std::move(condition), blockIf = std::move(blockIf),
+               blockElse = compileBlock(*inIfElse.getBlockElse())](
+                  ClosureState &inState) {
+    if (condition(inState))
+      return blockIf(inState);
+    return blockElse(inState);
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const InstructionAssigment &inAssigment) {
+  statement = [name = inAssigment.getVariable()->toString(),
+               slot = inAssigment.getVariable()->getSlot(),
+               value = compileExpression(*inAssigment.getExpression())](
+                  ClosureState &inState) {
+    uint8_t state = inState.localStates[inState.frameBase + slot];
+    if (!(state & ClosureState::Declared))
+      throw InterpreterError("Variable " + name + " is not declared!");
+    if (!(state & ClosureState::Mutable))
+      throw InterpreterError("Not mutable variable " + name +
+                             " cannot be modified!");
+
+    RuntimeValue result = value(inState);
+    inState.locals[inState.frameBase + slot] = std::move(result);
+    return Completion::Normal;
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  ExpressionClosure value;
+  if (inDeclarationVariable.getExpression())
+    value = compileExpression(*inDeclarationVariable.getExpression());
+  else
+    value = [](ClosureState &) { return RuntimeValue(0); };
+
+  statement = [name = inDeclarationVariable.getIdentifier(),
+               slot = inDeclarationVariable.getSlot(),
+               declaredState = static_cast<uint8_t>(
+                   ClosureState::Declared |
+                   (inDeclarationVariable.isMutable() ? ClosureState::Mutable
+                                                      : 0)),
+               value = std::move(value)](ClosureState &inState) {
+    if (inState.localStates[inState.frameBase + slot] !=
+        ClosureState::Undeclared)
+      throw InterpreterError("New declaration of local variable named " +
+                             name + " found!");
+
+    RuntimeValue result = value(inState);
+    inState.locals[inState.frameBase + slot] = std::move(result);
+    inState.localStates[inState.frameBase + slot] = declaredState;
+    return Completion::Normal;
+  };
+  return Completion::Normal;
+}
+
+Completion
+ClosureCompiler::visit(const InstructionFunctionCall &inFunctionCall) {
+  statement = [call = compileCall(inFunctionCall)](ClosureState &inState) {
+    call(inState);
+    return Completion::Normal;
+  };
+  return Completion::Normal;
+}
+
+ExpressionClosure
+ClosureCompiler::compileCall(const InstructionFunctionCall &inFunctionCall) {
+  /* Calls the interpreter would reject only fail once they are reached */
+  const std::string &name = inFunctionCall.getFunctionName();
+  auto function = context.findFunction(name);
+  if (function == nullptr)
+    return bindThrow("No function found with such name: " + name + "!");
+  const auto &arguments = inFunctionCall.getExpressions();
+  if (function->getArguments().size() != arguments.size())
+    return bindThrow("Invalid number of arguments for function " + name + "!");
+
+  std::vector<ExpressionClosure> compiledArguments;
+  for (const auto &argument : arguments) {
+    compiledArguments.push_back(compileExpression(*argument));
+  }
+  callArguments = std::move(compiledArguments);
+  function->accept(*this);
+  return std::move(expression);
+}
+
+Completion ClosureCompiler::visit(const IntFunction &inIntFunction) {
+  expression = [argument = std::move(callArguments[0])](ClosureState &inState) {
+    return ValueOperations::toInt(argument(inState));
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const StringFunction &inStringFunction) {
+  expression = [argument = std::move(callArguments[0])](ClosureState &inState) {
+    return ValueOperations::toString(argument(inState));
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const FloatFunction &inFloatFunction) {
+  expression = [argument = std::move(callArguments[0])](ClosureState &inState) {
+    return ValueOperations::toFloat(argument(inState));
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const BoolFunction &inBoolFunction) {
+  expression = [argument = std::move(callArguments[0])](ClosureState &inState) {
+    return ValueOperations::toBool(argument(inState));
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const PrintFunction &inPrintFunction) {
+  expression = [argument = std::move(callArguments[0])](ClosureState &inState) {
+    ValueOperations::print(argument(inState));
+    return RuntimeValue();
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const InstructionReturn &inReturn) {
+  if (!inReturn.getExpression()) {
+    statement = [](ClosureState &inState) {
+      inState.returnValue = RuntimeValue();
+      return Completion::Return;
+    };
+    return Completion::Normal;
+  }
+
+  /* A returned call to a function of the program reuses the frame of the
+   * caller, ClosureState::call runs it once this function has returned */
+  if (auto *callExpression = dynamic_cast<const FunctionCallExpression *>(
+          inReturn.getExpression())) {
+    const auto &call = *static_cast<const InstructionFunctionCall *>(
+        callExpression->getFunctionCall());
+    auto function = functions.find(context.findFunction(call.getFunctionName()));
+    const auto &arguments = call.getExpressions();
+    if (function != functions.end() &&
+        function->second->parameters.size() == arguments.size()) {
+      std::vector<ExpressionClosure> compiledArguments;
+      for (const auto &argument : arguments) {
+        compiledArguments.push_back(compileExpression(*argument));
+      }
+      statement = [function = function->second,
+                   arguments = std::move(compiledArguments)](
+                      ClosureState &inState) {
+        size_t frame = inState.allocateFrame(*function);
+        for (size_t i = 0; i < arguments.size(); ++i) {
+          inState.setArgument(*function, frame, i, arguments[i](inState));
+        }
+        inState.replaceFrame(frame);
+        inState.tailCallee = function;
+        return Completion::Return;
+      };
+      return Completion::Normal;
+    }
+  }
+
+  statement = [value = compileExpression(*inReturn.getExpression())](
+                  ClosureState &inState) {
+    inState.returnValue = value(inState);
+    return Completion::Return;
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const Match &inMatch) {
+  std::vector<std::pair<ExpressionClosure, StatementClosure>> cases;
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    ExpressionClosure caseValue =
+        compileExpression(*caseInstruction->getExpression());
+    caseInstruction->accept(*this);
+    cases.emplace_back(std::move(caseValue), std::move(statement));
+  }
+
+  /* '_' inside the cases reads the subject from its hidden slot */
+  if (const MatchDispatch *dispatch = inMatch.getDispatch()) {
+    std::vector<StatementClosure> blocks;
+    for (auto &[caseValue, block] : cases) {
+      blocks.push_back(std::move(block));
+    }
+    statement = [subject = compileExpression(*inMatch.getExpression()),
+                 slot = inMatch.getSlot(), dispatch = *dispatch,
+                 blocks = std::move(blocks)](ClosureState &inState) {
+      RuntimeValue value = subject(inState);
+      size_t index = dispatch.find(value);
+      inState.locals[inState.frameBase + slot] = std::move(value);
+      inState.localStates[inState.frameBase + slot] = ClosureState::Declared;
+      if (index == MatchDispatch::NoCase)
+        return Completion::Normal;
+      return blocks[index](inState);
+    };
+    return Completion::Normal;
+  }
+
+  statement = [subject = compileExpression(*inMatch.getExpression()),
+               slot = inMatch.getSlot(),
+               cases = std::move(cases)](ClosureState &inState) {
+    RuntimeValue value = subject(inState);
+    inState.locals[inState.frameBase + slot] = std::move(value);
+    inState.localStates[inState.frameBase + slot] = ClosureState::Declared;
+
+    for (const auto &[caseValue, block] : cases) {
+      RuntimeValue result = caseValue(inState);
+      if (ValueOperations::matchesCase(
+              inState.locals[inState.frameBase + slot], result))
+        return block(inState);
+    }
+    return Completion::Normal;
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const UnaryExpression &inUnaryExpression) {
+  ExpressionClosure operand =
+      compileExpression(*inUnaryExpression.getExpression());
+  switch (inUnaryExpression.getOperandType()) {
+  case RuntimeValue::Type::Int:
+    expression = [operand = std::move(operand)](ClosureState &inState) {
+      return RuntimeValue(-operand(inState).getInt());
+    };
+    break;
+  case RuntimeValue::Type::Float:
+    expression = [operand = std::move(operand)](ClosureState &inState) {
+      return RuntimeValue(-operand(inState).getFloat());
+    };
+    break;
+  default:
+    expression = [operand = std::move(operand)](ClosureState &inState) {
+      return ValueOperations::unaryOperation(operand(inState));
+    };
+  }
+  return Completion::Normal;
+}
+
+Completion
+ClosureCompiler::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  if (const auto &value = variable->getValue()) {
+    expression = [constant = value->getRuntimeValue()](ClosureState &) {
+      return constant;
+    };
+    return Completion::Normal;
+  }
+
+  expression = [name = *variable->getName(),
+                slot = variable->getSlot()](ClosureState &inState) {
+    size_t index = inState.frameBase + slot;
+    if (!(inState.localStates[index] & ClosureState::Declared))
+      throw InterpreterError("No variable with such name " + name + "!");
+    return inState.locals[index];
+  };
+  return Completion::Normal;
+}
+
+Completion ClosureCompiler::visit(const While &inWhile) {
+  statement = [condition = compileCondition(*inWhile.getExpression(), true),
+               body = compileBlock(*inWhile.getBody())](ClosureState &inState) {
+    while (condition(inState)) {
+      if (body(inState) == Completion::Return)
+        return Completion::Return;
+    }
+    return Completion::Normal;
+  };
+  return Completion::Normal;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "../interpreter/VisitorInterpreter.h"
+#include "Closure.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/* Walks the AST once and binds every node into a closure that captures its
+ * children and resolved frame slots. Operators and builtins are picked when
+ * the closure is built, so running the program involves neither accept nor
+ * a switch over the operator. */
+class ClosureCompiler : public VisitorInterpreter {
+public:
+  ClosureCompiler() = default;
+  std::unique_ptr<ClosureProgram> compile(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  ExpressionClosure compileExpression(const class Expression &inExpression);
+  StatementClosure compileBlock(const class Block &inBlock);
+  /* Truth of a condition, which has to be a bool with bRequireBool */
+  ConditionClosure compileCondition(const class Expression &inCondition,
+                                    bool bRequireBool);
+  ExpressionClosure compileCall(const class InstructionFunctionCall &inFunctionCall);
+
+  Context context;
+  std::unique_ptr<ClosureProgram> program;
+  std::unordered_map<const class Function *, const ClosureFunction *>
+      functions;
+  /* Closure built by the last visit */
+  ExpressionClosure expression;
+  StatementClosure statement;
+  /* Arguments of the call being compiled */
+  std::vector<ExpressionClosure> callArguments;
+};
@@ -0,0 +1,32 @@
+#include "ClosureInterpreter.h"
+#include "../lexer/Lexer.h"
+#include "../parser/Parser.h"
+#include "ClosureCompiler.h"
+#include "../interpreter/NativeStack.h"
+
+ClosureInterpreter::ClosureInterpreter(std::unique_ptr<Parser> inParser)
+    : parser(std::move(inParser)) {}
+
+std::optional<ValueType> ClosureInterpreter::execute() {
+  if (!program) {
+    ClosureCompiler compiler;
+    program = compiler.compile(*parser->parseProgram());
+  }
+
+  state = ClosureState();
+  state.locals.reserve(4096);
+  state.localStates.reserve(4096);
+  state.maxDepth = maxCallDepth;
+
+  /* Parameters of main default to 0 */
+  const ClosureFunction &main = *program->main;
+  size_t frame = state.allocateFrame(main);
+  for (size_t i = 0; i < main.parameters.size(); ++i) {
+    state.setArgument(main, frame, i, RuntimeValue(0));
+  }
+  RuntimeValue result;
+  NativeStack::run([&]() { result = state.call(main, frame); });
+  if (result.getType() == RuntimeValue::Type::Void)
+    return std::nullopt;
+  return result.toValueType();
+}
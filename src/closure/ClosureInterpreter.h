@@ -0,0 +1,16 @@
+#pragma once
+#include "../interpreter/Interpreter.h"
+#include "Closure.h"
+#include <memory>
+
+/* Runs the closure tree built by ClosureCompiler */
+class ClosureInterpreter : public Interpreter {
+public:
+  explicit ClosureInterpreter(std::unique_ptr<class Parser> inParser);
+  virtual std::optional<ValueType> execute() override;
+
+private:
+  std::unique_ptr<Parser> parser;
+  std::unique_ptr<ClosureProgram> program;
+  ClosureState state;
+};
@@ -15,6 +15,24 @@ const Expression *BinaryExpression::getLhs() const { return lhs.get(); }
 
 const Expression::Operator BinaryExpression::getOperator() const { return op; }
 
-std::optional<ValueType> BinaryExpression::accept(VisitorInterpreter &inVisitor) const {
+bool BinaryExpression::isLogical() const {
+  return op == Operator::LogicalOr || op == Operator::LogicalAnd;
+}
+
+bool BinaryExpression::isBoolLogical() const {
+  return isLogical() && operandType == RuntimeValue::Type::Bool;
+}
+
+bool BinaryExpression::isComparison() const {
+  return op >= Operator::Less && op <= Operator::NotEqual;
+}
+
+void BinaryExpression::setOperandType(RuntimeValue::Type inType) const {
+  operandType = inType;
+}
+
+RuntimeValue::Type BinaryExpression::getOperandType() const { return operandType; }
+
+Completion BinaryExpression::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -12,10 +12,24 @@ public:
   const Expression *getRhs() const;
   const Expression *getLhs() const;
   const Operator getOperator() const;
-  virtual std::optional<ValueType> accept(VisitorInterpreter &inVisitor) const override;
+  /* || and &&, whose right operand only runs when the left one does not
+   * decide the result */
+  bool isLogical() const;
+  /* A logical operator over bools, which compiles to branches between the
+   * conditions of its operands */
+  bool isBoolLogical() const;
+  /* <, <=, >, >=, == and !=, which always yield a bool or fail, so a
+   * condition can branch on them directly */
+  bool isComparison() const;
+  /* Type of every operand when it is known statically, Void otherwise,
+   * assigned by TypeInference */
+  void setOperandType(RuntimeValue::Type inType) const;
+  RuntimeValue::Type getOperandType() const;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> rhs;
   std::unique_ptr<Expression> lhs;
   Operator op;
+  mutable RuntimeValue::Type operandType = RuntimeValue::Type::Void;
 };
@@ -4,6 +4,11 @@ void Block::addInstruction(std::unique_ptr<Instruction> inInstruction) {
   instructions.emplace_back(std::move(inInstruction));
 }
 
+void Block::insertInstruction(size_t inIndex,
+                              std::unique_ptr<Instruction> inInstruction) {
+  instructions.insert(instructions.begin() + inIndex, std::move(inInstruction));
+}
+
 std::string Block::toString() const {
   std::string result = "{";
   for (auto &instruction : instructions) {
@@ -18,6 +23,6 @@ Block::getInstructions() const {
   return instructions;
 }
 
-std::optional<ValueType> Block::accept(VisitorInterpreter &inVisitor) const {
+Completion Block::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -9,9 +9,11 @@ class Block {
 public:
   Block() = default;
   void addInstruction(std::unique_ptr<Instruction> inInstruction);
+  void insertInstruction(size_t inIndex,
+                         std::unique_ptr<Instruction> inInstruction);
   std::string toString() const;
   const std::vector<std::unique_ptr<Instruction>>& getInstructions() const;
-  virtual std::optional<ValueType> accept(VisitorInterpreter &inVisitor) const;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const;
 
 private:
   std::vector<std::unique_ptr<Instruction>> instructions;
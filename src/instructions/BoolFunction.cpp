@@ -2,7 +2,6 @@
 
 BoolFunction::BoolFunction() : Function("bool") {}
 
-std::optional<ValueType>
-BoolFunction::accept(VisitorInterpreter &inVisitor) const {
+Completion BoolFunction::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
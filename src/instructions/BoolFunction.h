@@ -3,6 +3,5 @@
 class BoolFunction : public Function {
 public:
   BoolFunction();
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 };
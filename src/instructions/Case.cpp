@@ -12,6 +12,6 @@ const Expression *Case::getExpression() const { return expression.get(); }
 
 const Block *Case::getBlock() const { return block.get(); }
 
-std::optional<ValueType> Case::accept(VisitorInterpreter &inVisitor) const {
+Completion Case::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -12,7 +12,7 @@ public:
 
   const Expression* getExpression() const;
   const Block *getBlock() const;
-  virtual std::optional<ValueType> accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> expression;
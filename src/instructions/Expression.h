@@ -26,9 +26,8 @@ public:
 
   virtual ~Expression() = default;
   virtual std::string toString() const = 0;
-  virtual std::optional<ValueType>
-  accept(class VisitorInterpreter &inVisitor) const = 0;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const = 0;
 
 protected:
   static std::unordered_map<Operator, std::string> tokenMap;
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 FloatFunction::FloatFunction() : Function("float") {}
 
-std::optional<ValueType>
-FloatFunction::accept(VisitorInterpreter &inVisitor) const {
+Completion FloatFunction::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
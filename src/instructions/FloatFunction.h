@@ -3,6 +3,5 @@
 class FloatFunction : public Function {
 public:
   FloatFunction();
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 };
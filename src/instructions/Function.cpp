@@ -24,6 +24,18 @@ const std::vector<std::unique_ptr<ParameterDefinition>>& Function::getArguments(
   return arguments;
 }
 
+void Function::setSlotCount(size_t inSlotCount) const {
+  slotCount = inSlotCount;
+}
+
+size_t Function::getSlotCount() const { return slotCount; }
+
+void Function::setMemoized(bool bInIsMemoized) const {
+  bIsMemoized = bInIsMemoized;
+}
+
+bool Function::isMemoized() const { return bIsMemoized; }
+
 std::string Function::toString() const {
   std::string result = "fn " + identifier + "(";
   for (auto &argument : arguments) {
@@ -35,6 +47,6 @@ std::string Function::toString() const {
   return result;
 }
 
-std::optional<ValueType> Function::accept(VisitorInterpreter &inVisitor) const {
+Completion Function::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
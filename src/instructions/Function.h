@@ -18,8 +18,15 @@ public:
   const std::string &getIdentifier() const;
   Block *getBlock() const;
   const std::vector<std::unique_ptr<ParameterDefinition>>& getArguments() const;
+  /* Number of frame slots, parameters first, assigned by Resolver */
+  void setSlotCount(size_t inSlotCount) const;
+  size_t getSlotCount() const;
+  /* Set by PurityAnalysis for pure recursive functions whose results the
+   * tree walker caches */
+  void setMemoized(bool bInIsMemoized) const;
+  bool isMemoized() const;
   std::string toString() const;
-  virtual std::optional<ValueType> accept(VisitorInterpreter &inVisitor) const;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const;
 
 protected:
   std::string identifier;
@@ -27,4 +34,6 @@ protected:
 private:
   std::vector<std::unique_ptr<ParameterDefinition>> arguments;
   std::unique_ptr<Block> body;
+  mutable size_t slotCount = 0;
+  mutable bool bIsMemoized = false;
 };
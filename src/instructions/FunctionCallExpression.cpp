@@ -12,6 +12,6 @@ const Instruction *FunctionCallExpression::getFunctionCall() const {
   return functionCall.get();
 }
 
-std::optional<ValueType> FunctionCallExpression::accept(VisitorInterpreter &inVisitor) const {
+Completion FunctionCallExpression::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -8,8 +8,7 @@ public:
   explicit FunctionCallExpression(std::unique_ptr<Instruction> inFunctionCall);
   virtual std::string toString() const;
   const Instruction *getFunctionCall() const;
-  virtual std::optional<ValueType>
-  accept(class VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Instruction> functionCall;
@@ -22,6 +22,6 @@ const Block *IfElse::getBlockIf() const { return blockIf.get(); }
 
 const Block *IfElse::getBlockElse() const { return blockElse.get(); }
 
-std::optional<ValueType> IfElse::accept(VisitorInterpreter &inVisitor) const {
+Completion IfElse::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
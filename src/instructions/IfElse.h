@@ -14,8 +14,7 @@ public:
   const Expression *getExpression() const;
   const Block *getBlockIf() const;
   const Block *getBlockElse() const;
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> expression;
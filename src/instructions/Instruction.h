@@ -7,6 +7,5 @@ public:
   Instruction() = default;
   virtual ~Instruction() = default;
   virtual std::string toString() const = 0;
-  virtual std::optional<ValueType>
-  accept(class VisitorInterpreter &inVisitor) const = 0;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const = 0;
 };
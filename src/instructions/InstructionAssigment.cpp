@@ -19,6 +19,6 @@ const Expression *InstructionAssigment::getExpression() const {
   return expression.get();
 }
 
-std::optional<ValueType> InstructionAssigment::accept(VisitorInterpreter &inVisitor) const {
+Completion InstructionAssigment::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
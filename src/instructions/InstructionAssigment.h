@@ -11,7 +11,7 @@ public:
   std::string toString() const;
   const Variable *getVariable() const;
   const Expression *getExpression() const;
-  virtual std::optional<ValueType> accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Variable> variable;
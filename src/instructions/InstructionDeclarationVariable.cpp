@@ -29,6 +29,12 @@ Expression *InstructionDeclarationVariable::getExpression() const {
   return expression.get();
 }
 
-std::optional<ValueType> InstructionDeclarationVariable::accept(VisitorInterpreter &inVisitor) const {
+void InstructionDeclarationVariable::setSlot(size_t inSlot) const {
+  slot = inSlot;
+}
+
+size_t InstructionDeclarationVariable::getSlot() const { return slot; }
+
+Completion InstructionDeclarationVariable::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
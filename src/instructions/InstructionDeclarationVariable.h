@@ -14,11 +14,14 @@ public:
   std::string toString() const;
   bool isMutable() const;
   Expression *getExpression() const;
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  /* Frame slot of the declared variable, assigned by Resolver */
+  void setSlot(size_t inSlot) const;
+  size_t getSlot() const;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::string identifier;
   bool bIsMutable;
   std::unique_ptr<Expression> expression;
+  mutable size_t slot = 0;
 };
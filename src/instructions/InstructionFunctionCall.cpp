@@ -34,6 +34,6 @@ InstructionFunctionCall::getExpressions() const {
   return expressions;
 }
 
-std::optional<ValueType> InstructionFunctionCall::accept(VisitorInterpreter &inVisitor) const {
+Completion InstructionFunctionCall::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -13,8 +13,7 @@ public:
   std::string toString() const;
   const std::string &getFunctionName() const;
   const std::vector<std::unique_ptr<Expression>> &getExpressions() const;
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::string name;
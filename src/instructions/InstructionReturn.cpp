@@ -17,6 +17,6 @@ const Expression *InstructionReturn::getExpression() const {
   return expression.get();
 }
 
-std::optional<ValueType> InstructionReturn::accept(VisitorInterpreter &inVisitor) const {
+Completion InstructionReturn::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -8,8 +8,7 @@ public:
   explicit InstructionReturn(std::unique_ptr<Expression> inExpression = nullptr);
   std::string toString() const;
   const Expression *getExpression() const;
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> expression;
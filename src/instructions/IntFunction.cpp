@@ -2,7 +2,6 @@
 
 IntFunction::IntFunction() : Function("int") {}
 
-std::optional<ValueType>
-IntFunction::accept(VisitorInterpreter &inVisitor) const {
+Completion IntFunction::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
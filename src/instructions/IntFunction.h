@@ -3,6 +3,5 @@
 class IntFunction : public Function {
 public:
   IntFunction();
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 };
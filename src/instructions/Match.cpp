@@ -23,6 +23,16 @@ const std::vector<std::unique_ptr<Case>> &Match::getCases() const {
 
 const Expression *Match::getExpression() const { return expression.get(); }
 
-std::optional<ValueType> Match::accept(VisitorInterpreter &inVisitor) const {
+void Match::setSlot(size_t inSlot) const { slot = inSlot; }
+
+size_t Match::getSlot() const { return slot; }
+
+void Match::setDispatch(std::unique_ptr<MatchDispatch> inDispatch) const {
+  dispatch = std::move(inDispatch);
+}
+
+const MatchDispatch *Match::getDispatch() const { return dispatch.get(); }
+
+Completion Match::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
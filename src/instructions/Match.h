@@ -1,6 +1,7 @@
 #pragma once
 #include "Instruction.h"
 #include "Case.h"
+#include "../interpreter/MatchDispatch.h"
 #include <memory>
 #include <vector>
 
@@ -13,10 +14,19 @@ public:
   std::string toString() const;
   const std::vector<std::unique_ptr<Case>> &getCases() const;
   const Expression *getExpression() const;
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  /* Hidden frame slot holding the subject that '_' reads, assigned by
+   * Resolver */
+  void setSlot(size_t inSlot) const;
+  size_t getSlot() const;
+  /* Case lookup built by Resolver, nullptr when the cases have to be
+   * evaluated in order */
+  void setDispatch(std::unique_ptr<MatchDispatch> inDispatch) const;
+  const MatchDispatch *getDispatch() const;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 
 private:
   std::vector<std::unique_ptr<Case>> cases;
   std::unique_ptr<Expression> expression;
+  mutable size_t slot = 0;
+  mutable std::unique_ptr<MatchDispatch> dispatch;
 };
@@ -2,7 +2,6 @@
 
 PrintFunction::PrintFunction() : Function("print") {}
 
-std::optional<ValueType>
-PrintFunction::accept(VisitorInterpreter &inVisitor) const {
+Completion PrintFunction::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
@@ -3,6 +3,5 @@
 class PrintFunction : public Function {
 public:
   PrintFunction();
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 };
@@ -1,5 +1,6 @@
 #include "Program.h"
 #include "../interpreter/InterpreterError.h"
+#include <algorithm>
 #include <stdexcept>
 
 Function *Program::getMain() const {
@@ -18,6 +19,14 @@ void Program::addFunction(std::unique_ptr<Function> inFunction) {
   functions.push_back(std::move(inFunction));
 }
 
+void Program::removeFunction(const Function *inFunction) {
+  auto pred = [inFunction](const std::unique_ptr<Function> &function) {
+    return function.get() == inFunction;
+  };
+  functions.erase(std::remove_if(functions.begin(), functions.end(), pred),
+                  functions.end());
+}
+
 std::string Program::toString() const {
   std::string result = "";
   for (auto &function : functions) {
@@ -30,6 +39,6 @@ const std::vector<std::unique_ptr<Function>> &Program::getFunctions() const {
   return functions;
 }
 
-std::optional<ValueType> Program::accept(VisitorInterpreter &inVisitor) const {
+Completion Program::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
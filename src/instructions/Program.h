@@ -10,9 +10,10 @@ public:
   Program() = default;
   Function *getMain() const;
   void addFunction(std::unique_ptr<Function> inFunction);
+  void removeFunction(const Function *inFunction);
   std::string toString() const;
   const std::vector<std::unique_ptr<Function>> &getFunctions() const;
-  virtual std::optional<ValueType> accept(class VisitorInterpreter &inVisitor) const;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const;
 
 private:
   std::vector<std::unique_ptr<Function>> functions;
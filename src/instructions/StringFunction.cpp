@@ -2,7 +2,6 @@
 
 StringFunction::StringFunction() : Function("string") {}
 
-std::optional<ValueType>
-StringFunction::accept(VisitorInterpreter &inVisitor) const {
+Completion StringFunction::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
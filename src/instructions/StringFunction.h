@@ -3,6 +3,5 @@
 class StringFunction : public Function {
 public:
   StringFunction();
-  virtual std::optional<ValueType>
-  accept(VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(VisitorInterpreter &inVisitor) const override;
 };
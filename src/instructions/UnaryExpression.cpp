@@ -14,6 +14,14 @@ const Expression *UnaryExpression::getExpression() const {
 
 Expression::Operator UnaryExpression::getOperator() const { return op; }
 
-std::optional<ValueType> UnaryExpression::accept(VisitorInterpreter &inVisitor) const {
+void UnaryExpression::setOperandType(RuntimeValue::Type inType) const {
+  operandType = inType;
+}
+
+RuntimeValue::Type UnaryExpression::getOperandType() const {
+  return operandType;
+}
+
+Completion UnaryExpression::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
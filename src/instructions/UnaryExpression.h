@@ -7,9 +7,14 @@ public:
   virtual std::string toString() const;
   const Expression *getExpression() const;
   Operator getOperator() const;
-  virtual std::optional<ValueType> accept(class VisitorInterpreter &inVisitor) const override;
+  /* Type of every operand when it is known statically, Void otherwise,
+   * assigned by TypeInference */
+  void setOperandType(RuntimeValue::Type inType) const;
+  RuntimeValue::Type getOperandType() const;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> expression;
   Operator op;
+  mutable RuntimeValue::Type operandType = RuntimeValue::Type::Void;
 };
@@ -2,7 +2,8 @@
 
 Value::Value(Token::Type inType,
              std::variant<std::string, float, int, bool> inValue)
-    : type(inType), value(std::move(inValue)) {}
+    : type(inType), value(std::move(inValue)),
+      runtimeValue(ValueType(value, type)) {}
 
 const std::variant<std::string, float, int, bool> &Value::getValue() const {
   return value;
@@ -10,6 +11,8 @@ const std::variant<std::string, float, int, bool> &Value::getValue() const {
 
 Token::Type Value::getType() const { return type; }
 
+const RuntimeValue &Value::getRuntimeValue() const { return runtimeValue; }
+
 std::string Value::toString() const {
   if (type == Token::Type::StringLiteral)
     return "\"" + std::get<std::string>(value) + "\"";
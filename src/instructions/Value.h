@@ -1,13 +1,16 @@
 #pragma once
 #include "../lexer/Token.h"
+#include "../interpreter/RuntimeValue.h"
 
 class Value {
 public:
   explicit Value(Token::Type inType, std::variant<std::string, float, int, bool> inValue);
   const std::variant<std::string, float, int, bool> &getValue() const;
   Token::Type getType() const;
+  const RuntimeValue &getRuntimeValue() const;
   std::string toString() const;
 private:
   Token::Type type;
   std::variant<std::string, float, int, bool> value;
+  RuntimeValue runtimeValue;
 };
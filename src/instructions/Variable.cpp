@@ -14,4 +14,8 @@ std::string Variable::toString() const {
 
 const std::optional<std::string> &Variable::getName() const { return name; }
 
-const Value *Variable::getValue() const { return value.get(); }
\ No newline at end of file
+const Value *Variable::getValue() const { return value.get(); }
+
+void Variable::setSlot(size_t inSlot) const { slot = inSlot; }
+
+size_t Variable::getSlot() const { return slot; }
@@ -10,8 +10,12 @@ public:
   std::string toString() const;
   const std::optional<std::string> &getName() const;
   const Value *getValue() const;
+  /* Frame slot of a named variable, assigned by Resolver */
+  void setSlot(size_t inSlot) const;
+  size_t getSlot() const;
 
 private:
   std::optional<std::string> name;
   std::unique_ptr<Value> value;
+  mutable size_t slot = 0;
 };
@@ -12,6 +12,6 @@ const Variable *VariableExpression::getVariable() const {
   return variable.get();
 }
 
-std::optional<ValueType> VariableExpression::accept(VisitorInterpreter &inVisitor) const {
+Completion VariableExpression::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
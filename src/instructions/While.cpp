@@ -15,6 +15,6 @@ const Expression *While::getExpression() const { return expression.get(); }
 
 const Block *While::getBody() const { return body.get(); }
 
-std::optional<ValueType> While::accept(VisitorInterpreter &inVisitor) const {
+Completion While::accept(VisitorInterpreter &inVisitor) const {
   return inVisitor.visit(*this);
 }
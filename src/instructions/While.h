@@ -11,8 +11,7 @@ public:
   std::string toString() const;
   const Expression *getExpression() const;
   const Block *getBody() const;
-  virtual std::optional<ValueType>
-  accept(class VisitorInterpreter &inVisitor) const override;
+  virtual Completion accept(class VisitorInterpreter &inVisitor) const override;
 
 private:
   std::unique_ptr<Expression> expression;
@@ -0,0 +1,48 @@
+#include "CallStack.h"
+#include "../instructions/Function.h"
+#include <algorithm>
+
+CallStack::CallStack(size_t inReservedSlots, size_t inReservedDepth) {
+  slots.reserve(inReservedSlots);
+  frameBases.reserve(inReservedDepth);
+}
+
+size_t CallStack::allocateFrame(const Function &inFunction) {
+  size_t frame = slots.size();
+  slots.resize(frame + inFunction.getSlotCount());
+  return frame;
+}
+
+void CallStack::pushFrame(size_t inFrame) {
+  frameBase = inFrame;
+  frameBases.push_back(frameBase);
+}
+
+void CallStack::popFrame() {
+  slots.resize(frameBases.back());
+  frameBases.pop_back();
+  frameBase = frameBases.empty() ? 0 : frameBases.back();
+}
+
+void CallStack::replaceFrame(size_t inFrame) {
+  const size_t slotCount = slots.size() - inFrame;
+  std::move(slots.begin() + inFrame, slots.end(), slots.begin() + frameBase);
+  slots.resize(frameBase + slotCount);
+}
+
+std::optional<InterpreterValue> &CallStack::getLocalVariable(size_t inSlot) {
+  return slots[frameBase + inSlot];
+}
+
+std::optional<InterpreterValue> &CallStack::getFrameSlot(size_t inFrame,
+                                                         size_t inSlot) {
+  return slots[inFrame + inSlot];
+}
+
+size_t CallStack::getDepth() const { return frameBases.size(); }
+
+void CallStack::clear() {
+  slots.clear();
+  frameBases.clear();
+  frameBase = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "InterpreterValue.h"
+#include <optional>
+#include <vector>
+
+/* Locals of all active calls stored back to back in one pre-reserved
+ * vector. Allocating a frame only grows the vector by the slot count of the
+ * called function, so calls do not allocate until the reserve is exceeded
+ * and callers' locals are never copied. A frame is allocated before its
+ * arguments are evaluated in the caller and written into its first slots,
+ * and only then pushed to become current. */
+class CallStack {
+public:
+  explicit CallStack(size_t inReservedSlots = 4096,
+                     size_t inReservedDepth = 512);
+  size_t allocateFrame(const class Function &inFunction);
+  void pushFrame(size_t inFrame);
+  void popFrame();
+  /* Moves the frame allocated at inFrame over the current one, which a tail
+   * call no longer needs */
+  void replaceFrame(size_t inFrame);
+  std::optional<InterpreterValue> &getLocalVariable(size_t inSlot);
+  std::optional<InterpreterValue> &getFrameSlot(size_t inFrame, size_t inSlot);
+  size_t getDepth() const;
+  void clear();
+
+private:
+  std::vector<std::optional<InterpreterValue>> slots;
+  std::vector<size_t> frameBases;
+  size_t frameBase = 0;
+};
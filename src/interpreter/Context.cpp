@@ -8,8 +8,9 @@
 #include "../instructions/StringFunction.h"
 #include "../instructions/BoolFunction.h"
 #include "../instructions/ParameterDefinition.h"
+#include <algorithm>
 
-Context::Context() : currentFunction(nullptr), previousFunction(nullptr) {
+Context::Context() {
   createPrintFunction();
   createIntFunction();
   createFloatFunction();
@@ -17,34 +18,26 @@ Context::Context() : currentFunction(nullptr), previousFunction(nullptr) {
   createStringFunction();
 }
 
-bool Context::containsVariableWithName(const std::string &inName) const {
-  const auto &it = localVariables.find(currentFunction)->second;
-  return it.contains(inName);
+std::optional<InterpreterValue> &Context::getLocalVariable(size_t inSlot) {
+  return callStack.getLocalVariable(inSlot);
 }
 
-std::optional<InterpreterValue>
-Context::findVariableWithName(const std::string &inName) const {
-  const auto &functionIt = localVariables.find(currentFunction)->second;
-  auto it = functionIt.find(inName);
-  if (it != functionIt.end())
-    return it->second;
-
-  return std::nullopt;
+size_t Context::allocateFrame(const Function &inFunction) {
+  return callStack.allocateFrame(inFunction);
 }
 
-void Context::insertLocalVariable(const std::string &inName,
-                                  InterpreterValue& inValue) {
-  localVariables[currentFunction].insert(
-      std::make_pair(inName, inValue));
+std::optional<InterpreterValue> &Context::getFrameSlot(size_t inFrame,
+                                                       size_t inSlot) {
+  return callStack.getFrameSlot(inFrame, inSlot);
 }
 
-void Context::replaceLocalVariable(const std::string &inName,
-                                   InterpreterValue& inValue) {
-  auto it = localVariables[currentFunction].find(inName);
-  if (it != localVariables[currentFunction].end()) {
-    it->second = inValue;
-  }
-}
+void Context::enterFrame(size_t inFrame) { callStack.pushFrame(inFrame); }
+
+void Context::leaveFrame() { callStack.popFrame(); }
+
+void Context::replaceFrame(size_t inFrame) { callStack.replaceFrame(inFrame); }
+
+size_t Context::getDepth() const { return callStack.getDepth(); }
 
 const Function *Context::findFunction(const std::string &inName) const {
   auto pred = [&inName](const Function *function) {
@@ -60,27 +53,11 @@ const Function *Context::findFunction(const std::string &inName) const {
 
 void Context::insertFunction(const Function *inFunction) {
   functionList.push_back(inFunction);
-  localVariables.insert(std::make_pair(inFunction, VariablesMap()));
-}
-
-VariablesMap Context::copyCurrentVariablesMap() {
-  auto copyOfLocalVariables = VariablesMap();
-  for (const auto &pair : localVariables[currentFunction]) {
-    copyOfLocalVariables.insert(std::make_pair(
-        pair.first, InterpreterValue(
-                        pair.second.getType(), pair.second.getValue(),
-                        pair.second.isMutable())));
-  }
-  return copyOfLocalVariables;
 }
 
 void Context::reset() {
-  previousFunction = nullptr;
-  currentFunction = nullptr;
-  matchVariableName = std::nullopt;
-  localVariables.clear();
+  callStack.clear();
   functionList.clear();
-  argList.clear();
 
   for (const auto& internalFunction : internalFunctionList) {
     functionList.emplace_back(internalFunction.get());
@@ -90,6 +67,7 @@ void Context::reset() {
 void Context::createPrintFunction() {
   auto function = std::make_unique<PrintFunction>();
   function->addArgument(std::make_unique<ParameterDefinition>("input"));
+  function->setSlotCount(1);
   functionList.emplace_back(function.get());
   internalFunctionList.emplace_back(std::move(function));
 }
@@ -97,6 +75,7 @@ void Context::createPrintFunction() {
 void Context::createIntFunction() {
   auto function = std::make_unique<IntFunction>();
   function->addArgument(std::make_unique<ParameterDefinition>("input"));
+  function->setSlotCount(1);
   functionList.emplace_back(function.get());
   internalFunctionList.emplace_back(std::move(function));
 }
@@ -104,6 +83,7 @@ void Context::createIntFunction() {
 void Context::createFloatFunction() {
   auto function = std::make_unique<FloatFunction>();
   function->addArgument(std::make_unique<ParameterDefinition>("input"));
+  function->setSlotCount(1);
   functionList.emplace_back(function.get());
   internalFunctionList.emplace_back(std::move(function));
 }
@@ -111,6 +91,7 @@ void Context::createFloatFunction() {
 void Context::createStringFunction() {
   auto function = std::make_unique<StringFunction>();
   function->addArgument(std::make_unique<ParameterDefinition>("input"));
+  function->setSlotCount(1);
   functionList.emplace_back(function.get());
   internalFunctionList.emplace_back(std::move(function));
 }
@@ -118,6 +99,7 @@ void Context::createStringFunction() {
 void Context::createBoolFunction() {
   auto function = std::make_unique<BoolFunction>();
   function->addArgument(std::make_unique<ParameterDefinition>("input"));
+  function->setSlotCount(1);
   functionList.emplace_back(function.get());
   internalFunctionList.emplace_back(std::move(function));
 }
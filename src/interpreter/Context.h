@@ -3,12 +3,9 @@
 #include <unordered_map>
 #include <memory>
 #include <optional>
+#include "CallStack.h"
 #include "InterpreterValue.h"
 
-typedef std::pair<std::variant<std::string, float, int, bool>, Token::Type> ValueType;
-typedef std::unordered_map<std::string, InterpreterValue>
-    VariablesMap;
-
 template <class... Ts> struct overload : Ts... { using Ts::operator()...; };
 template <class... Ts>
 overload(Ts...) -> overload<Ts...>;
@@ -18,15 +15,16 @@ class Context {
 public:
   friend class VisitorInterpreterImpl;
   Context();
-  bool containsVariableWithName(const std::string &inName) const;
-  std::optional<InterpreterValue> findVariableWithName(const std::string &inName) const;
-  void insertLocalVariable(const std::string &inName,
-                           InterpreterValue& inValue);
-  void replaceLocalVariable(const std::string &inName,
-                           InterpreterValue& inValue);
+  std::optional<InterpreterValue> &getLocalVariable(size_t inSlot);
+  size_t allocateFrame(const class Function &inFunction);
+  std::optional<InterpreterValue> &getFrameSlot(size_t inFrame, size_t inSlot);
+  void enterFrame(size_t inFrame);
+  void leaveFrame();
+  void replaceFrame(size_t inFrame);
+  /* Number of active calls */
+  size_t getDepth() const;
   const class Function *findFunction(const std::string &inName) const;
   void insertFunction(const class Function *inFunction);
-  VariablesMap copyCurrentVariablesMap();
   void reset();
 
 private:
@@ -36,11 +34,7 @@ private:
   void createStringFunction();
   void createBoolFunction();
 
-  std::vector<class Expression *> argList;
-  std::optional<std::string> matchVariableName;
-  const class Function *currentFunction;
-  const class Function *previousFunction;
-  std::unordered_map<const class Function *, VariablesMap> localVariables;
+  CallStack callStack;
   std::vector<const class Function *> functionList;
 
   std::vector<std::unique_ptr<class Function>> internalFunctionList;
@@ -0,0 +1,17 @@
+#include "Interpreter.h"
+#include "InterpreterError.h"
+#include <string>
+
+size_t Interpreter::getExecutedInstructionCount() const { return 0; }
+
+void Interpreter::setMaxCallDepth(size_t inMaxCallDepth) {
+  maxCallDepth = inMaxCallDepth;
+}
+
+size_t Interpreter::getMaxCallDepth() const { return maxCallDepth; }
+
+void Interpreter::checkCallDepth(size_t inDepth, size_t inMaxCallDepth) {
+  if (inDepth >= inMaxCallDepth)
+    throw InterpreterError("Maximum call depth of " +
+                           std::to_string(inMaxCallDepth) + " exceeded!");
+}
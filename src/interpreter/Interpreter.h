@@ -0,0 +1,22 @@
+#pragma once
+#include "Context.h"
+
+class Interpreter {
+public:
+  /* Calls nested deeper than this raise an InterpreterError */
+  static constexpr size_t DefaultMaxCallDepth = 1000000;
+
+  Interpreter() = default;
+  virtual ~Interpreter() = default;
+  virtual std::optional<ValueType> execute() = 0;
+  /* Number of instructions dispatched by the last execute, 0 if unknown */
+  virtual size_t getExecutedInstructionCount() const;
+  void setMaxCallDepth(size_t inMaxCallDepth);
+  size_t getMaxCallDepth() const;
+  /* Raises the error of a call made with inDepth calls active when that
+   * reaches inMaxCallDepth */
+  static void checkCallDepth(size_t inDepth, size_t inMaxCallDepth);
+
+protected:
+  size_t maxCallDepth = DefaultMaxCallDepth;
+};
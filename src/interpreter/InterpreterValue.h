@@ -1,16 +1,13 @@
 #pragma once
-#include "../lexer/Token.h"
+#include "RuntimeValue.h"
 
 class InterpreterValue {
 public:
-  InterpreterValue(
-      Token::Type inType, std::variant<std::string, float, int, bool> inValue, bool bInIsMutable);
-  const std::variant<std::string, float, int, bool> &getValue() const;
-  Token::Type getType() const;
+  InterpreterValue(RuntimeValue inValue, bool bInIsMutable);
+  const RuntimeValue &getValue() const;
   bool isMutable() const;
 
 private:
-  Token::Type type;
-  std::variant<std::string, float, int, bool> value;
+  RuntimeValue value;
   bool bIsMutable;
 };
@@ -0,0 +1,204 @@
+#include "MatchDispatch.h"
+#include "../instructions/Case.h"
+#include "../instructions/Match.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include <algorithm>
+
+/* Seeds tried for a bucket before the strings are left to linear matching */
+static constexpr uint64_t MaxSeed = 1 << 16;
+
+std::unique_ptr<MatchDispatch> MatchDispatch::build(const Match &inMatch) {
+  auto dispatch = std::make_unique<MatchDispatch>();
+  std::vector<std::pair<int, size_t>> ints;
+  std::vector<StringCase> strings;
+  const auto &cases = inMatch.getCases();
+  for (size_t i = 0; i < cases.size() && dispatch->defaultCase == NoCase;
+       ++i) {
+    auto *variableExpression =
+        dynamic_cast<const VariableExpression *>(cases[i]->getExpression());
+    const Value *value = variableExpression
+                             ? variableExpression->getVariable()->getValue()
+                             : nullptr;
+    if (!value)
+      return nullptr;
+
+    /* Cases after a true one are never taken */
+    const RuntimeValue &constant = value->getRuntimeValue();
+    switch (constant.getType()) {
+    case RuntimeValue::Type::Int:
+      ints.emplace_back(constant.getInt(), i);
+      break;
+    case RuntimeValue::Type::String:
+      strings.push_back(StringCase{constant.getString(), i});
+      break;
+    case RuntimeValue::Type::Bool:
+      if (!constant.getBool())
+        return nullptr;
+      dispatch->defaultCase = i;
+      break;
+    default:
+      return nullptr;
+    }
+  }
+
+  dispatch->buildInts(std::move(ints));
+  if (!dispatch->buildStrings(std::move(strings)))
+    return nullptr;
+  return dispatch;
+}
+
+size_t MatchDispatch::find(const RuntimeValue &inSubject) const {
+  size_t index = NoCase;
+  if (inSubject.getType() == RuntimeValue::Type::Int)
+    index = findInt(inSubject.getInt());
+  else if (inSubject.getType() == RuntimeValue::Type::String)
+    index = findString(inSubject.getString());
+  return std::min(index, defaultCase);
+}
+
+std::string MatchDispatch::toString() const {
+  std::string result;
+  if (!jumpTable.empty())
+    result += "jump table of " + std::to_string(jumpTable.size());
+  else if (!sortedInts.empty())
+    result += "bisection over " + std::to_string(sortedInts.size());
+  if (!seeds.empty())
+    result += (result.empty() ? "" : ", ") + std::string("perfect hash of ") +
+              std::to_string(slots.size());
+  if (defaultCase != NoCase)
+    result += (result.empty() ? "" : ", ") + std::string("default ") +
+              std::to_string(defaultCase);
+  return result;
+}
+
+void MatchDispatch::buildInts(std::vector<std::pair<int, size_t>> inCases) {
+  if (inCases.empty())
+    return;
+
+  /* The first of equal cases is the one taken */
+  std::stable_sort(inCases.begin(), inCases.end(),
+                   [](const auto &inLhs, const auto &inRhs) {
+                     return inLhs.first < inRhs.first;
+                   });
+  inCases.erase(std::unique(inCases.begin(), inCases.end(),
+                            [](const auto &inLhs, const auto &inRhs) {
+                              return inLhs.first == inRhs.first;
+                            }),
+                inCases.end());
+
+  const int64_t span = static_cast<int64_t>(inCases.back().first) -
+                       inCases.front().first + 1;
+  if (span > static_cast<int64_t>(JumpTableDensity * inCases.size())) {
+    sortedInts = std::move(inCases);
+    return;
+  }
+  minimum = inCases.front().first;
+  jumpTable.assign(static_cast<size_t>(span), NoCase);
+  for (const auto &[value, index] : inCases) {
+    jumpTable[static_cast<size_t>(static_cast<int64_t>(value) - minimum)] =
+        index;
+  }
+}
+
+bool MatchDispatch::buildStrings(std::vector<StringCase> inCases) {
+  if (inCases.empty())
+    return true;
+
+  std::stable_sort(inCases.begin(), inCases.end(),
+                   [](const StringCase &inLhs, const StringCase &inRhs) {
+                     return inLhs.value < inRhs.value;
+                   });
+  inCases.erase(std::unique(inCases.begin(), inCases.end(),
+                            [](const StringCase &inLhs,
+                               const StringCase &inRhs) {
+                              return inLhs.value == inRhs.value;
+                            }),
+                inCases.end());
+
+  /* Hash and displace: strings are split into buckets by the hash with seed
+   * 0, then every bucket, largest first, gets the first seed placing all its
+   * strings in free slots of a table twice their number */
+  std::vector<std::vector<StringCase *>> buckets(inCases.size());
+  for (auto &stringCase : inCases) {
+    buckets[hash(stringCase.value, 0) % buckets.size()].push_back(&stringCase);
+  }
+  std::vector<size_t> order(buckets.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&buckets](size_t inLhs, size_t inRhs) {
+                     return buckets[inLhs].size() > buckets[inRhs].size();
+                   });
+
+  seeds.assign(buckets.size(), 0);
+  slots.assign(2 * inCases.size(), StringCase{"", NoCase});
+  std::vector<size_t> placed;
+  for (size_t bucket : order) {
+    if (buckets[bucket].empty())
+      break;
+    uint64_t seed = 1;
+    for (; seed <= MaxSeed; ++seed) {
+      placed.clear();
+      for (const StringCase *stringCase : buckets[bucket]) {
+        size_t slot = hash(stringCase->value, seed) % slots.size();
+        if (slots[slot].index != NoCase ||
+            std::find(placed.begin(), placed.end(), slot) != placed.end())
+          break;
+        placed.push_back(slot);
+      }
+      if (placed.size() == buckets[bucket].size())
+        break;
+    }
+    if (seed > MaxSeed) {
+      seeds.clear();
+      slots.clear();
+      return false;
+    }
+
+    seeds[bucket] = seed;
+    for (size_t i = 0; i < placed.size(); ++i) {
+      slots[placed[i]] = *buckets[bucket][i];
+    }
+  }
+  return true;
+}
+
+size_t MatchDispatch::findInt(int inValue) const {
+  if (!jumpTable.empty()) {
+    const int64_t offset = static_cast<int64_t>(inValue) - minimum;
+    if (offset < 0 || offset >= static_cast<int64_t>(jumpTable.size()))
+      return NoCase;
+    return jumpTable[static_cast<size_t>(offset)];
+  }
+
+  auto found = std::lower_bound(
+      sortedInts.begin(), sortedInts.end(), inValue,
+      [](const auto &inCase, int inValue) { return inCase.first < inValue; });
+  if (found == sortedInts.end() || found->first != inValue)
+    return NoCase;
+  return found->second;
+}
+
+size_t MatchDispatch::findString(const std::string &inValue) const {
+  if (seeds.empty())
+    return NoCase;
+
+  const uint64_t seed = seeds[hash(inValue, 0) % seeds.size()];
+  const StringCase &slot = slots[hash(inValue, seed) % slots.size()];
+  return slot.index != NoCase && slot.value == inValue ? slot.index : NoCase;
+}
+
+uint64_t MatchDispatch::hash(const std::string &inValue, uint64_t inSeed) {
+  /* FNV-1a with the seed folded into the offset basis, finished by the
+   * MurmurHash3 mixer so every seed spreads the strings anew */
+  uint64_t result = 14695981039346656037ull ^ (inSeed * 0x9e3779b97f4a7c15ull);
+  for (unsigned char character : inValue) {
+    result ^= character;
+    result *= 1099511628211ull;
+  }
+  result ^= result >> 33;
+  result *= 0xff51afd7ed558ccdull;
+  return result ^ (result >> 33);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "RuntimeValue.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Finds the case a match takes without evaluating its cases one by one,
+ * built by Resolver for matches whose cases are all int or string literals
+ * or true. Int cases become a jump table when their values are dense and a
+ * sorted array searched by bisection otherwise, string cases a perfect hash
+ * table. A true case matches every subject, so it bounds the case found. */
+class MatchDispatch {
+public:
+  static constexpr size_t NoCase = SIZE_MAX;
+  /* Int cases spanning at most this many values per case get a jump table */
+  static constexpr size_t JumpTableDensity = 4;
+
+  /* nullptr when a case is not an int or string literal or true */
+  static std::unique_ptr<MatchDispatch> build(const class Match &inMatch);
+  /* Index of the first case matching inSubject, NoCase when none does */
+  size_t find(const RuntimeValue &inSubject) const;
+  std::string toString() const;
+
+private:
+  struct StringCase {
+    std::string value;
+    size_t index;
+  };
+
+  void buildInts(std::vector<std::pair<int, size_t>> inCases);
+  /* False when no seeds separating the strings were found */
+  bool buildStrings(std::vector<StringCase> inCases);
+  size_t findInt(int inValue) const;
+  size_t findString(const std::string &inValue) const;
+  static uint64_t hash(const std::string &inValue, uint64_t inSeed);
+
+  size_t defaultCase = NoCase;
+  int minimum = 0;
+  /* Case of every value from minimum on, when dense */
+  std::vector<size_t> jumpTable;
+  /* Sorted by value, when sparse */
+  std::vector<std::pair<int, size_t>> sortedInts;
+  /* Seed of every first level bucket, each places its strings in distinct
+   * slots */
+  std::vector<uint64_t> seeds;
+  std::vector<StringCase> slots;
+};
@@ -0,0 +1,56 @@
+#include "MemoTable.h"
+#include <cstring>
+
+MemoTable::MemoTable(size_t inCapacity) : capacity(inCapacity) {}
+
+bool MemoTable::appendKey(const RuntimeValue &inValue, Key &outKey) {
+  uint32_t payload = 0;
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::Int:
+    payload = static_cast<uint32_t>(inValue.getInt());
+    break;
+  case RuntimeValue::Type::Float: {
+    float floating = inValue.getFloat();
+    std::memcpy(&payload, &floating, sizeof(payload));
+    break;
+  }
+  case RuntimeValue::Type::Bool:
+    payload = inValue.getBool();
+    break;
+  default:
+    return false;
+  }
+  outKey.push_back(static_cast<uint64_t>(inValue.getType()) << 32 | payload);
+  return true;
+}
+
+const RuntimeValue *MemoTable::find(const Key &inKey) {
+  auto entry = index.find(inKey);
+  if (entry == index.end())
+    return nullptr;
+
+  entries.splice(entries.begin(), entries, entry->second);
+  return &entry->second->second;
+}
+
+void MemoTable::insert(const Key &inKey, const RuntimeValue &inValue) {
+  if (capacity == 0 || index.count(inKey))
+    return;
+  if (entries.size() == capacity) {
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+  entries.emplace_front(inKey, inValue);
+  index.emplace(inKey, entries.begin());
+}
+
+size_t MemoTable::getSize() const { return entries.size(); }
+
+size_t MemoTable::KeyHash::operator()(const Key &inKey) const {
+  size_t hash = inKey.size();
+  for (uint64_t part : inKey) {
+    hash ^= std::hash<uint64_t>()(part) + 0x9e3779b97f4a7c15ull + (hash << 6) +
+            (hash >> 2);
+  }
+  return hash;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "RuntimeValue.h"
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/* Results of calls of one memoized function keyed on their argument values.
+ * Holds at most the given number of results and evicts the least recently
+ * used one when full. Only int, float and bool arguments make a key, floats
+ * are compared by their bits so 0.0 and -0.0 stay apart. */
+class MemoTable {
+public:
+  typedef std::vector<uint64_t> Key;
+  static const size_t DefaultCapacity = 4096;
+
+  explicit MemoTable(size_t inCapacity = DefaultCapacity);
+  /* Appends inValue to outKey, false when it is not a scalar */
+  static bool appendKey(const RuntimeValue &inValue, Key &outKey);
+  /* nullptr when no result is cached for inKey */
+  const RuntimeValue *find(const Key &inKey);
+  void insert(const Key &inKey, const RuntimeValue &inValue);
+  size_t getSize() const;
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key &inKey) const;
+  };
+  typedef std::list<std::pair<Key, RuntimeValue>> Entries;
+
+  size_t capacity;
+  /* Most recently used first */
+  Entries entries;
+  std::unordered_map<Key, Entries::iterator, KeyHash> index;
+};
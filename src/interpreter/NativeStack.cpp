@@ -0,0 +1,67 @@
+#include "NativeStack.h"
+#include "InterpreterError.h"
+#if TKOM_NATIVE_STACK
+#include <pthread.h>
+#endif
+
+thread_local uintptr_t NativeStack::base = 0;
+thread_local size_t NativeStack::size = 0;
+
+void NativeStack::run(const std::function<void()> &inBody) {
+#if TKOM_NATIVE_STACK
+  Task task{&inBody, nullptr};
+  pthread_attr_t attributes;
+  if (pthread_attr_init(&attributes) == 0) {
+    pthread_t thread;
+    bool bIsStarted =
+        pthread_attr_setstacksize(&attributes, SegmentSize) == 0 &&
+        pthread_create(&thread, &attributes, &NativeStack::start, &task) == 0;
+    pthread_attr_destroy(&attributes);
+    if (bIsStarted) {
+      pthread_join(thread, nullptr);
+      if (task.error)
+        std::rethrow_exception(task.error);
+      return;
+    }
+  }
+#endif
+  if (base)
+    throw InterpreterError("Native stack exhausted!");
+  runHere(FallbackSize, inBody);
+}
+
+bool NativeStack::isExhausted() {
+  char marker;
+  /* Stacks grow downwards on every supported platform */
+  return base &&
+         base - reinterpret_cast<uintptr_t>(&marker) + Margin > size;
+}
+
+uintptr_t NativeStack::getLimit() { return base ? base - size + Margin : 0; }
+
+void *NativeStack::start(void *inTask) {
+  auto *task = static_cast<Task *>(inTask);
+  try {
+    runHere(SegmentSize, *task->body);
+  } catch (...) {
+    task->error = std::current_exception();
+  }
+  return nullptr;
+}
+
+void NativeStack::runHere(size_t inSize, const std::function<void()> &inBody) {
+  char marker;
+  const uintptr_t enclosingBase = base;
+  const size_t enclosingSize = size;
+  base = reinterpret_cast<uintptr_t>(&marker);
+  size = inSize;
+  try {
+    inBody();
+  } catch (...) {
+    base = enclosingBase;
+    size = enclosingSize;
+    throw;
+  }
+  base = enclosingBase;
+  size = enclosingSize;
+}
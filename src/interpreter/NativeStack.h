@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+
+/* Thread stacks of a chosen size need pthreads, elsewhere the engines stay
+ * on the stack of the calling thread. */
+#if defined(__unix__) || defined(__APPLE__)
+#define TKOM_NATIVE_STACK 1
+#else
+#define TKOM_NATIVE_STACK 0
+#endif
+
+/* Native stack the tree walking engines recurse on, every TKOM call takes
+ * several C++ frames. The stack is a chain of segments of SegmentSize bytes,
+ * each the stack of a thread that runs while the previous one waits for it.
+ * Pages of a segment are only committed once touched. run() starts the
+ * chain. A call made through call() with less than Margin bytes left runs on
+ * a new segment, so the stack grows with the calls and the maximum call
+ * depth is what limits recursion. Where no thread can be started the first
+ * segment is the calling thread within FallbackSize bytes, and a segment
+ * that cannot be added raises an InterpreterError. Generated code compares
+ * the stack pointer with getLimit() instead. */
+class NativeStack {
+public:
+  static constexpr size_t SegmentSize = 16 * 1024 * 1024;
+  static constexpr size_t Margin = 64 * 1024;
+  static constexpr size_t FallbackSize = 512 * 1024;
+
+  /* Runs inBody on a new segment and rethrows what it throws */
+  static void run(const std::function<void()> &inBody);
+  /* Runs inBody on the current segment, or on a new one once it is nearly
+   * used up */
+  template <class Body> static void call(const Body &inBody) {
+    if (isExhausted())
+      run(inBody);
+    else
+      inBody();
+  }
+  static bool isExhausted();
+  /* Lowest address the current segment may grow to before isExhausted()
+   * holds, 0 outside run() */
+  static uintptr_t getLimit();
+
+private:
+  struct Task {
+    const std::function<void()> *body;
+    std::exception_ptr error;
+  };
+
+  static void *start(void *inTask);
+  static void runHere(size_t inSize, const std::function<void()> &inBody);
+
+  /* Bounds of the segment run() is executing on, base is null outside */
+  static thread_local uintptr_t base;
+  static thread_local size_t size;
+};
@@ -0,0 +1,207 @@
+#include "PurityAnalysis.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/While.h"
+
+void PurityAnalysis::analyze(const Program &inProgram) {
+  inProgram.accept(*this);
+}
+
+bool PurityAnalysis::isPure(const Function &inFunction) const {
+  auto purity = purities.find(&inFunction);
+  return purity != purities.end() && purity->second.bIsPure;
+}
+
+Completion PurityAnalysis::visit(const Program &inProgram) {
+  functions.clear();
+  purities.clear();
+  std::unordered_map<std::string, size_t> definitions;
+  for (const auto &function : inProgram.getFunctions()) {
+    if (++definitions[function->getIdentifier()] == 1)
+      functions[function->getIdentifier()] = function.get();
+    else
+      functions[function->getIdentifier()] = nullptr;
+  }
+
+  for (const auto &function : inProgram.getFunctions()) {
+    function->accept(*this);
+  }
+
+  /* A call of a builtin other than print keeps its caller pure, anything
+   * else needs a pure user function */
+  bool bChanged = true;
+  while (bChanged) {
+    bChanged = false;
+    for (auto &[function, purity] : purities) {
+      if (!purity.bIsPure)
+        continue;
+      for (const auto &callee : purity.callees) {
+        const Function *calleeFunction = findFunction(callee);
+        if (calleeFunction ? isPure(*calleeFunction)
+                           : builtins.findFunction(callee) && callee != "print")
+          continue;
+        purity.bIsPure = false;
+        bChanged = true;
+        break;
+      }
+    }
+  }
+
+  for (const auto &function : inProgram.getFunctions()) {
+    function->setMemoized(isPure(*function) &&
+                          !function->getArguments().empty() &&
+                          isRecursive(*function));
+  }
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const BinaryExpression &inBinaryExpression) {
+  inBinaryExpression.getLhs()->accept(*this);
+  inBinaryExpression.getRhs()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const Case &inCase) {
+  inCase.getExpression()->accept(*this);
+  inCase.getBlock()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const Function &inFunction) {
+  current = &purities[&inFunction];
+  parameters.clear();
+  for (const auto &argument : inFunction.getArguments()) {
+    parameters.insert(argument->getName());
+  }
+  inFunction.getBlock()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  return static_cast<const InstructionFunctionCall *>(
+             inFunctionCallExpression.getFunctionCall())
+      ->accept(*this);
+}
+
+Completion PurityAnalysis::visit(const IfElse &inIfElse) {
+  inIfElse.getExpression()->accept(*this);
+  inIfElse.getBlockIf()->accept(*this);
+  if (inIfElse.getBlockElse())
+    inIfElse.getBlockElse()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const InstructionAssigment &inAssigment) {
+  inAssigment.getExpression()->accept(*this);
+  if (parameters.count(inAssigment.getVariable()->toString()))
+    current->bIsPure = false;
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  if (inDeclarationVariable.getExpression())
+    inDeclarationVariable.getExpression()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion
+PurityAnalysis::visit(const InstructionFunctionCall &inFunctionCall) {
+  for (const auto &argument : inFunctionCall.getExpressions()) {
+    argument->accept(*this);
+  }
+  current->callees.push_back(inFunctionCall.getFunctionName());
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const IntFunction &inIntFunction) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const StringFunction &inStringFunction) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const FloatFunction &inFloatFunction) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const BoolFunction &inBoolFunction) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const PrintFunction &inPrintFunction) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const InstructionReturn &inReturn) {
+  if (inReturn.getExpression())
+    inReturn.getExpression()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const Match &inMatch) {
+  inMatch.getExpression()->accept(*this);
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    caseInstruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const UnaryExpression &inUnaryExpression) {
+  return inUnaryExpression.getExpression()->accept(*this);
+}
+
+Completion
+PurityAnalysis::visit(const VariableExpression &inVariableExpression) {
+  return Completion::Normal;
+}
+
+Completion PurityAnalysis::visit(const While &inWhile) {
+  inWhile.getExpression()->accept(*this);
+  inWhile.getBody()->accept(*this);
+  return Completion::Normal;
+}
+
+const Function *PurityAnalysis::findFunction(const std::string &inName) const {
+  auto function = functions.find(inName);
+  return function != functions.end() ? function->second : nullptr;
+}
+
+bool PurityAnalysis::isRecursive(const Function &inFunction) const {
+  std::unordered_set<const Function *> visited;
+  std::vector<const Function *> pending = {&inFunction};
+  while (!pending.empty()) {
+    const Function *function = pending.back();
+    pending.pop_back();
+    for (const auto &callee : purities.at(function).callees) {
+      const Function *calleeFunction = findFunction(callee);
+      if (calleeFunction == &inFunction)
+        return true;
+      if (calleeFunction && visited.insert(calleeFunction).second)
+        pending.push_back(calleeFunction);
+    }
+  }
+  return false;
+}
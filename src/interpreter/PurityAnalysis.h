@@ -0,0 +1,64 @@
+#pragma once
+#include "Context.h"
+#include "VisitorInterpreter.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/* Finds the functions whose result depends only on their arguments: they
+ * neither print, assign their parameters nor call a function that is not
+ * pure itself. Impurity flows from callees to callers over the call graph
+ * until nothing changes. Pure functions with parameters that can reach
+ * themselves are marked memoized. */
+class PurityAnalysis : public VisitorInterpreter {
+public:
+  PurityAnalysis() = default;
+  void analyze(const class Program &inProgram);
+  bool isPure(const class Function &inFunction) const;
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  struct FunctionPurity {
+    bool bIsPure = true;
+    std::vector<std::string> callees;
+  };
+
+  /* nullptr for builtins, unknown and redefined names */
+  const class Function *findFunction(const std::string &inName) const;
+  bool isRecursive(const class Function &inFunction) const;
+
+  Context builtins;
+  std::unordered_map<std::string, const class Function *> functions;
+  std::unordered_map<const class Function *, FunctionPurity> purities;
+  FunctionPurity *current = nullptr;
+  std::unordered_set<std::string> parameters;
+};
@@ -0,0 +1,170 @@
+#include "Resolver.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+
+void Resolver::resolve(const Program &inProgram) { inProgram.accept(*this); }
+
+Completion Resolver::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    function->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const BinaryExpression &inBinaryExpression) {
+  inBinaryExpression.getLhs()->accept(*this);
+  inBinaryExpression.getRhs()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const Case &inCase) {
+  inCase.getExpression()->accept(*this);
+  inCase.getBlock()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const Function &inFunction) {
+  slots.clear();
+  matchSlots.clear();
+  slotCount = 0;
+
+  const auto &arguments = inFunction.getArguments();
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    slots.insert(std::make_pair(arguments[i]->getName(), i));
+  }
+  slotCount = arguments.size();
+
+  inFunction.getBlock()->accept(*this);
+  inFunction.setSlotCount(slotCount);
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  return static_cast<const InstructionFunctionCall *>(
+             inFunctionCallExpression.getFunctionCall())
+      ->accept(*this);
+}
+
+Completion Resolver::visit(const IfElse &inIfElse) {
+  inIfElse.getExpression()->accept(*this);
+  inIfElse.getBlockIf()->accept(*this);
+  if (inIfElse.getBlockElse())
+    inIfElse.getBlockElse()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const InstructionAssigment &inAssigment) {
+  inAssigment.getExpression()->accept(*this);
+  const Variable *variable = inAssigment.getVariable();
+  variable->setSlot(resolveSlot(variable->toString()));
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  if (inDeclarationVariable.getExpression())
+    inDeclarationVariable.getExpression()->accept(*this);
+  inDeclarationVariable.setSlot(
+      resolveSlot(inDeclarationVariable.getIdentifier()));
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const InstructionFunctionCall &inFunctionCall) {
+  for (const auto &argument : inFunctionCall.getExpressions()) {
+    argument->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const IntFunction &inIntFunction) {
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const StringFunction &inStringFunction) {
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const FloatFunction &inFloatFunction) {
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const BoolFunction &inBoolFunction) {
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const PrintFunction &inPrintFunction) {
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const InstructionReturn &inReturn) {
+  if (inReturn.getExpression())
+    inReturn.getExpression()->accept(*this);
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const Match &inMatch) {
+  inMatch.getExpression()->accept(*this);
+  inMatch.setSlot(slotCount++);
+  inMatch.setDispatch(MatchDispatch::build(inMatch));
+
+  matchSlots.push_back(inMatch.getSlot());
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    caseInstruction->accept(*this);
+  }
+  matchSlots.pop_back();
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const UnaryExpression &inUnaryExpression) {
+  return inUnaryExpression.getExpression()->accept(*this);
+}
+
+Completion Resolver::visit(const VariableExpression &inVariableExpression) {
+  const Variable *variable = inVariableExpression.getVariable();
+  if (!variable->getName())
+    return Completion::Normal;
+
+  if (*variable->getName() == "_" && !matchSlots.empty())
+    variable->setSlot(matchSlots.back());
+  else
+    variable->setSlot(resolveSlot(*variable->getName()));
+  return Completion::Normal;
+}
+
+Completion Resolver::visit(const While &inWhile) {
+  inWhile.getExpression()->accept(*this);
+  inWhile.getBody()->accept(*this);
+  return Completion::Normal;
+}
+
+size_t Resolver::resolveSlot(const std::string &inName) {
+  auto it = slots.find(inName);
+  if (it != slots.end())
+    return it->second;
+
+  slots[inName] = slotCount;
+  return slotCount++;
+}
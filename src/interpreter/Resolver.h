@@ -0,0 +1,53 @@
+#pragma once
+#include "VisitorInterpreter.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Assigns a frame slot to every parameter and local of each function and
+ * stores it on the variable references, so interpreters index a flat frame
+ * instead of looking variables up by name. Locals are function scoped,
+ * parameters take the first slots and every Match gets a hidden slot for its
+ * subject that '_' resolves to. Matches over literal cases also get the
+ * MatchDispatch that finds their case. */
+class Resolver : public VisitorInterpreter {
+public:
+  Resolver() = default;
+  void resolve(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  size_t resolveSlot(const std::string &inName);
+
+  std::unordered_map<std::string, size_t> slots;
+  std::vector<size_t> matchSlots;
+  size_t slotCount = 0;
+};
@@ -0,0 +1,58 @@
+#include "RuntimeValue.h"
+
+RuntimeValue::RuntimeValue(std::string inValue) : bits(0), type(Type::String) {
+  string = new StringObject{1, std::move(inValue)};
+}
+
+RuntimeValue::RuntimeValue(const ValueType &inValue)
+    : RuntimeValue() {
+  switch (inValue.second) {
+  case Token::Type::IntLiteral:
+    *this = RuntimeValue(std::get<int>(inValue.first));
+    break;
+  case Token::Type::FloatLiteral:
+    *this = RuntimeValue(std::get<float>(inValue.first));
+    break;
+  case Token::Type::BooleanLiteral:
+    *this = RuntimeValue(std::get<bool>(inValue.first));
+    break;
+  case Token::Type::StringLiteral:
+    *this = RuntimeValue(std::get<std::string>(inValue.first));
+    break;
+  default:
+    break;
+  }
+}
+
+bool RuntimeValue::operator==(const RuntimeValue &inOther) const {
+  if (type != inOther.type)
+    return false;
+
+  switch (type) {
+  case Type::Int:
+    return integer == inOther.integer;
+  case Type::Float:
+    return floating == inOther.floating;
+  case Type::Bool:
+    return boolean == inOther.boolean;
+  case Type::String:
+    return string == inOther.string || string->value == inOther.string->value;
+  default:
+    return true;
+  }
+}
+
+ValueType RuntimeValue::toValueType() const {
+  switch (type) {
+  case Type::Int:
+    return ValueType(integer, Token::Type::IntLiteral);
+  case Type::Float:
+    return ValueType(floating, Token::Type::FloatLiteral);
+  case Type::Bool:
+    return ValueType(boolean, Token::Type::BooleanLiteral);
+  case Type::String:
+    return ValueType(string->value, Token::Type::StringLiteral);
+  default:
+    return ValueType(0, Token::Type::BadType);
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "../lexer/Token.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+typedef std::pair<std::variant<std::string, float, int, bool>, Token::Type> ValueType;
+
+/* 16 byte value used by every execution engine. Ints, floats and bools are
+ * stored inline next to a one byte tag, strings are immutable and shared
+ * between copies through an intrusive reference count, so copying a value
+ * never allocates. */
+class RuntimeValue {
+public:
+  enum class Type : uint8_t {
+    Void,
+    Int,
+    Float,
+    Bool,
+    String,
+  };
+
+  RuntimeValue() : bits(0), type(Type::Void) {}
+  explicit RuntimeValue(int inValue) : bits(0), type(Type::Int) {
+    integer = inValue;
+  }
+  explicit RuntimeValue(float inValue) : bits(0), type(Type::Float) {
+    floating = inValue;
+  }
+  explicit RuntimeValue(bool inValue) : bits(0), type(Type::Bool) {
+    boolean = inValue;
+  }
+  explicit RuntimeValue(std::string inValue);
+  explicit RuntimeValue(const ValueType &inValue);
+
+  RuntimeValue(const RuntimeValue &inOther)
+      : bits(inOther.bits), type(inOther.type) {
+    retain();
+  }
+  RuntimeValue(RuntimeValue &&inOther) noexcept
+      : bits(inOther.bits), type(inOther.type) {
+    inOther.type = Type::Void;
+  }
+  RuntimeValue &operator=(const RuntimeValue &inOther) {
+    if (this != &inOther) {
+      inOther.retain();
+      release();
+      bits = inOther.bits;
+      type = inOther.type;
+    }
+    return *this;
+  }
+  RuntimeValue &operator=(RuntimeValue &&inOther) noexcept {
+    if (this != &inOther) {
+      release();
+      bits = inOther.bits;
+      type = inOther.type;
+      inOther.type = Type::Void;
+    }
+    return *this;
+  }
+  ~RuntimeValue() { release(); }
+
+  Type getType() const { return type; }
+  int getInt() const { return integer; }
+  float getFloat() const { return floating; }
+  bool getBool() const { return boolean; }
+  const std::string &getString() const { return string->value; }
+
+  /* Same type and same value, values of different types are never equal */
+  bool operator==(const RuntimeValue &inOther) const;
+  ValueType toValueType() const;
+
+private:
+  struct StringObject {
+    size_t references;
+    std::string value;
+  };
+
+  void retain() const {
+    if (type == Type::String)
+      ++string->references;
+  }
+  void release() {
+    if (type == Type::String && --string->references == 0)
+      delete string;
+  }
+
+  union {
+    uint64_t bits;
+    int integer;
+    float floating;
+    bool boolean;
+    StringObject *string;
+  };
+  Type type;
+};
+
+static_assert(sizeof(RuntimeValue) == 16, "RuntimeValue should stay compact");
@@ -0,0 +1,421 @@
+#include "TypeInference.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/BoolFunction.h"
+#include "../instructions/Case.h"
+#include "../instructions/FloatFunction.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/IntFunction.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/PrintFunction.h"
+#include "../instructions/Program.h"
+#include "../instructions/StringFunction.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "InterpreterError.h"
+#include "ValueOperations.h"
+
+bool TypeInference::State::operator==(const State &inOther) const {
+  return bIsReachable == inOther.bIsReachable && slots == inOther.slots;
+}
+
+void TypeInference::infer(const Program &inProgram) {
+  context.reset();
+  functions.clear();
+  errorOrder.clear();
+  errors.clear();
+  inProgram.accept(*this);
+
+  for (const void *node : errorOrder) {
+    auto error = errors.find(node);
+    if (error != errors.end())
+      throw InterpreterError(error->second);
+  }
+}
+
+Completion TypeInference::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &functionName = function->getIdentifier();
+    if (context.findFunction(functionName) != nullptr)
+      throw InterpreterError("Redefinition of function with name " +
+                             functionName + "!");
+    context.insertFunction(function.get());
+    functions[function.get()].parameters.assign(
+        function->getArguments().size(), 0);
+  }
+
+  /* Parameters of main default to 0 */
+  FunctionTypes &main = functions[inProgram.getMain()];
+  main.bIsCalled = true;
+  main.bIsCertainlyCalled = true;
+  for (auto &parameter : main.parameters) {
+    parameter = typeSet(RuntimeValue::Type::Int);
+  }
+
+  bAnnotate = false;
+  do {
+    bChanged = false;
+    for (const auto &function : inProgram.getFunctions()) {
+      if (functions[function.get()].bIsCalled)
+        analyzeFunction(*function);
+    }
+  } while (bChanged);
+
+  bAnnotate = true;
+  for (const auto &function : inProgram.getFunctions()) {
+    if (functions[function.get()].bIsCalled)
+      analyzeFunction(*function);
+  }
+  return Completion::Normal;
+}
+
+void TypeInference::analyzeFunction(const Function &inFunction) {
+  currentFunction = &inFunction;
+  currentTypes = &functions[&inFunction];
+  state.slots.assign(inFunction.getSlotCount(), 0);
+  state.bIsReachable = true;
+  bIsCertain = currentTypes->bIsCertainlyCalled;
+  returnCount = 0;
+  for (size_t i = 0; i < currentTypes->parameters.size(); ++i) {
+    state.slots[i] = currentTypes->parameters[i];
+  }
+
+  inFunction.getBlock()->accept(*this);
+  /* Falling off the end of a body returns nothing */
+  if (state.bIsReachable)
+    join(currentTypes->returns, typeSet(RuntimeValue::Type::Void));
+}
+
+TypeInference::TypeSet
+TypeInference::inferExpression(const Expression &inExpression) {
+  inExpression.accept(*this);
+  return result;
+}
+
+void TypeInference::join(State &inOutState, const State &inOther) const {
+  if (!inOther.bIsReachable)
+    return;
+  if (!inOutState.bIsReachable) {
+    inOutState = inOther;
+    return;
+  }
+  for (size_t i = 0; i < inOutState.slots.size(); ++i) {
+    inOutState.slots[i] |= inOther.slots[i];
+  }
+}
+
+TypeInference::Certainty TypeInference::enterConditional() {
+  Certainty saved{bIsCertain, returnCount};
+  bIsCertain = false;
+  return saved;
+}
+
+void TypeInference::leaveConditional(const Certainty &inSaved) {
+  bIsCertain = inSaved.bIsCertain && returnCount == inSaved.returnCount;
+}
+
+bool TypeInference::join(TypeSet &inOutTypes, TypeSet inOther) {
+  if ((inOutTypes | inOther) == inOutTypes)
+    return false;
+  inOutTypes |= inOther;
+  bChanged = true;
+  return true;
+}
+
+void TypeInference::setError(const void *inNode,
+                             const std::string &inMessage) {
+  if (!bAnnotate)
+    return;
+  if (inMessage.empty() || !bIsCertain) {
+    errors.erase(inNode);
+    return;
+  }
+  if (errors.emplace(inNode, inMessage).second)
+    errorOrder.push_back(inNode);
+  else
+    errors[inNode] = inMessage;
+}
+
+TypeInference::TypeSet TypeInference::typeSet(RuntimeValue::Type inType) {
+  return static_cast<TypeSet>(1 << static_cast<int>(inType));
+}
+
+RuntimeValue::Type TypeInference::singleType(TypeSet inTypes) {
+  for (auto type : {RuntimeValue::Type::Int, RuntimeValue::Type::Float,
+                    RuntimeValue::Type::Bool, RuntimeValue::Type::String}) {
+    if (inTypes == typeSet(type))
+      return type;
+  }
+  return RuntimeValue::Type::Void;
+}
+
+std::string TypeInference::describe(TypeSet inTypes) {
+  static const char *names[] = {"void", "int", "float", "bool", "string"};
+  std::string description;
+  for (int i = 0; i < 5; ++i) {
+    if (!(inTypes & (1 << i)))
+      continue;
+    if (!description.empty())
+      description += " or ";
+    description += names[i];
+  }
+  return description;
+}
+
+Completion TypeInference::visit(const BinaryExpression &inBinaryExpression) {
+  typedef Expression::Operator Op;
+  const Op op = inBinaryExpression.getOperator();
+  TypeSet lhs = inferExpression(*inBinaryExpression.getLhs());
+  TypeSet rhs;
+  if (inBinaryExpression.isLogical()) {
+    Certainty saved = enterConditional();
+    rhs = inferExpression(*inBinaryExpression.getRhs());
+    leaveConditional(saved);
+  } else {
+    rhs = inferExpression(*inBinaryExpression.getRhs());
+  }
+  const TypeSet boolType = typeSet(RuntimeValue::Type::Bool);
+
+  /* Operands are never converted, so only equal types combine */
+  result = 0;
+  TypeSet common = lhs & rhs;
+  for (auto type : {RuntimeValue::Type::Int, RuntimeValue::Type::Float}) {
+    if (common & typeSet(type))
+      result |= op <= Op::Modulo ? typeSet(type) : boolType;
+  }
+  if ((common & boolType) && (op == Op::LogicalOr || op == Op::LogicalAnd ||
+                              op == Op::Equal || op == Op::NotEqual))
+    result |= boolType;
+  /* A left operand of || or && that may decide alone yields a bool whatever
+   * the right one is */
+  if ((op == Op::LogicalOr || op == Op::LogicalAnd) &&
+      (lhs & (typeSet(RuntimeValue::Type::Int) |
+              typeSet(RuntimeValue::Type::Float) | boolType)))
+    result |= boolType;
+  if (common & typeSet(RuntimeValue::Type::String)) {
+    if (op == Op::Sum)
+      result |= typeSet(RuntimeValue::Type::String);
+    else if (op == Op::Equal || op == Op::NotEqual)
+      result |= boolType;
+  }
+
+  if (bAnnotate)
+    inBinaryExpression.setOperandType(
+        lhs == rhs ? singleType(lhs) : RuntimeValue::Type::Void);
+  if (lhs != 0 && rhs != 0 && result == 0)
+    setError(&inBinaryExpression,
+             std::string("Cannot calculate (") +
+                 ValueOperations::getOperatorSymbol(op) + ") on " +
+                 describe(lhs) + " and " + describe(rhs) + " in function " +
+                 currentFunction->getIdentifier() + "!");
+  else
+    setError(&inBinaryExpression, "");
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    if (!state.bIsReachable)
+      break;
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const Case &inCase) {
+  return inCase.getBlock()->accept(*this);
+}
+
+Completion TypeInference::visit(const Function &inFunction) {
+  FunctionTypes &callee = functions[&inFunction];
+  if (!callee.bIsCalled) {
+    callee.bIsCalled = true;
+    bChanged = true;
+  }
+  if (bIsCertain && !callee.bIsCertainlyCalled) {
+    callee.bIsCertainlyCalled = true;
+    bChanged = true;
+  }
+  for (size_t i = 0; i < callArguments.size(); ++i) {
+    join(callee.parameters[i], callArguments[i]);
+  }
+  result = callee.returns;
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  /* A call returning nothing fails instead of producing a value */
+  result = inferCall(*static_cast<const InstructionFunctionCall *>(
+               inFunctionCallExpression.getFunctionCall())) &
+           ~typeSet(RuntimeValue::Type::Void);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const IfElse &inIfElse) {
+  inferExpression(*inIfElse.getExpression());
+  Certainty saved = enterConditional();
+  State entry = state;
+  inIfElse.getBlockIf()->accept(*this);
+  State afterIf = std::move(state);
+  state = std::move(entry);
+  if (inIfElse.getBlockElse())
+    inIfElse.getBlockElse()->accept(*this);
+  join(state, afterIf);
+  leaveConditional(saved);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const InstructionAssigment &inAssigment) {
+  TypeSet value = inferExpression(*inAssigment.getExpression());
+  state.slots[inAssigment.getVariable()->getSlot()] = value;
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  TypeSet value = typeSet(RuntimeValue::Type::Int);
+  if (inDeclarationVariable.getExpression())
+    value = inferExpression(*inDeclarationVariable.getExpression());
+  state.slots[inDeclarationVariable.getSlot()] = value;
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const InstructionFunctionCall &inFunctionCall) {
+  inferCall(inFunctionCall);
+  return Completion::Normal;
+}
+
+TypeInference::TypeSet
+TypeInference::inferCall(const InstructionFunctionCall &inFunctionCall) {
+  std::vector<TypeSet> arguments;
+  for (const auto &argument : inFunctionCall.getExpressions()) {
+    arguments.push_back(inferExpression(*argument));
+  }
+
+  /* Calls the interpreter rejects never return */
+  auto function = context.findFunction(inFunctionCall.getFunctionName());
+  if (function == nullptr ||
+      function->getArguments().size() != arguments.size()) {
+    result = 0;
+    return result;
+  }
+  callArguments = std::move(arguments);
+  function->accept(*this);
+  return result;
+}
+
+Completion TypeInference::visit(const IntFunction &inIntFunction) {
+  result = typeSet(RuntimeValue::Type::Int);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const StringFunction &inStringFunction) {
+  result = typeSet(RuntimeValue::Type::String);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const FloatFunction &inFloatFunction) {
+  result = typeSet(RuntimeValue::Type::Float);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const BoolFunction &inBoolFunction) {
+  result = typeSet(RuntimeValue::Type::Bool);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const PrintFunction &inPrintFunction) {
+  result = typeSet(RuntimeValue::Type::Void);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const InstructionReturn &inReturn) {
+  TypeSet value = typeSet(RuntimeValue::Type::Void);
+  if (inReturn.getExpression())
+    value = inferExpression(*inReturn.getExpression());
+  join(currentTypes->returns, value);
+  state.bIsReachable = false;
+  ++returnCount;
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const Match &inMatch) {
+  state.slots[inMatch.getSlot()] = inferExpression(*inMatch.getExpression());
+
+  /* Case expressions cannot change slots, only the blocks do */
+  State exit;
+  exit.slots.assign(state.slots.size(), 0);
+  exit.bIsReachable = false;
+  Certainty saved = enterConditional();
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    inferExpression(*caseInstruction->getExpression());
+    State entry = state;
+    caseInstruction->accept(*this);
+    join(exit, state);
+    state = std::move(entry);
+  }
+  join(state, exit);
+  leaveConditional(saved);
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const UnaryExpression &inUnaryExpression) {
+  TypeSet operand = inferExpression(*inUnaryExpression.getExpression());
+  result = operand & (typeSet(RuntimeValue::Type::Int) |
+                      typeSet(RuntimeValue::Type::Float) |
+                      typeSet(RuntimeValue::Type::Bool));
+
+  if (bAnnotate)
+    inUnaryExpression.setOperandType(singleType(operand));
+  if (operand != 0 && result == 0)
+    setError(&inUnaryExpression, "Cannot negate " + describe(operand) +
+                                     " in function " +
+                                     currentFunction->getIdentifier() + "!");
+  else
+    setError(&inUnaryExpression, "");
+  return Completion::Normal;
+}
+
+Completion
+TypeInference::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  if (const auto &value = variable->getValue())
+    result = typeSet(value->getRuntimeValue().getType());
+  else
+    result = state.slots[variable->getSlot()];
+  return Completion::Normal;
+}
+
+Completion TypeInference::visit(const While &inWhile) {
+  /* The loop head joins the entry with every pass through the body */
+  State head;
+  const bool bIsConditionCertain = bIsCertain;
+  do {
+    head = state;
+    bIsCertain = bIsConditionCertain;
+    TypeSet condition = inferExpression(*inWhile.getExpression());
+    if (condition != 0 && !(condition & typeSet(RuntimeValue::Type::Bool)))
+      setError(&inWhile, "Condition of while is " + describe(condition) +
+                             " instead of bool in function " +
+                             currentFunction->getIdentifier() + "!");
+    else
+      setError(&inWhile, "");
+    /* The body may not run at all */
+    Certainty saved = enterConditional();
+    inWhile.getBody()->accept(*this);
+    leaveConditional(saved);
+    join(state, head);
+  } while (!(state == head));
+  return Completion::Normal;
+}
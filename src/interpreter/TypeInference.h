@@ -0,0 +1,110 @@
+#pragma once
+#include "VisitorInterpreter.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Flow sensitive type inference over a resolved program. Every slot and
+ * expression gets the set of types it may hold, parameters take the types
+ * of the arguments of every call site and functions return the types of
+ * all their returns, iterated until nothing changes. Binary and unary
+ * expressions whose operands have a single known type are annotated with it
+ * so engines can skip the dynamic checks. Operations that fail for every
+ * type their operands can have are reported before the program runs when
+ * they certainly execute: every path from the entry of their function
+ * reaches them and the function is certainly called from main. Others are
+ * left to fail at runtime. Only functions reachable from main are
+ * analysed. */
+class TypeInference : public VisitorInterpreter {
+public:
+  TypeInference() = default;
+  void infer(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  /* One bit per RuntimeValue::Type, empty for code that never produces a
+   * value */
+  typedef uint8_t TypeSet;
+
+  struct FunctionTypes {
+    bool bIsCalled = false;
+    bool bIsCertainlyCalled = false;
+    std::vector<TypeSet> parameters;
+    TypeSet returns = 0;
+  };
+
+  /* Types of every slot of the current function, none once every path has
+   * returned */
+  struct State {
+    std::vector<TypeSet> slots;
+    bool bIsReachable = true;
+    bool operator==(const State &inOther) const;
+  };
+
+  /* Whether the current node certainly executes, and the returns seen so far
+   * that a conditional region may skip the code after it by */
+  struct Certainty {
+    bool bIsCertain;
+    size_t returnCount;
+  };
+
+  void analyzeFunction(const class Function &inFunction);
+  TypeSet inferExpression(const class Expression &inExpression);
+  TypeSet inferCall(const class InstructionFunctionCall &inFunctionCall);
+  void join(State &inOutState, const State &inOther) const;
+  /* Code run on some paths only never fails for certain, the code after it
+   * still does unless it may have returned */
+  Certainty enterConditional();
+  void leaveConditional(const Certainty &inSaved);
+  bool join(TypeSet &inOutTypes, TypeSet inOther);
+  /* Errors are kept per node until the analysis settles, a node visited
+   * again with wider types may turn out valid */
+  void setError(const void *inNode, const std::string &inMessage);
+  static TypeSet typeSet(RuntimeValue::Type inType);
+  static RuntimeValue::Type singleType(TypeSet inTypes);
+  static std::string describe(TypeSet inTypes);
+
+  Context context;
+  std::unordered_map<const class Function *, FunctionTypes> functions;
+  FunctionTypes *currentTypes = nullptr;
+  const class Function *currentFunction = nullptr;
+  State state;
+  bool bIsCertain = false;
+  size_t returnCount = 0;
+  /* Types of the last inferred expression or call */
+  TypeSet result = 0;
+  std::vector<TypeSet> callArguments;
+  bool bChanged = false;
+  /* Set for the last pass, once types are final */
+  bool bAnnotate = false;
+  std::vector<const void *> errorOrder;
+  std::unordered_map<const void *, std::string> errors;
+};
@@ -0,0 +1,277 @@
+#include "ValueOperations.h"
+#include "InterpreterError.h"
+#include <cmath>
+#include <type_traits>
+#include <iostream>
+
+static const char *operatorSymbols[] = {
+    "+", "-", "*", "/", "%", "||", "&&", "<", "<=", ">", ">=", "==", "!=",
+};
+
+static RuntimeValue invalidOperation(Expression::Operator inOperator) {
+  throw InterpreterError(std::string("Cannot calculate (") +
+                         operatorSymbols[static_cast<int>(inOperator)] +
+                         ")!");
+}
+
+/* Ints and floats share every operator, only division errors and modulo
+ * differ */
+template <class T>
+static RuntimeValue numericOperation(Expression::Operator inOperator, T inLhs,
+                                     T inRhs) {
+  constexpr bool bIsFloat = std::is_same_v<T, float>;
+  switch (inOperator) {
+  case Expression::Operator::Sum:
+    return RuntimeValue(static_cast<T>(inLhs + inRhs));
+  case Expression::Operator::Substraction:
+    return RuntimeValue(static_cast<T>(inLhs - inRhs));
+  case Expression::Operator::Multiplication:
+    return RuntimeValue(static_cast<T>(inLhs * inRhs));
+  case Expression::Operator::Division:
+    if (inRhs == 0)
+      throw InterpreterError(bIsFloat ? "Cannot divide by 0.0!"
+                                      : "Cannot divide by 0!");
+    if (ValueOperations::overflowsDivision(inLhs, inRhs))
+      throw InterpreterError("Integer overflow in division!");
+    return RuntimeValue(static_cast<T>(inLhs / inRhs));
+  case Expression::Operator::Modulo:
+    if (inRhs == 0)
+      throw InterpreterError(bIsFloat ? "Cannot modulo by 0.0!"
+                                      : "Cannot modulo by 0!");
+    if (ValueOperations::overflowsDivision(inLhs, inRhs))
+      throw InterpreterError("Integer overflow in modulo!");
+    if constexpr (bIsFloat)
+      return RuntimeValue(std::fmod(inLhs, inRhs));
+    else
+      return RuntimeValue(inLhs % inRhs);
+  case Expression::Operator::LogicalOr:
+    return RuntimeValue(inLhs || inRhs);
+  case Expression::Operator::LogicalAnd:
+    return RuntimeValue(inLhs && inRhs);
+  case Expression::Operator::Less:
+    return RuntimeValue(inLhs < inRhs);
+  case Expression::Operator::LessEqual:
+    return RuntimeValue(inLhs <= inRhs);
+  case Expression::Operator::More:
+    return RuntimeValue(inLhs > inRhs);
+  case Expression::Operator::MoreEqual:
+    return RuntimeValue(inLhs >= inRhs);
+  case Expression::Operator::Equal:
+    return RuntimeValue(inLhs == inRhs);
+  case Expression::Operator::NotEqual:
+    return RuntimeValue(inLhs != inRhs);
+  default:
+    throw InterpreterError("Invalid binary operator!");
+  }
+}
+
+static RuntimeValue boolOperation(Expression::Operator inOperator, bool inLhs,
+                                  bool inRhs) {
+  switch (inOperator) {
+  case Expression::Operator::LogicalOr:
+    return RuntimeValue(inLhs || inRhs);
+  case Expression::Operator::LogicalAnd:
+    return RuntimeValue(inLhs && inRhs);
+  case Expression::Operator::Equal:
+    return RuntimeValue(inLhs == inRhs);
+  case Expression::Operator::NotEqual:
+    return RuntimeValue(inLhs != inRhs);
+  default:
+    return invalidOperation(inOperator);
+  }
+}
+
+static RuntimeValue stringOperation(Expression::Operator inOperator,
+                                    const std::string &inLhs,
+                                    const std::string &inRhs) {
+  switch (inOperator) {
+  case Expression::Operator::Sum:
+    return RuntimeValue(inLhs + inRhs);
+  case Expression::Operator::Equal:
+    return RuntimeValue(inLhs == inRhs);
+  case Expression::Operator::NotEqual:
+    return RuntimeValue(inLhs != inRhs);
+  default:
+    return invalidOperation(inOperator);
+  }
+}
+
+RuntimeValue ValueOperations::binaryOperation(Expression::Operator inOperator,
+                                              const RuntimeValue &inLhs,
+                                              const RuntimeValue &inRhs) {
+  if (inOperator > Expression::Operator::NotEqual)
+    throw InterpreterError("Invalid binary operator!");
+
+  /* Operands are never converted implicitly */
+  if (inLhs.getType() == inRhs.getType()) {
+    switch (inLhs.getType()) {
+    case RuntimeValue::Type::Int:
+      return numericOperation(inOperator, inLhs.getInt(), inRhs.getInt());
+    case RuntimeValue::Type::Float:
+      return numericOperation(inOperator, inLhs.getFloat(), inRhs.getFloat());
+    case RuntimeValue::Type::Bool:
+      return boolOperation(inOperator, inLhs.getBool(), inRhs.getBool());
+    case RuntimeValue::Type::String:
+      return stringOperation(inOperator, inLhs.getString(), inRhs.getString());
+    default:
+      break;
+    }
+  }
+  return invalidOperation(inOperator);
+}
+
+bool ValueOperations::shortCircuits(Expression::Operator inOperator,
+                                    const RuntimeValue &inLhs) {
+  if (inOperator != Expression::Operator::LogicalOr &&
+      inOperator != Expression::Operator::LogicalAnd)
+    return false;
+
+  bool bLhs = false;
+  switch (inLhs.getType()) {
+  case RuntimeValue::Type::Int:
+    bLhs = inLhs.getInt() != 0;
+    break;
+  case RuntimeValue::Type::Float:
+    bLhs = inLhs.getFloat() != 0;
+    break;
+  case RuntimeValue::Type::Bool:
+    bLhs = inLhs.getBool();
+    break;
+  default:
+    /* No right operand could make the operator succeed */
+    invalidOperation(inOperator);
+  }
+  return bLhs == (inOperator == Expression::Operator::LogicalOr);
+}
+
+bool ValueOperations::compare(Expression::Operator inOperator,
+                              const RuntimeValue &inLhs,
+                              const RuntimeValue &inRhs) {
+  if (inLhs.getType() == inRhs.getType()) {
+    if (inLhs.getType() == RuntimeValue::Type::Int)
+      return compareNumbers(inOperator, inLhs.getInt(), inRhs.getInt());
+    if (inLhs.getType() == RuntimeValue::Type::Float)
+      return compareNumbers(inOperator, inLhs.getFloat(), inRhs.getFloat());
+  }
+  return binaryOperation(inOperator, inLhs, inRhs).getBool();
+}
+
+RuntimeValue ValueOperations::intOperation(Expression::Operator inOperator,
+                                           int inLhs, int inRhs) {
+  return numericOperation(inOperator, inLhs, inRhs);
+}
+
+RuntimeValue ValueOperations::floatOperation(Expression::Operator inOperator,
+                                             float inLhs, float inRhs) {
+  return numericOperation(inOperator, inLhs, inRhs);
+}
+
+const char *
+ValueOperations::getOperatorSymbol(Expression::Operator inOperator) {
+  return operatorSymbols[static_cast<int>(inOperator)];
+}
+
+RuntimeValue ValueOperations::unaryOperation(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::Float:
+    return RuntimeValue(-inValue.getFloat());
+  case RuntimeValue::Type::Int:
+    return RuntimeValue(-inValue.getInt());
+  case RuntimeValue::Type::Bool:
+    return RuntimeValue(!inValue.getBool());
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+RuntimeValue ValueOperations::toInt(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::String:
+    return RuntimeValue(std::stoi(inValue.getString()));
+  case RuntimeValue::Type::Float:
+    return RuntimeValue(static_cast<int>(inValue.getFloat()));
+  case RuntimeValue::Type::Int:
+    return inValue;
+  case RuntimeValue::Type::Bool:
+    return RuntimeValue(static_cast<int>(inValue.getBool()));
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+RuntimeValue ValueOperations::toString(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::String:
+    return inValue;
+  case RuntimeValue::Type::Float:
+    return RuntimeValue(std::to_string(inValue.getFloat()));
+  case RuntimeValue::Type::Int:
+    return RuntimeValue(std::to_string(inValue.getInt()));
+  case RuntimeValue::Type::Bool:
+    return RuntimeValue(std::string(inValue.getBool() ? "true" : "false"));
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+RuntimeValue ValueOperations::toFloat(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::String:
+    return RuntimeValue(std::stof(inValue.getString()));
+  case RuntimeValue::Type::Float:
+    return inValue;
+  case RuntimeValue::Type::Int:
+    return RuntimeValue(static_cast<float>(inValue.getInt()));
+  case RuntimeValue::Type::Bool:
+    return RuntimeValue(static_cast<float>(inValue.getBool()));
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+RuntimeValue ValueOperations::toBool(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::String:
+    if (inValue.getString() == "true")
+      return RuntimeValue(true);
+    if (inValue.getString() == "false")
+      return RuntimeValue(false);
+    throw InterpreterError("Cannot convert string to bool!");
+  case RuntimeValue::Type::Float:
+    return RuntimeValue(inValue.getFloat() > 0.0);
+  case RuntimeValue::Type::Int:
+    return RuntimeValue(inValue.getInt() > 0);
+  case RuntimeValue::Type::Bool:
+    return inValue;
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+void ValueOperations::print(const RuntimeValue &inValue) {
+  switch (inValue.getType()) {
+  case RuntimeValue::Type::String:
+    std::cout << inValue.getString();
+    break;
+  case RuntimeValue::Type::Float:
+    std::cout << inValue.getFloat();
+    break;
+  case RuntimeValue::Type::Int:
+    std::cout << inValue.getInt();
+    break;
+  case RuntimeValue::Type::Bool:
+    std::cout << std::to_string(inValue.getBool());
+    break;
+  default:
+    throw InterpreterError("Invalid expression type!");
+  }
+}
+
+bool ValueOperations::isTrue(const RuntimeValue &inValue) {
+  return inValue.getType() == RuntimeValue::Type::Bool && inValue.getBool();
+}
+
+bool ValueOperations::matchesCase(const RuntimeValue &inSubject,
+                                  const RuntimeValue &inCaseValue) {
+  return isTrue(inCaseValue) || inSubject == inCaseValue;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "RuntimeValue.h"
+#include "../instructions/Expression.h"
+#include <limits>
+
+/* Value semantics shared by every execution engine */
+class ValueOperations {
+public:
+  static RuntimeValue binaryOperation(Expression::Operator inOperator,
+                                      const RuntimeValue &inLhs,
+                                      const RuntimeValue &inRhs);
+  /* True when inLhs alone decides || or &&, whose right operand is then
+   * skipped and whose result is the bool inOperator == LogicalOr */
+  static bool shortCircuits(Expression::Operator inOperator,
+                            const RuntimeValue &inLhs);
+  /* Outcome of the comparison inOperator, for branching on it without
+   * building the bool */
+  static bool compare(Expression::Operator inOperator,
+                      const RuntimeValue &inLhs, const RuntimeValue &inRhs);
+  template <class T>
+  static bool compareNumbers(Expression::Operator inOperator, T inLhs,
+                             T inRhs) {
+    switch (inOperator) {
+    case Expression::Operator::Less:
+      return inLhs < inRhs;
+    case Expression::Operator::LessEqual:
+      return inLhs <= inRhs;
+    case Expression::Operator::More:
+      return inLhs > inRhs;
+    case Expression::Operator::MoreEqual:
+      return inLhs >= inRhs;
+    case Expression::Operator::Equal:
+      return inLhs == inRhs;
+    default:
+      return inLhs != inRhs;
+    }
+  }
+  /* True when an int division or modulo of inLhs by inRhs overflows, which
+   * traps on x86-64 and is reported as an error instead */
+  static bool overflowsDivision(int inLhs, int inRhs) {
+    return inLhs == std::numeric_limits<int>::min() && inRhs == -1;
+  }
+  static bool overflowsDivision(float, float) { return false; }
+  /* Kernels for operands whose type is known statically */
+  static RuntimeValue intOperation(Expression::Operator inOperator, int inLhs,
+                                   int inRhs);
+  static RuntimeValue floatOperation(Expression::Operator inOperator,
+                                     float inLhs, float inRhs);
+  static const char *getOperatorSymbol(Expression::Operator inOperator);
+  static RuntimeValue unaryOperation(const RuntimeValue &inValue);
+  static RuntimeValue toInt(const RuntimeValue &inValue);
+  static RuntimeValue toFloat(const RuntimeValue &inValue);
+  static RuntimeValue toString(const RuntimeValue &inValue);
+  static RuntimeValue toBool(const RuntimeValue &inValue);
+  static void print(const RuntimeValue &inValue);
+  static bool isTrue(const RuntimeValue &inValue);
+  static bool matchesCase(const RuntimeValue &inSubject,
+                          const RuntimeValue &inCaseValue);
+};
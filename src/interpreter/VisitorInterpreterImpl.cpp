@@ -24,20 +24,44 @@
 #include "../lexer/Lexer.h"
 #include "../parser/Parser.h"
 #include "InterpreterError.h"
-#include <cmath>
-#include <iostream>
+#include "NativeStack.h"
+#include "PurityAnalysis.h"
+#include "Resolver.h"
+#include "TypeInference.h"
+#include "ValueOperations.h"
 
 VisitorInterpreterImpl::VisitorInterpreterImpl(std::unique_ptr<Parser> inParser)
     : parser(std::move(inParser)) {}
 
+VisitorInterpreterImpl::VisitorInterpreterImpl(std::unique_ptr<Parser> inParser,
+                                               size_t inJitThreshold)
+    : parser(std::move(inParser)),
+      jit(std::make_unique<Jit>(context, inJitThreshold)) {}
+
 std::optional<ValueType> VisitorInterpreterImpl::execute() {
   context.reset();
   Program *program = parser->parseProgram();
-  return program->accept(*this);
+  Resolver resolver;
+  resolver.resolve(*program);
+  TypeInference typeInference;
+  typeInference.infer(*program);
+  PurityAnalysis purityAnalysis;
+  purityAnalysis.analyze(*program);
+  memoTables.clear();
+  memoizedCallCount = 0;
+  NativeStack::run([&]() { program->accept(*this); });
+  if (result.getType() == RuntimeValue::Type::Void)
+    return std::nullopt;
+  return result.toValueType();
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const Program &inProgram) {
+const Jit *VisitorInterpreterImpl::getJit() const { return jit.get(); }
+
+size_t VisitorInterpreterImpl::getMemoizedCallCount() const {
+  return memoizedCallCount;
+}
+
+Completion VisitorInterpreterImpl::visit(const Program &inProgram) {
   for (const auto &function : inProgram.getFunctions()) {
     const std::string &functionName = function->getIdentifier();
     if (context.findFunction(functionName) != nullptr)
@@ -47,623 +71,367 @@ VisitorInterpreterImpl::visit(const Program &inProgram) {
   }
 
   if (auto *main = inProgram.getMain()) {
-    return main->accept(*this);
+    /* Parameters of main default to 0 */
+    size_t frame = context.allocateFrame(*main);
+    const auto &arguments = main->getArguments();
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      context.getFrameSlot(frame, i) = InterpreterValue(
+          RuntimeValue(0), arguments[i]->isMutable());
+    }
+
+    context.enterFrame(frame);
+    main->accept(*this);
+    runTailCalls();
+    context.leaveFrame();
   } else {
     throw InterpreterError("No function with name main found!");
   }
-  return std::nullopt;
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const BinaryExpression &inBinaryExpression) {
-  auto lhsValue = inBinaryExpression.getLhs()->accept(*this);
-  auto rhsValue = inBinaryExpression.getRhs()->accept(*this);
-  switch (inBinaryExpression.getOperator()) {
-  case Expression::Operator::Sum: {
-      return std::visit(
-          overload{
-              [](int lhs, int rhs) {
-                return (ValueType)std::make_pair(lhs + rhs, Token::Type::IntLiteral);
-              },
-              [](float lhs, float rhs) {
-                return (ValueType)std::make_pair(lhs + rhs,
-                                                 Token::Type::FloatLiteral);
-              },
-              [](std::string &lhs, std::string &rhs) {
-                return (ValueType)std::make_pair(lhs + rhs,
-                                                 Token::Type::StringLiteral);
-              },
-              [](const auto &lhs, const auto &rhs) {
-                throw InterpreterError("Cannot calculate (+)!");
-                return (ValueType)std::make_pair(0, Token::Type::BadType);
-              },
-          },
-          lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Substraction: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs - rhs,
-                                               Token::Type::IntLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs - rhs,
-                                               Token::Type::FloatLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (-)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Multiplication: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs * rhs,
-                                               Token::Type::IntLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs * rhs,
-                                               Token::Type::FloatLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (*)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Division: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              if (rhs == 0)
-                throw InterpreterError("Cannot divide by 0!");
-              return (ValueType)std::make_pair(lhs / rhs,
-                                               Token::Type::IntLiteral);
-            },
-            [](float lhs, float rhs) {
-              if (rhs == 0.0)
-                throw InterpreterError("Cannot divide by 0.0!");
-              return (ValueType)std::make_pair(lhs / rhs,
-                                               Token::Type::FloatLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (/)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Modulo: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              if (rhs == 0)
-                throw InterpreterError("Cannot modulo by 0!");
-              return (ValueType)std::make_pair(lhs % rhs,
-                                               Token::Type::IntLiteral);
-            },
-            [](float lhs, float rhs) {
-              if (rhs == 0.0)
-                throw InterpreterError("Cannot modulo by 0.0!");
-              return (ValueType)std::make_pair(fmod(lhs,rhs),
-                                               Token::Type::FloatLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (%)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::LogicalOr: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs || rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs || rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](bool lhs, bool rhs) {
-              return (ValueType)std::make_pair(lhs || rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (||)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::LogicalAnd: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs && rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs && rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](bool lhs, bool rhs) {
-              return (ValueType)std::make_pair(lhs && rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (&&)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Less: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs < rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs < rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (<)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::LessEqual: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs <= rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs <= rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (<=)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::More: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs > rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs > rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (>)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::MoreEqual: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs >= rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs >= rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (>=)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::Equal: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs == rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs == rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](bool lhs, bool rhs) {
-              return (ValueType)std::make_pair(lhs == rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](std::string& lhs, std::string& rhs) {
-              return (ValueType)std::make_pair(lhs == rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (==)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  case Expression::Operator::NotEqual: {
-    return std::visit(
-        overload{
-            [](int lhs, int rhs) {
-              return (ValueType)std::make_pair(lhs != rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](float lhs, float rhs) {
-              return (ValueType)std::make_pair(lhs != rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](bool lhs, bool rhs) {
-              return (ValueType)std::make_pair(lhs != rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](std::string &lhs, std::string &rhs) {
-              return (ValueType)std::make_pair(lhs != rhs,
-                                               Token::Type::BooleanLiteral);
-            },
-            [](const auto &lhs, const auto &rhs) {
-              throw InterpreterError("Cannot calculate (!=)!");
-              return (ValueType)std::make_pair(0, Token::Type::BadType);
-            },
-        },
-        lhsValue->first, rhsValue->first);
-  }
-  }
-  return std::nullopt;
+  inBinaryExpression.getLhs()->accept(*this);
+  if (ValueOperations::shortCircuits(inBinaryExpression.getOperator(),
+                                     result)) {
+    result = RuntimeValue(inBinaryExpression.getOperator() ==
+                          Expression::Operator::LogicalOr);
+    return Completion::Normal;
+  }
+  RuntimeValue lhs = std::move(result);
+  inBinaryExpression.getRhs()->accept(*this);
+
+  /* Operands typed by TypeInference skip the dynamic type checks */
+  switch (inBinaryExpression.getOperandType()) {
+  case RuntimeValue::Type::Int:
+    result = ValueOperations::intOperation(inBinaryExpression.getOperator(),
+                                           lhs.getInt(), result.getInt());
+    break;
+  case RuntimeValue::Type::Float:
+    result = ValueOperations::floatOperation(
+        inBinaryExpression.getOperator(), lhs.getFloat(), result.getFloat());
+    break;
+  default:
+    result = ValueOperations::binaryOperation(inBinaryExpression.getOperator(),
+                                              lhs, result);
+  }
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(const Block &inBlock) {
+Completion VisitorInterpreterImpl::visit(const Block &inBlock) {
   for (auto &instruction : inBlock.getInstructions()) {
-    auto returnValue = instruction->accept(*this);
-    if (returnValue.has_value())
-      return returnValue;
+    if (instruction->accept(*this) == Completion::Return)
+      return Completion::Return;
   }
-  return std::nullopt;
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(const Case &inCase) {
+Completion VisitorInterpreterImpl::visit(const Case &inCase) {
   return inCase.getBlock()->accept(*this);
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const Function &inFunction) {
-  std::vector<InterpreterValue> values;
-  for (size_t i = 0; i < context.argList.size(); ++i) {
-    auto result = context.argList[i]->accept(*this);
-    InterpreterValue value(result->second, result->first,
-                           inFunction.getArguments()[i]->isMutable());
-    values.emplace_back(value);
-  }
-
-  /* Default values */
-  for (size_t i = context.argList.size(); i < inFunction.getArguments().size();
-       ++i) {
-    InterpreterValue value(Token::Type::IntLiteral, 0,
-                           inFunction.getArguments()[i]->isMutable());
-    values.emplace_back(value);
-  }
-
-  /* Store and clear previous variable scope */
-  context.previousFunction = context.currentFunction;
-  context.currentFunction = &inFunction;
-  auto copyOfLocalVariables = std::move(context.copyCurrentVariablesMap());
-  context.localVariables[&inFunction].clear();
-  for (size_t i = 0; i < inFunction.getArguments().size(); ++i) {
-    context.insertLocalVariable(inFunction.getArguments()[i]->getName(),
-                                values[i]);
-  }
-
-  /* Return previous variable scope */
-  auto returnValue = inFunction.getBlock()->accept(*this);
-  context.localVariables[&inFunction] = std::move(copyOfLocalVariables);
-  context.currentFunction = context.previousFunction;
-  return returnValue;
+Completion VisitorInterpreterImpl::visit(const Function &inFunction) {
+  /* Falling off the end of a body returns nothing */
+  if (inFunction.getBlock()->accept(*this) != Completion::Return)
+    result = RuntimeValue();
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(
+Completion VisitorInterpreterImpl::visit(
     const FunctionCallExpression &inFunctionCallExpression) {
-  auto returnValue = static_cast<const InstructionFunctionCall *>(
-                         inFunctionCallExpression.getFunctionCall())
-                         ->accept(*this);
-  if (!returnValue.has_value())
+  static_cast<const InstructionFunctionCall *>(
+      inFunctionCallExpression.getFunctionCall())
+      ->accept(*this);
+  if (result.getType() == RuntimeValue::Type::Void)
     throw InterpreterError("FunctionCallExpression has to return value");
 
-  return returnValue;
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(const IfElse &inIfElse) {
-  auto result = inIfElse.getExpression()->accept(*this);
-  if (result.has_value() && result->second == Token::Type::BooleanLiteral &&
-      std::get<bool>(result->first)) {
+Completion VisitorInterpreterImpl::visit(const IfElse &inIfElse) {
+  if (testCondition(*inIfElse.getExpression(), false)) {
     return inIfElse.getBlockIf()->accept(*this);
-  } else {
+  } else if (inIfElse.getBlockElse()) {
     return inIfElse.getBlockElse()->accept(*this);
   }
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const InstructionAssigment &inAssigment) {
   const std::string name = inAssigment.getVariable()->toString();
-  if (!context.containsVariableWithName(name))
+  const size_t slot = inAssigment.getVariable()->getSlot();
+  const auto &variable = context.getLocalVariable(slot);
+  if (!variable)
     throw InterpreterError("Variable " + name + " is not declared!");
-
-  const auto &variable = context.findVariableWithName(name);
   if (!variable->isMutable())
     throw InterpreterError("Not mutable variable " + name +
                            " cannot be modified!");
 
-  auto result = inAssigment.getExpression()->accept(*this);
-  InterpreterValue value(result->second, result->first, variable->isMutable());
-  context.replaceLocalVariable(name, value);
-  return std::nullopt;
+  inAssigment.getExpression()->accept(*this);
+  context.getLocalVariable(slot) = InterpreterValue(std::move(result), true);
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(
+Completion VisitorInterpreterImpl::visit(
     const InstructionDeclarationVariable &inDeclarationVariable) {
-  std::string name = inDeclarationVariable.getIdentifier();
-  if (context.containsVariableWithName(name))
-    throw InterpreterError("New declaration of local variable named " + name +
-                           " found!");
+  const size_t slot = inDeclarationVariable.getSlot();
+  if (context.getLocalVariable(slot))
+    throw InterpreterError("New declaration of local variable named " +
+                           inDeclarationVariable.getIdentifier() + " found!");
 
   if (inDeclarationVariable.getExpression()) {
-    auto result = inDeclarationVariable.getExpression()->accept(*this);
-    InterpreterValue value(result->second, result->first,
-                           inDeclarationVariable.isMutable());
-    context.insertLocalVariable(name, value);
+    inDeclarationVariable.getExpression()->accept(*this);
+    context.getLocalVariable(slot) = InterpreterValue(
+        std::move(result), inDeclarationVariable.isMutable());
   } else {
-    InterpreterValue value(Token::Type::IntLiteral, 0,
-                           inDeclarationVariable.isMutable());
-    context.insertLocalVariable(name, value);
+    context.getLocalVariable(slot) = InterpreterValue(
+        RuntimeValue(0), inDeclarationVariable.isMutable());
   }
 
-  return std::nullopt;
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const InstructionFunctionCall &inFunctionCall) {
-  std::string name = inFunctionCall.getFunctionName();
-  auto function = context.findFunction(name);
-  if (function == nullptr)
-    throw InterpreterError("No function found with such name: " + name + "!");
-  if (function->getArguments().size() != inFunctionCall.getExpressions().size())
-    throw InterpreterError("Invalid number of arguments for function " + name +
-                           "!");
-
-  context.argList.clear();
-  for (const auto &argument : inFunctionCall.getExpressions()) {
-    context.argList.push_back(argument.get());
+  const Function *function = &findCallee(inFunctionCall);
+  size_t frame = evaluateArguments(inFunctionCall, *function);
+  const auto &arguments = inFunctionCall.getExpressions();
+
+  /* Memoized functions return the cached result for scalar arguments seen
+   * before, the frame is entered and left only to release it */
+  MemoTable *memoTable = nullptr;
+  MemoTable::Key key;
+  if (function->isMemoized()) {
+    bool bIsScalar = true;
+    for (size_t i = 0; i < arguments.size() && bIsScalar; ++i) {
+      bIsScalar = MemoTable::appendKey(
+          context.getFrameSlot(frame, i)->getValue(), key);
+    }
+    if (bIsScalar) {
+      memoTable = &memoTables[function];
+      if (const RuntimeValue *value = memoTable->find(key)) {
+        result = *value;
+        ++memoizedCallCount;
+        context.enterFrame(frame);
+        context.leaveFrame();
+        return Completion::Normal;
+      }
+    }
   }
-  return function->accept(*this);
 
-  return std::nullopt;
+  /* The returned value is left in result. Builtins call nothing back, so as
+   * in the other engines they do not count towards the depth. */
+  if (function->getBlock())
+    checkCallDepth(context.getDepth(), maxCallDepth);
+  context.enterFrame(frame);
+  NativeStack::call([&]() {
+    invoke(*function);
+    runTailCalls();
+  });
+  context.leaveFrame();
+  if (memoTable)
+    memoTable->insert(key, result);
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const IntFunction &inIntFunction) {
-  auto expressionValue = context.argList[0]->accept(*this);
-  return std::visit(
-      overload{
-          [](std::string &in) {
-            return ValueType(stoi(in), Token::Type::IntLiteral);
-          },
-          [](float in) { return ValueType((int)in, Token::Type::IntLiteral); },
-          [expressionValue](int in) { return *expressionValue; },
-          [](bool in) { return ValueType((int)in, Token::Type::IntLiteral); },
-      },
-      expressionValue->first);
+Completion VisitorInterpreterImpl::visit(const IntFunction &inIntFunction) {
+  result = ValueOperations::toInt(context.getLocalVariable(0)->getValue());
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const StringFunction &inStringFunction) {
-  auto expressionValue = context.argList[0]->accept(*this);
-  return std::visit(
-      overload{
-          [expressionValue](std::string &in) { return *expressionValue; },
-          [](float in) {
-            return ValueType(std::to_string(in), Token::Type::StringLiteral);
-          },
-          [](int in) {
-            return ValueType(std::to_string(in), Token::Type::StringLiteral);
-          },
-          [](bool in) {
-            return ValueType(in == true ? "true" : "false",
-                             Token::Type::StringLiteral);
-          },
-      },
-      expressionValue->first);
+  result = ValueOperations::toString(context.getLocalVariable(0)->getValue());
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const FloatFunction &inFloatFunction) {
-  auto expressionValue = context.argList[0]->accept(*this);
-  return std::visit(
-      overload{
-          [](std::string &in) {
-            return ValueType(std::stof(in), Token::Type::FloatLiteral);
-          },
-          [expressionValue](float in) { return *expressionValue; },
-          [](int in) {
-            return ValueType((float)in, Token::Type::FloatLiteral);
-          },
-          [](bool in) {
-            return ValueType((float)in, Token::Type::FloatLiteral);
-          },
-      },
-      expressionValue->first);
+Completion VisitorInterpreterImpl::visit(const FloatFunction &inFloatFunction) {
+  result = ValueOperations::toFloat(context.getLocalVariable(0)->getValue());
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const BoolFunction &inBoolFunction) {
-  auto expressionValue = context.argList[0]->accept(*this);
-  return std::visit(
-      overload{
-          [](std::string &in) {
-            if (in == "true")
-              return ValueType(true, Token::Type::BooleanLiteral);
-            if (in == "false")
-              return ValueType(false, Token::Type::BooleanLiteral);
-            throw InterpreterError("Cannot convert string to bool!");
-          },
-          [](float in) {
-            return ValueType(in > 0.0 ? true : false,
-                             Token::Type::BooleanLiteral);
-          },
-          [](int in) {
-            return ValueType(in > 0 ? true : false,
-                             Token::Type::BooleanLiteral);
-          },
-          [expressionValue](bool in) { return *expressionValue; },
-      },
-      expressionValue->first);
+Completion VisitorInterpreterImpl::visit(const BoolFunction &inBoolFunction) {
+  result = ValueOperations::toBool(context.getLocalVariable(0)->getValue());
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const PrintFunction &inPrintFunction) {
-  auto expressionValue = context.argList[0]->accept(*this);
-  std::visit(overload{
-                 [](std::string &in) { std::cout << in; },
-                 [](float in) { std::cout << in; },
-                 [](int in) { std::cout << in; },
-                 [](bool in) { std::cout << std::to_string(in); },
-             },
-             expressionValue->first);
-  return std::nullopt;
+Completion VisitorInterpreterImpl::visit(const PrintFunction &inPrintFunction) {
+  ValueOperations::print(context.getLocalVariable(0)->getValue());
+  result = RuntimeValue();
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
-VisitorInterpreterImpl::visit(const InstructionReturn &inReturn) {
+Completion VisitorInterpreterImpl::visit(const InstructionReturn &inReturn) {
+  /* A returned call reuses the frame of the caller and is made by
+   * runTailCalls() once this function has returned. It bypasses the memo
+   * tables, which are filled by the calls that are not returned. */
+  if (auto *callExpression = dynamic_cast<const FunctionCallExpression *>(
+          inReturn.getExpression())) {
+    const auto &call = *static_cast<const InstructionFunctionCall *>(
+        callExpression->getFunctionCall());
+    const Function &function = findCallee(call);
+    context.replaceFrame(evaluateArguments(call, function));
+    tailCallee = &function;
+    return Completion::Return;
+  }
+
   if (inReturn.getExpression())
-    return inReturn.getExpression()->accept(*this);
-  return std::nullopt;
+    inReturn.getExpression()->accept(*this);
+  else
+    result = RuntimeValue();
+  return Completion::Return;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(const Match &inMatch) {
-  auto result = inMatch.getExpression()->accept(*this);
-  auto returnValue = std::optional<ValueType>(std::nullopt);
-  context.matchVariableName = inMatch.getExpression()->toString();
+Completion VisitorInterpreterImpl::visit(const Match &inMatch) {
+  /* '_' inside the cases reads the subject from its hidden slot */
+  inMatch.getExpression()->accept(*this);
+  context.getLocalVariable(inMatch.getSlot()) =
+      InterpreterValue(std::move(result), false);
 
-  const auto &localVariable =
-      context.findVariableWithName(*context.matchVariableName);
-
-  /* Input variable to the context if it doesn't exists */
-  if (!localVariable) {
-    InterpreterValue value(result->second, result->first, false);
-    context.insertLocalVariable(*context.matchVariableName, value);
+  if (const MatchDispatch *dispatch = inMatch.getDispatch()) {
+    size_t index = dispatch->find(
+        context.getLocalVariable(inMatch.getSlot())->getValue());
+    if (index == MatchDispatch::NoCase)
+      return Completion::Normal;
+    return inMatch.getCases()[index]->accept(*this);
   }
 
   for (const auto &caseInstruction : inMatch.getCases()) {
-    auto caseExpressionResult = caseInstruction->getExpression()->accept(*this);
-    if ((caseExpressionResult->second == Token::Type::BooleanLiteral &&
-         std::get<bool>(caseExpressionResult->first)) ||
-        (*result == *caseExpressionResult)) {
-      auto caseReturn = caseInstruction->accept(*this);
-      if (caseReturn.has_value()) {
-        returnValue = caseReturn;
-      }
-      break;
-    }
+    caseInstruction->getExpression()->accept(*this);
+    if (ValueOperations::matchesCase(
+            context.getLocalVariable(inMatch.getSlot())->getValue(), result))
+      return caseInstruction->accept(*this);
   }
-  context.matchVariableName = std::nullopt;
-  return returnValue;
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const UnaryExpression &inUnaryExpression) {
-  auto result = inUnaryExpression.getExpression()->accept(*this);
-  if (result->second == Token::Type::FloatLiteral) {
-    return std::make_pair(-std::get<float>(result->first), result->second);
-  }
-  if (result->second == Token::Type::IntLiteral) {
-    return std::make_pair(-std::get<int>(result->first), result->second);
-  }
-  if (result->second == Token::Type::BooleanLiteral) {
-    if (std::get<bool>(result->first))
-      return std::make_pair(false, result->second);
-    return std::make_pair(true, result->second);
-  }
-  throw InterpreterError("Invalid expression type!");
+  inUnaryExpression.getExpression()->accept(*this);
+  switch (inUnaryExpression.getOperandType()) {
+  case RuntimeValue::Type::Int:
+    result = RuntimeValue(-result.getInt());
+    break;
+  case RuntimeValue::Type::Float:
+    result = RuntimeValue(-result.getFloat());
+    break;
+  default:
+    result = ValueOperations::unaryOperation(result);
+  }
+  return Completion::Normal;
 }
 
-std::optional<ValueType>
+Completion
 VisitorInterpreterImpl::visit(const VariableExpression &inVariableExpression) {
   const auto &variable = inVariableExpression.getVariable();
   if (const auto &value = variable->getValue()) {
-    return std::make_pair(value->getValue(), value->getType());
+    result = value->getRuntimeValue();
+    return Completion::Normal;
   }
 
-  auto name = *inVariableExpression.getVariable()->getName();
-  if (name == "_" && context.matchVariableName.has_value()) {
-    name = *context.matchVariableName;
-  }
-
-  const auto &localVariable = context.findVariableWithName(name);
-
+  const auto &localVariable = context.getLocalVariable(variable->getSlot());
   if (!localVariable)
     throw InterpreterError("No variable with such name " +
                            *inVariableExpression.getVariable()->getName() +
                            "!");
 
-  return std::make_pair(localVariable->getValue(), localVariable->getType());
+  result = localVariable->getValue();
+  return Completion::Normal;
 }
 
-std::optional<ValueType> VisitorInterpreterImpl::visit(const While &inWhile) {
-  auto result = inWhile.getExpression()->accept(*this);
-  if (result->second == Token::Type::BooleanLiteral) {
-    while (isWhileExpressionTrue(*result)) {
-      auto returnValue = inWhile.getBody()->accept(*this);
-      result = inWhile.getExpression()->accept(*this);
-      if (returnValue.has_value())
-        return returnValue;
-    }
-  } else {
-    throw InterpreterError("Invalid expression type in while!");
+Completion VisitorInterpreterImpl::visit(const While &inWhile) {
+  while (testCondition(*inWhile.getExpression(), true)) {
+    if (inWhile.getBody()->accept(*this) == Completion::Return)
+      return Completion::Return;
   }
-  return std::nullopt;
+  return Completion::Normal;
 }
 
-bool VisitorInterpreterImpl::isWhileExpressionTrue(
-    const ValueType &inValueType) const {
-  if (inValueType.second == Token::Type::StringLiteral) {
-    auto stringValue = std::get<std::string>(inValueType.first);
-    if (!context.containsVariableWithName(stringValue))
-      throw InterpreterError(
-          "No variable with such name as in while expression!");
-
-    const auto &variable = context.findVariableWithName(stringValue);
-    return isValueTypeTrue(
-        std::make_pair(variable->getValue(), variable->getType()));
+const Function &VisitorInterpreterImpl::findCallee(
+    const InstructionFunctionCall &inFunctionCall) const {
+  const std::string &name = inFunctionCall.getFunctionName();
+  auto function = context.findFunction(name);
+  if (function == nullptr)
+    throw InterpreterError("No function found with such name: " + name + "!");
+  if (function->getArguments().size() != inFunctionCall.getExpressions().size())
+    throw InterpreterError("Invalid number of arguments for function " + name +
+                           "!");
+  return *function;
+}
+
+size_t VisitorInterpreterImpl::evaluateArguments(
+    const InstructionFunctionCall &inFunctionCall, const Function &inFunction) {
+  /* Arguments are evaluated in the caller straight into the parameter slots
+   * of the callee frame, which becomes current only afterwards */
+  size_t frame = context.allocateFrame(inFunction);
+  const auto &arguments = inFunctionCall.getExpressions();
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    arguments[i]->accept(*this);
+    context.getFrameSlot(frame, i) = InterpreterValue(
+        std::move(result), inFunction.getArguments()[i]->isMutable());
+  }
+  return frame;
+}
+
+void VisitorInterpreterImpl::invoke(const Function &inFunction) {
+  if (auto value = jit ? jit->call(inFunction, maxCallDepth)
+                          : std::nullopt)
+    result = std::move(*value);
+  else
+    inFunction.accept(*this);
+}
+
+void VisitorInterpreterImpl::runTailCalls() {
+  if (!tailCallee)
+    return;
+
+  while (const Function *function = tailCallee) {
+    tailCallee = nullptr;
+    invoke(*function);
   }
+  /* A returned call is an expression, checked once the last callee is done */
+  if (result.getType() == RuntimeValue::Type::Void)
+    throw InterpreterError("FunctionCallExpression has to return value");
+}
 
-  return isValueTypeTrue(inValueType);
+bool VisitorInterpreterImpl::isWhileExpressionTrue(
+    const RuntimeValue &inValue) const {
+  if (inValue.getType() != RuntimeValue::Type::Bool)
+    throw InterpreterError("Invalid expression type in while!");
+  return inValue.getBool();
 }
 
-bool VisitorInterpreterImpl::isValueTypeTrue(
-    const ValueType &inValueType) const {
-  return std::visit(overload{
-                        [](std::string in) { return false; },
-                        [](float in) { return (bool)in; },
-                        [](int in) { return (bool)in; },
-                        [](bool in) { return in; },
-                    },
-                    inValueType.first);
+bool VisitorInterpreterImpl::testCondition(const Expression &inCondition,
+                                           bool bRequireBool) {
+  /* Comparisons, and || and && over bools, branch on their operands without
+   * building the bool */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isBoolLogical()) {
+    const bool bIsOr =
+        binaryExpression->getOperator() == Expression::Operator::LogicalOr;
+    if (testCondition(*binaryExpression->getLhs(), bRequireBool) == bIsOr)
+      return bIsOr;
+    return testCondition(*binaryExpression->getRhs(), bRequireBool);
+  }
+  if (binaryExpression && binaryExpression->isComparison()) {
+    binaryExpression->getLhs()->accept(*this);
+    RuntimeValue lhs = std::move(result);
+    binaryExpression->getRhs()->accept(*this);
+    switch (binaryExpression->getOperandType()) {
+    case RuntimeValue::Type::Int:
+      return ValueOperations::compareNumbers(binaryExpression->getOperator(),
+                                             lhs.getInt(), result.getInt());
+    case RuntimeValue::Type::Float:
+      return ValueOperations::compareNumbers(binaryExpression->getOperator(),
+                                             lhs.getFloat(), result.getFloat());
+    default:
+      return ValueOperations::compare(binaryExpression->getOperator(), lhs,
+                                      result);
+    }
+  }
+
+  inCondition.accept(*this);
+  return bRequireBool ? isWhileExpressionTrue(result)
+                      : ValueOperations::isTrue(result);
 }
@@ -1,52 +1,73 @@
 #pragma once
 
+#include "Interpreter.h"
+#include "MemoTable.h"
 #include "VisitorInterpreter.h"
+#include "../jit/Jit.h"
 #include <optional>
 #include <memory>
+#include <unordered_map>
 
-class VisitorInterpreterImpl : public VisitorInterpreter {
+class VisitorInterpreterImpl : public VisitorInterpreter, public Interpreter {
 public:
   explicit VisitorInterpreterImpl(std::unique_ptr<class Parser> inParser);
+  /* Functions called inJitThreshold times are compiled to native code */
+  VisitorInterpreterImpl(std::unique_ptr<class Parser> inParser,
+                         size_t inJitThreshold);
   virtual std::optional<ValueType> execute() override;
-  virtual std::optional<ValueType>
-  visit(const class Program &inProgram) override;
-  virtual std::optional<ValueType>
+  /* nullptr unless constructed with a JIT threshold */
+  const Jit *getJit() const;
+  /* Calls answered from the memo tables of pure recursive functions */
+  size_t getMemoizedCallCount() const;
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
   visit(const class BinaryExpression &inBinaryExpression) override;
-  virtual std::optional<ValueType> visit(const class Block &inBlock) override;
-  virtual std::optional<ValueType> visit(const class Case &inCase) override;
-  virtual std::optional<ValueType>
-  visit(const class Function &inFunction) override;
-  virtual std::optional<ValueType> visit(
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
       const class FunctionCallExpression &inFunctionCallExpression) override;
-  virtual std::optional<ValueType> visit(const class IfElse &inIfElse) override;
-  virtual std::optional<ValueType>
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
   visit(const class InstructionAssigment &inAssigment) override;
-  virtual std::optional<ValueType> visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
       override;
-  virtual std::optional<ValueType>
+  virtual Completion
   visit(const class InstructionFunctionCall &inFunctionCall) override;
-  virtual std::optional<ValueType>
-  visit(const class IntFunction &inIntFunction) override;
-  virtual std::optional<ValueType>
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
   visit(const class StringFunction &inStringFunction) override;
-  virtual std::optional<ValueType>
-  visit(const class FloatFunction &inFloatFunction) override;
-  virtual std::optional<ValueType>
-  visit(const class BoolFunction &inBoolFunction) override;
-  virtual std::optional<ValueType>
-  visit(const class PrintFunction &inPrintFunction) override;
-  virtual std::optional<ValueType>
-  visit(const class InstructionReturn &inReturn) override;
-  virtual std::optional<ValueType> visit(const class Match &inMatch) override;
-  virtual std::optional<ValueType>
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
   visit(const class UnaryExpression &inUnaryExpression) override;
-  virtual std::optional<ValueType>
+  virtual Completion
   visit(const class VariableExpression &inVariableExpression) override;
-  virtual std::optional<ValueType> visit(const class While &inWhile) override;
+  virtual Completion visit(const class While &inWhile) override;
 
 private:
-  bool isWhileExpressionTrue(const ValueType &inValueType) const;
-  bool isValueTypeTrue(const ValueType &inValueType) const;
+  const class Function &
+  findCallee(const class InstructionFunctionCall &inFunctionCall) const;
+  /* Evaluates the arguments into a new frame for inFunction, returns it */
+  size_t evaluateArguments(const class InstructionFunctionCall &inFunctionCall,
+                           const class Function &inFunction);
+  /* Runs inFunction in the current frame, natively once hot */
+  void invoke(const class Function &inFunction);
+  /* Runs the returned calls left behind by the function that just ran */
+  void runTailCalls();
+  bool isWhileExpressionTrue(const RuntimeValue &inValue) const;
+  /* Truth of a condition, which has to be a bool with bRequireBool */
+  bool testCondition(const class Expression &inCondition, bool bRequireBool);
   std::unique_ptr<Parser> parser;
   Context context;
+  /* Value of the last evaluated expression or of the last call */
+  RuntimeValue result;
+  std::unique_ptr<Jit> jit;
+  std::unordered_map<const class Function *, MemoTable> memoTables;
+  size_t memoizedCallCount = 0;
+  /* Callee of a return in tail position, its frame replaced the current */
+  const class Function *tailCallee = nullptr;
 };
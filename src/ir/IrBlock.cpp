@@ -0,0 +1,90 @@
+#include "IrBlock.h"
+#include <algorithm>
+
+IrBlock::IrBlock(size_t inId) : id(inId) {}
+
+size_t IrBlock::getId() const { return id; }
+
+void IrBlock::setId(size_t inId) { id = inId; }
+
+const std::vector<std::unique_ptr<IrInstruction>> &
+IrBlock::getInstructions() const {
+  return instructions;
+}
+
+IrInstruction *IrBlock::append(std::unique_ptr<IrInstruction> inInstruction) {
+  inInstruction->setBlock(this);
+  instructions.push_back(std::move(inInstruction));
+  return instructions.back().get();
+}
+
+IrInstruction *IrBlock::insert(size_t inPosition,
+                               std::unique_ptr<IrInstruction> inInstruction) {
+  inInstruction->setBlock(this);
+  return instructions.insert(instructions.begin() + inPosition,
+                             std::move(inInstruction))
+      ->get();
+}
+
+std::unique_ptr<IrInstruction>
+IrBlock::remove(const IrInstruction *inInstruction) {
+  auto it = std::find_if(instructions.begin(), instructions.end(),
+                         [inInstruction](const auto &inCandidate) {
+                           return inCandidate.get() == inInstruction;
+                         });
+  auto removed = std::move(*it);
+  instructions.erase(it);
+  return removed;
+}
+
+void IrBlock::splice(IrBlock &inOther) {
+  for (auto &instruction : inOther.instructions) {
+    append(std::move(instruction));
+  }
+  inOther.instructions.clear();
+}
+
+IrInstruction *IrBlock::getTerminator() const {
+  if (instructions.empty() || !instructions.back()->isTerminator())
+    return nullptr;
+  return instructions.back().get();
+}
+
+const std::vector<IrBlock *> &IrBlock::getPredecessors() const {
+  return predecessors;
+}
+
+void IrBlock::addPredecessor(IrBlock *inPredecessor) {
+  predecessors.push_back(inPredecessor);
+}
+
+void IrBlock::removePredecessor(const IrBlock *inPredecessor) {
+  auto it = std::find(predecessors.begin(), predecessors.end(), inPredecessor);
+  const size_t index = it - predecessors.begin();
+  predecessors.erase(it);
+  for (const auto &instruction : instructions) {
+    if (instruction->getOpCode() == IrOpCode::Phi)
+      instruction->removeOperand(index);
+  }
+}
+
+void IrBlock::replacePredecessor(const IrBlock *inPredecessor,
+                                 IrBlock *inReplacement) {
+  std::replace(predecessors.begin(), predecessors.end(),
+               const_cast<IrBlock *>(inPredecessor), inReplacement);
+}
+
+std::string IrBlock::toString() const {
+  std::string result = "bb" + std::to_string(id) + ":";
+  if (!predecessors.empty()) {
+    result += " ; from";
+    for (const IrBlock *predecessor : predecessors) {
+      result += " bb" + std::to_string(predecessor->getId());
+    }
+  }
+  result += "\n";
+  for (const auto &instruction : instructions) {
+    result += instruction->toString() + "\n";
+  }
+  return result;
+}
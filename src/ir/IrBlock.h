@@ -0,0 +1,36 @@
+#pragma once
+#include "IrInstruction.h"
+#include <memory>
+#include <vector>
+
+/* Basic block of the SSA form. Phis come first and a terminator last, the
+ * operands of every phi follow the order of the predecessors. */
+class IrBlock {
+public:
+  explicit IrBlock(size_t inId);
+
+  size_t getId() const;
+  void setId(size_t inId);
+  const std::vector<std::unique_ptr<IrInstruction>> &getInstructions() const;
+  IrInstruction *append(std::unique_ptr<IrInstruction> inInstruction);
+  IrInstruction *insert(size_t inPosition,
+                        std::unique_ptr<IrInstruction> inInstruction);
+  std::unique_ptr<IrInstruction> remove(const IrInstruction *inInstruction);
+  /* Moves every instruction of inOther to the end of this block */
+  void splice(IrBlock &inOther);
+  /* Null while the block is still being built */
+  IrInstruction *getTerminator() const;
+
+  const std::vector<IrBlock *> &getPredecessors() const;
+  void addPredecessor(IrBlock *inPredecessor);
+  /* Drops the predecessor and its operand of every phi */
+  void removePredecessor(const IrBlock *inPredecessor);
+  void replacePredecessor(const IrBlock *inPredecessor,
+                          IrBlock *inReplacement);
+  std::string toString() const;
+
+private:
+  size_t id;
+  std::vector<std::unique_ptr<IrInstruction>> instructions;
+  std::vector<IrBlock *> predecessors;
+};
@@ -0,0 +1,598 @@
+#include "IrBuilder.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "../interpreter/InterpreterError.h"
+#include <algorithm>
+#include <cmath>
+
+std::unique_ptr<IrProgram> IrBuilder::build(const Program &inProgram) {
+  context.reset();
+  program = std::make_unique<IrProgram>();
+  inProgram.accept(*this);
+  return std::move(program);
+}
+
+Completion IrBuilder::visit(const Program &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &functionName = function->getIdentifier();
+    if (context.findFunction(functionName) != nullptr)
+      throw InterpreterError("Redefinition of function with name " +
+                             functionName + "!");
+    context.insertFunction(function.get());
+  }
+
+  for (const auto &function : inProgram.getFunctions()) {
+    buildFunction(*function);
+  }
+  return Completion::Normal;
+}
+
+void IrBuilder::buildFunction(const Function &inFunction) {
+  currentFunction = program->addFunction(
+      std::make_unique<IrFunction>(inFunction.getIdentifier()));
+  definitions.clear();
+  incompletePhis.clear();
+  sealedBlocks.clear();
+  declaredVariables.clear();
+  matchSubjects.clear();
+  constants.clear();
+  headerSize = 0;
+  undefined = nullptr;
+
+  currentBlock = currentFunction->createBlock();
+  sealBlock(currentBlock);
+  const auto &arguments = inFunction.getArguments();
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const std::string &name = arguments[i]->getName();
+    currentFunction->addParameter(name, arguments[i]->isMutable());
+    auto parameter = std::make_unique<IrInstruction>(IrOpCode::Parameter);
+    parameter->setIndex(i);
+    parameter->setName(name);
+    writeVariable(name, currentBlock, addHeader(std::move(parameter)));
+    writeVariable(getFlagName(name), currentBlock,
+                  getConstant(RuntimeValue(arguments[i]->isMutable())));
+    declaredVariables[name] = arguments[i]->isMutable();
+  }
+
+  inFunction.getBlock()->accept(*this);
+  if (currentBlock)
+    terminate(IrOpCode::ReturnVoid, {}, {});
+
+  currentFunction->removeUnreachableBlocks();
+  if (undefined && !currentFunction->isUsed(undefined))
+    currentFunction->getEntry()->remove(undefined);
+  removedPhis.clear();
+  removed.clear();
+  currentFunction->inferTypes();
+}
+
+IrInstruction *IrBuilder::buildExpression(const Expression &inExpression) {
+  inExpression.accept(*this);
+  return result;
+}
+
+void IrBuilder::buildNestedBlock(const Block &inBlock) {
+  /* Declarations inside a nested block are not guaranteed after it */
+  auto savedDeclaredVariables = declaredVariables;
+  inBlock.accept(*this);
+  declaredVariables = std::move(savedDeclaredVariables);
+}
+
+Completion IrBuilder::visit(const BinaryExpression &inBinaryExpression) {
+  IrInstruction *lhs = buildExpression(*inBinaryExpression.getLhs());
+
+  /* Binary opcodes are laid out in Expression::Operator order */
+  auto opCode = static_cast<IrOpCode>(
+      static_cast<int>(IrOpCode::Sum) +
+      static_cast<int>(inBinaryExpression.getOperator()));
+  if (opCode > IrOpCode::NotEqual)
+    throw InterpreterError("Invalid binary operator!");
+  if (!inBinaryExpression.isLogical()) {
+    IrInstruction *rhs = buildExpression(*inBinaryExpression.getRhs());
+    result = emit(opCode, {lhs, rhs});
+    return Completion::Normal;
+  }
+
+  /* The rhs gets its own block, both results meet in a phi of a hidden
+   * variable */
+  const bool bIsOr = opCode == IrOpCode::LogicalOr;
+  const std::string name = "?" + std::to_string(logicalCount++);
+  IrBlock *rhsBlock = currentFunction->createBlock();
+  IrBlock *endBlock = currentFunction->createBlock();
+  writeVariable(name, getBlock(), getConstant(RuntimeValue(bIsOr)));
+  terminate(bIsOr ? IrOpCode::ShortCircuitOr : IrOpCode::ShortCircuitAnd,
+            {lhs}, {endBlock, rhsBlock});
+
+  sealBlock(rhsBlock);
+  currentBlock = rhsBlock;
+  IrInstruction *rhs = buildExpression(*inBinaryExpression.getRhs());
+  if (currentBlock) {
+    writeVariable(name, currentBlock, emit(opCode, {lhs, rhs}));
+    terminate(IrOpCode::Jump, {}, {endBlock});
+  }
+
+  sealBlock(endBlock);
+  currentBlock = endBlock;
+  result = readVariable(name, endBlock);
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    /* Code after a return or a throw is never reached */
+    if (!currentBlock || (currentBlock != currentFunction->getEntry() &&
+                          currentBlock->getPredecessors().empty()))
+      break;
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const Case &inCase) {
+  buildNestedBlock(*inCase.getBlock());
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const Function &inFunction) {
+  result = emit(IrOpCode::Call, callArguments);
+  result->setName(inFunction.getIdentifier());
+  return Completion::Normal;
+}
+
+Completion
+IrBuilder::visit(const FunctionCallExpression &inFunctionCallExpression) {
+  IrInstruction *value =
+      buildCall(*static_cast<const InstructionFunctionCall *>(
+          inFunctionCallExpression.getFunctionCall()));
+  if (!value) {
+    emitThrow("FunctionCallExpression has to return value");
+    result = getUndefined();
+    return Completion::Normal;
+  }
+  if (value->getOpCode() == IrOpCode::Call)
+    emit(IrOpCode::RequireValue, {value});
+  result = value;
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const IfElse &inIfElse) {
+  IrBlock *ifBlock = currentFunction->createBlock();
+  IrBlock *elseBlock =
+      inIfElse.getBlockElse() ? currentFunction->createBlock() : nullptr;
+  IrBlock *endBlock = currentFunction->createBlock();
+  buildBranch(*inIfElse.getExpression(), IrOpCode::Branch, ifBlock,
+              elseBlock ? elseBlock : endBlock);
+
+  sealBlock(ifBlock);
+  currentBlock = ifBlock;
+  buildNestedBlock(*inIfElse.getBlockIf());
+  if (currentBlock)
+    terminate(IrOpCode::Jump, {}, {endBlock});
+  if (elseBlock) {
+    sealBlock(elseBlock);
+    currentBlock = elseBlock;
+    buildNestedBlock(*inIfElse.getBlockElse());
+    if (currentBlock)
+      terminate(IrOpCode::Jump, {}, {endBlock});
+  }
+
+  sealBlock(endBlock);
+  currentBlock = endBlock->getPredecessors().empty() ? nullptr : endBlock;
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const InstructionAssigment &inAssigment) {
+  const std::string name = inAssigment.getVariable()->toString();
+  auto declared = declaredVariables.find(name);
+  if (declared == declaredVariables.end()) {
+    emitCheck(IrOpCode::CheckAssignable, name,
+              readVariable(getFlagName(name), getBlock()));
+    declaredVariables[name] = true;
+  } else if (!declared->second) {
+    emitThrow("Not mutable variable " + name + " cannot be modified!");
+    return Completion::Normal;
+  }
+
+  IrInstruction *value = buildExpression(*inAssigment.getExpression());
+  writeVariable(name, getBlock(), value);
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  const std::string &name = inDeclarationVariable.getIdentifier();
+  if (declaredVariables.count(name)) {
+    emitThrow("New declaration of local variable named " + name + " found!");
+    return Completion::Normal;
+  }
+  emitCheck(IrOpCode::CheckUndeclared, name,
+            readVariable(getFlagName(name), getBlock()));
+
+  IrInstruction *value = inDeclarationVariable.getExpression()
+                             ? buildExpression(
+                                   *inDeclarationVariable.getExpression())
+                             : getConstant(RuntimeValue(0));
+  writeVariable(name, getBlock(), value);
+  writeVariable(getFlagName(name), getBlock(),
+                getConstant(RuntimeValue(inDeclarationVariable.isMutable())));
+  declaredVariables[name] = inDeclarationVariable.isMutable();
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const InstructionFunctionCall &inFunctionCall) {
+  buildCall(inFunctionCall);
+  return Completion::Normal;
+}
+
+IrInstruction *
+IrBuilder::buildCall(const InstructionFunctionCall &inFunctionCall) {
+  const std::string &name = inFunctionCall.getFunctionName();
+  auto function = context.findFunction(name);
+  if (function == nullptr) {
+    emitThrow("No function found with such name: " + name + "!");
+    return getUndefined();
+  }
+  const auto &arguments = inFunctionCall.getExpressions();
+  if (function->getArguments().size() != arguments.size()) {
+    emitThrow("Invalid number of arguments for function " + name + "!");
+    return getUndefined();
+  }
+
+  std::vector<IrInstruction *> values;
+  for (const auto &argument : arguments) {
+    values.push_back(buildExpression(*argument));
+  }
+  callArguments = std::move(values);
+  if (!function->getBlock())
+    callArgument = callArguments[0];
+  function->accept(*this);
+  return result;
+}
+
+Completion IrBuilder::visit(const IntFunction &inIntFunction) {
+  result = emit(IrOpCode::ToInt, {callArgument});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const StringFunction &inStringFunction) {
+  result = emit(IrOpCode::ToString, {callArgument});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const FloatFunction &inFloatFunction) {
+  result = emit(IrOpCode::ToFloat, {callArgument});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const BoolFunction &inBoolFunction) {
+  result = emit(IrOpCode::ToBool, {callArgument});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const PrintFunction &inPrintFunction) {
+  emit(IrOpCode::Print, {callArgument});
+  result = nullptr;
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const InstructionReturn &inReturn) {
+  if (inReturn.getExpression())
+    terminate(IrOpCode::Return, {buildExpression(*inReturn.getExpression())},
+              {});
+  else
+    terminate(IrOpCode::ReturnVoid, {}, {});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const Match &inMatch) {
+  /* '_' inside the cases reads the subject */
+  matchSubjects.push_back(buildExpression(*inMatch.getExpression()));
+  IrBlock *endBlock = currentFunction->createBlock();
+
+  /* Literal cases switch straight to the block of the case taken */
+  if (const MatchDispatch *dispatch = inMatch.getDispatch()) {
+    std::vector<IrBlock *> caseBlocks;
+    for (size_t i = 0; i < inMatch.getCases().size(); ++i) {
+      caseBlocks.push_back(currentFunction->createBlock());
+    }
+    caseBlocks.push_back(endBlock);
+    terminate(IrOpCode::Switch, {matchSubjects.back()}, caseBlocks)
+        ->setDispatch(dispatch);
+    for (size_t i = 0; i < inMatch.getCases().size(); ++i) {
+      sealBlock(caseBlocks[i]);
+      currentBlock = caseBlocks[i];
+      inMatch.getCases()[i]->accept(*this);
+      if (currentBlock)
+        terminate(IrOpCode::Jump, {}, {endBlock});
+    }
+
+    sealBlock(endBlock);
+    currentBlock = endBlock;
+    matchSubjects.pop_back();
+    return Completion::Normal;
+  }
+
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    IrInstruction *caseValue =
+        buildExpression(*caseInstruction->getExpression());
+    IrInstruction *matched =
+        emit(IrOpCode::MatchCase, {matchSubjects.back(), caseValue});
+    IrBlock *caseBlock = currentFunction->createBlock();
+    IrBlock *nextBlock = currentFunction->createBlock();
+    terminate(IrOpCode::Branch, {matched}, {caseBlock, nextBlock});
+
+    sealBlock(caseBlock);
+    currentBlock = caseBlock;
+    caseInstruction->accept(*this);
+    if (currentBlock)
+      terminate(IrOpCode::Jump, {}, {endBlock});
+    sealBlock(nextBlock);
+    currentBlock = nextBlock;
+  }
+  terminate(IrOpCode::Jump, {}, {endBlock});
+
+  sealBlock(endBlock);
+  currentBlock = endBlock;
+  matchSubjects.pop_back();
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const UnaryExpression &inUnaryExpression) {
+  result = emit(IrOpCode::Negation,
+                {buildExpression(*inUnaryExpression.getExpression())});
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  if (const auto &value = variable->getValue()) {
+    result = getConstant(value->getRuntimeValue());
+    return Completion::Normal;
+  }
+
+  const std::string &name = *variable->getName();
+  if (name == "_" && !matchSubjects.empty()) {
+    result = matchSubjects.back();
+    return Completion::Normal;
+  }
+  if (!declaredVariables.count(name))
+    emitCheck(IrOpCode::CheckDeclared, name,
+              readVariable(getFlagName(name), getBlock()));
+  result = readVariable(name, getBlock());
+  return Completion::Normal;
+}
+
+Completion IrBuilder::visit(const While &inWhile) {
+  /* The header is sealed once the back edge of the body is known */
+  IrBlock *headerBlock = currentFunction->createBlock();
+  IrBlock *bodyBlock = currentFunction->createBlock();
+  IrBlock *exitBlock = currentFunction->createBlock();
+  terminate(IrOpCode::Jump, {}, {headerBlock});
+  currentBlock = headerBlock;
+  buildBranch(*inWhile.getExpression(), IrOpCode::LoopBranch, bodyBlock,
+              exitBlock);
+
+  sealBlock(bodyBlock);
+  currentBlock = bodyBlock;
+  buildNestedBlock(*inWhile.getBody());
+  if (currentBlock)
+    terminate(IrOpCode::Jump, {}, {headerBlock});
+  sealBlock(headerBlock);
+  sealBlock(exitBlock);
+  currentBlock = exitBlock;
+  return Completion::Normal;
+}
+
+void IrBuilder::buildBranch(const Expression &inCondition, IrOpCode inOpCode,
+                            IrBlock *inTrueBlock, IrBlock *inFalseBlock) {
+  /* The left operand of || decides on true and the one of && on false,
+   * otherwise the right operand is tested in a block of its own */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isBoolLogical()) {
+    const bool bIsOr =
+        binaryExpression->getOperator() == Expression::Operator::LogicalOr;
+    IrBlock *rhsBlock = currentFunction->createBlock();
+    buildBranch(*binaryExpression->getLhs(), inOpCode,
+                bIsOr ? inTrueBlock : rhsBlock,
+                bIsOr ? rhsBlock : inFalseBlock);
+    sealBlock(rhsBlock);
+    currentBlock = rhsBlock;
+    buildBranch(*binaryExpression->getRhs(), inOpCode, inTrueBlock,
+                inFalseBlock);
+    return;
+  }
+
+  IrInstruction *condition = buildExpression(inCondition);
+  terminate(inOpCode, {condition}, {inTrueBlock, inFalseBlock});
+}
+
+IrBlock *IrBuilder::getBlock() {
+  /* Code following a throw inside an expression goes to a block no path
+   * reaches */
+  if (!currentBlock) {
+    currentBlock = currentFunction->createBlock();
+    sealBlock(currentBlock);
+  }
+  return currentBlock;
+}
+
+IrInstruction *IrBuilder::emit(IrOpCode inOpCode,
+                               std::vector<IrInstruction *> inOperands) {
+  return getBlock()->append(
+      std::make_unique<IrInstruction>(inOpCode, std::move(inOperands)));
+}
+
+void IrBuilder::emitCheck(IrOpCode inOpCode, const std::string &inName,
+                          IrInstruction *inFlag) {
+  IrInstruction *check = emit(inOpCode, {inFlag});
+  check->setName(inName);
+  if (inFlag != undefined && inFlag->getOpCode() != IrOpCode::Constant)
+    return;
+
+  /* The outcome is known when the flag is */
+  const std::string failure = check->getCheckFailure();
+  currentBlock->remove(check);
+  if (!failure.empty())
+    emitThrow(failure);
+}
+
+void IrBuilder::emitThrow(const std::string &inMessage) {
+  emit(IrOpCode::Throw)->setName(inMessage);
+  currentBlock = nullptr;
+}
+
+IrInstruction *IrBuilder::terminate(IrOpCode inOpCode,
+                                    std::vector<IrInstruction *> inOperands,
+                                    std::vector<IrBlock *> inSuccessors) {
+  IrInstruction *terminator = emit(inOpCode, std::move(inOperands));
+  for (IrBlock *successor : inSuccessors) {
+    successor->addPredecessor(currentBlock);
+  }
+  terminator->setSuccessors(std::move(inSuccessors));
+  currentBlock = nullptr;
+  return terminator;
+}
+
+IrInstruction *
+IrBuilder::addHeader(std::unique_ptr<IrInstruction> inInstruction) {
+  return currentFunction->getEntry()->insert(headerSize++,
+                                             std::move(inInstruction));
+}
+
+IrInstruction *IrBuilder::getUndefined() {
+  if (!undefined)
+    undefined =
+        addHeader(std::make_unique<IrInstruction>(IrOpCode::Undefined));
+  return undefined;
+}
+
+IrInstruction *IrBuilder::getConstant(const RuntimeValue &inConstant) {
+  for (IrInstruction *constant : constants) {
+    const RuntimeValue &value = constant->getConstant();
+    if (value == inConstant &&
+        (value.getType() != RuntimeValue::Type::Float ||
+         std::signbit(value.getFloat()) == std::signbit(inConstant.getFloat())))
+      return constant;
+  }
+  auto constant = std::make_unique<IrInstruction>(IrOpCode::Constant);
+  constant->setConstant(inConstant);
+  constants.push_back(addHeader(std::move(constant)));
+  return constants.back();
+}
+
+void IrBuilder::writeVariable(const std::string &inName, IrBlock *inBlock,
+                              IrInstruction *inValue) {
+  definitions[inBlock][inName] = inValue;
+}
+
+IrInstruction *IrBuilder::readVariable(const std::string &inName,
+                                       IrBlock *inBlock) {
+  auto &blockDefinitions = definitions[inBlock];
+  auto definition = blockDefinitions.find(inName);
+  if (definition != blockDefinitions.end())
+    return definition->second;
+  return readVariableRecursive(inName, inBlock);
+}
+
+IrInstruction *IrBuilder::readVariableRecursive(const std::string &inName,
+                                                IrBlock *inBlock) {
+  IrInstruction *value = nullptr;
+  const auto &predecessors = inBlock->getPredecessors();
+  if (!sealedBlocks.count(inBlock)) {
+    /* More predecessors may follow, the operands are added when sealing */
+    value = inBlock->insert(0, std::make_unique<IrInstruction>(IrOpCode::Phi));
+    incompletePhis[inBlock][inName] = value;
+  } else if (predecessors.size() == 1) {
+    value = readVariable(inName, predecessors[0]);
+  } else if (predecessors.empty()) {
+    value = getUndefined();
+  } else {
+    IrInstruction *phi =
+        inBlock->insert(0, std::make_unique<IrInstruction>(IrOpCode::Phi));
+    writeVariable(inName, inBlock, phi);
+    value = addPhiOperands(inName, phi);
+  }
+  writeVariable(inName, inBlock, value);
+  return value;
+}
+
+IrInstruction *IrBuilder::addPhiOperands(const std::string &inName,
+                                         IrInstruction *inPhi) {
+  for (IrBlock *predecessor : inPhi->getBlock()->getPredecessors()) {
+    inPhi->addOperand(readVariable(inName, predecessor));
+  }
+  return tryRemoveTrivialPhi(inPhi);
+}
+
+IrInstruction *IrBuilder::tryRemoveTrivialPhi(IrInstruction *inPhi) {
+  IrInstruction *same = nullptr;
+  for (IrInstruction *operand : inPhi->getOperands()) {
+    if (operand == same || operand == inPhi)
+      continue;
+    if (same)
+      return inPhi;
+    same = operand;
+  }
+  if (!same)
+    same = getUndefined();
+
+  std::vector<IrInstruction *> users;
+  for (const auto &block : currentFunction->getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      const auto &operands = instruction->getOperands();
+      if (instruction.get() != inPhi &&
+          std::find(operands.begin(), operands.end(), inPhi) != operands.end())
+        users.push_back(instruction.get());
+    }
+  }
+  currentFunction->replaceAllUses(inPhi, same);
+  for (auto &blockDefinitions : definitions) {
+    for (auto &definition : blockDefinitions.second) {
+      if (definition.second == inPhi)
+        definition.second = same;
+    }
+  }
+  removedPhis.push_back(inPhi->getBlock()->remove(inPhi));
+  removed.insert(inPhi);
+
+  /* Phis reading this one may have become trivial as well */
+  for (IrInstruction *user : users) {
+    if (user->getOpCode() == IrOpCode::Phi &&
+        sealedBlocks.count(user->getBlock()) && !removed.count(user))
+      tryRemoveTrivialPhi(user);
+  }
+  return same;
+}
+
+void IrBuilder::sealBlock(IrBlock *inBlock) {
+  /* Completing a phi may create further phis in the same block */
+  while (!incompletePhis[inBlock].empty()) {
+    auto phis = std::move(incompletePhis[inBlock]);
+    incompletePhis[inBlock].clear();
+    for (const auto &phi : phis) {
+      addPhiOperands(phi.first, phi.second);
+    }
+  }
+  incompletePhis.erase(inBlock);
+  sealedBlocks.insert(inBlock);
+}
+
+std::string IrBuilder::getFlagName(const std::string &inName) {
+  return "#" + inName;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "../interpreter/Context.h"
+#include "../interpreter/VisitorInterpreter.h"
+#include "IrProgram.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/* Lowers the parsed AST into SSA form with the algorithm of Braun et al.:
+ * variables are looked up through the blocks that define them, phis are
+ * placed where definitions from several predecessors meet and removed again
+ * when all their operands agree. Next to its value every variable has a
+ * declaration flag, so the checks the tree walker makes on undeclared,
+ * redeclared and immutable variables are only emitted where the flag is not
+ * known. */
+class IrBuilder : public VisitorInterpreter {
+public:
+  IrBuilder() = default;
+  std::unique_ptr<IrProgram> build(const class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  void buildFunction(const class Function &inFunction);
+  IrInstruction *buildExpression(const class Expression &inExpression);
+  /* Null when the callee returns nothing for sure */
+  IrInstruction *buildCall(const class InstructionFunctionCall &inFunctionCall);
+  void buildNestedBlock(const class Block &inBlock);
+  /* Ends the current block in a branch on inCondition. || and && over bools
+   * become branches on their operands, so no value is built for them */
+  void buildBranch(const class Expression &inCondition, IrOpCode inOpCode,
+                   IrBlock *inTrueBlock, IrBlock *inFalseBlock);
+  IrBlock *getBlock();
+  IrInstruction *emit(IrOpCode inOpCode,
+                      std::vector<IrInstruction *> inOperands = {});
+  void emitCheck(IrOpCode inOpCode, const std::string &inName,
+                 IrInstruction *inFlag);
+  void emitThrow(const std::string &inMessage);
+  /* Ends the current block, which flows into inSuccessors */
+  IrInstruction *terminate(IrOpCode inOpCode, std::vector<IrInstruction *> inOperands,
+                 std::vector<IrBlock *> inSuccessors);
+  IrInstruction *addHeader(std::unique_ptr<IrInstruction> inInstruction);
+  IrInstruction *getUndefined();
+  IrInstruction *getConstant(const RuntimeValue &inConstant);
+
+  void writeVariable(const std::string &inName, IrBlock *inBlock,
+                     IrInstruction *inValue);
+  IrInstruction *readVariable(const std::string &inName, IrBlock *inBlock);
+  IrInstruction *readVariableRecursive(const std::string &inName,
+                                       IrBlock *inBlock);
+  IrInstruction *addPhiOperands(const std::string &inName, IrInstruction *inPhi);
+  IrInstruction *tryRemoveTrivialPhi(IrInstruction *inPhi);
+  void sealBlock(IrBlock *inBlock);
+  static std::string getFlagName(const std::string &inName);
+
+  Context context;
+  std::unique_ptr<IrProgram> program;
+  IrFunction *currentFunction = nullptr;
+  /* Block code is emitted into, null once every path has left it */
+  IrBlock *currentBlock = nullptr;
+  /* Constants, parameters and Undefined at the start of the entry block */
+  size_t headerSize = 0;
+  IrInstruction *undefined = nullptr;
+  std::vector<IrInstruction *> constants;
+
+  std::unordered_map<IrBlock *, std::unordered_map<std::string, IrInstruction *>>
+      definitions;
+  std::unordered_map<IrBlock *, std::unordered_map<std::string, IrInstruction *>>
+      incompletePhis;
+  std::unordered_set<IrBlock *> sealedBlocks;
+  /* Trivial phis stay alive until the function is built, other phis may
+   * still point at them */
+  std::vector<std::unique_ptr<IrInstruction>> removedPhis;
+  std::unordered_set<const IrInstruction *> removed;
+
+  /* Variables known to be declared at the current point, with mutability */
+  std::unordered_map<std::string, bool> declaredVariables;
+  std::vector<IrInstruction *> matchSubjects;
+  /* Numbers the hidden variables holding results of || and && */
+  size_t logicalCount = 0;
+
+  IrInstruction *result = nullptr;
+  IrInstruction *callArgument = nullptr;
+  std::vector<IrInstruction *> callArguments;
+};
@@ -0,0 +1,205 @@
+#include "IrConstantPropagation.h"
+#include "IrProgram.h"
+#include "../interpreter/MatchDispatch.h"
+#include "../interpreter/ValueOperations.h"
+#include <cmath>
+#include <exception>
+
+void IrConstantPropagation::run(IrProgram &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    run(*function);
+  }
+}
+
+void IrConstantPropagation::run(IrFunction &inFunction) {
+  /* Every fold may cut blocks off, so the walk restarts after each one
+   * once they are gone */
+  bool bIsChanged = true;
+  while (bIsChanged) {
+    bIsChanged = false;
+    for (size_t i = 0; i < inFunction.getBlocks().size() && !bIsChanged;
+         ++i) {
+      IrBlock *block = inFunction.getBlocks()[i].get();
+      for (size_t j = 0; j < block->getInstructions().size(); ++j) {
+        IrInstruction &instruction = *block->getInstructions()[j];
+        bIsChanged = instruction.isTerminator()
+                         ? foldTerminator(inFunction, instruction)
+                         : foldInstruction(inFunction, instruction);
+        if (bIsChanged)
+          break;
+      }
+    }
+    if (bIsChanged) {
+      ++foldedCount;
+      inFunction.removeUnreachableBlocks();
+      inFunction.inferTypes();
+    }
+  }
+}
+
+size_t IrConstantPropagation::getFoldedCount() const { return foldedCount; }
+
+bool IrConstantPropagation::foldInstruction(IrFunction &inFunction,
+                                            IrInstruction &inInstruction) {
+  const IrOpCode opCode = inInstruction.getOpCode();
+  const auto &operands = inInstruction.getOperands();
+  IrInstruction *replacement = nullptr;
+
+  if (opCode == IrOpCode::Phi) {
+    for (IrInstruction *operand : operands) {
+      if (operand == &inInstruction || operand == replacement)
+        continue;
+      if (replacement)
+        return false;
+      replacement = operand;
+    }
+    if (!replacement)
+      return false;
+  } else if (opCode >= IrOpCode::CheckDeclared &&
+             opCode <= IrOpCode::CheckUndeclared) {
+    const IrOpCode flag = operands[0]->getOpCode();
+    if (flag != IrOpCode::Constant && flag != IrOpCode::Undefined)
+      return false;
+    const std::string failure = inInstruction.getCheckFailure();
+    if (failure.empty())
+      inInstruction.getBlock()->remove(&inInstruction);
+    else
+      replaceByThrow(inInstruction, failure);
+    return true;
+  } else if (opCode == IrOpCode::RequireValue) {
+    if (operands[0]->getOpCode() != IrOpCode::Constant)
+      return false;
+    inInstruction.getBlock()->remove(&inInstruction);
+    return true;
+  } else {
+    if (!inInstruction.isPure() || opCode <= IrOpCode::Undefined)
+      return false;
+    for (const IrInstruction *operand : operands) {
+      if (operand->getOpCode() != IrOpCode::Constant)
+        return false;
+    }
+
+    RuntimeValue value;
+    const RuntimeValue &operand = operands[0]->getConstant();
+    try {
+      if (opCode == IrOpCode::Negation)
+        value = ValueOperations::unaryOperation(operand);
+      else if (opCode == IrOpCode::MatchCase)
+        value = RuntimeValue(ValueOperations::matchesCase(
+            operand, operands[1]->getConstant()));
+      else if (opCode == IrOpCode::ToInt)
+        value = ValueOperations::toInt(operand);
+      else if (opCode == IrOpCode::ToFloat)
+        value = ValueOperations::toFloat(operand);
+      else if (opCode == IrOpCode::ToString)
+        value = ValueOperations::toString(operand);
+      else if (opCode == IrOpCode::ToBool)
+        value = ValueOperations::toBool(operand);
+      else
+        value = ValueOperations::binaryOperation(
+            static_cast<Expression::Operator>(static_cast<int>(opCode) -
+                                              static_cast<int>(IrOpCode::Sum)),
+            operand, operands[1]->getConstant());
+    } catch (const std::exception &) {
+      return false;
+    }
+    replacement = getConstant(inFunction, value);
+  }
+
+  inFunction.replaceAllUses(&inInstruction, replacement);
+  inInstruction.getBlock()->remove(&inInstruction);
+  return true;
+}
+
+bool IrConstantPropagation::foldTerminator(IrFunction &inFunction,
+                                           IrInstruction &inTerminator) {
+  const IrOpCode opCode = inTerminator.getOpCode();
+  if (opCode < IrOpCode::Branch || opCode > IrOpCode::Switch ||
+      inTerminator.getOperand(0)->getOpCode() != IrOpCode::Constant)
+    return false;
+
+  const RuntimeValue &condition = inTerminator.getOperand(0)->getConstant();
+  if (opCode == IrOpCode::LoopBranch &&
+      condition.getType() != RuntimeValue::Type::Bool) {
+    replaceByThrow(inTerminator, "Invalid expression type in while!");
+    return true;
+  }
+
+  const auto &successors = inTerminator.getSuccessors();
+  IrBlock *taken = successors[0];
+  if (opCode == IrOpCode::Switch) {
+    const size_t index = inTerminator.getDispatch()->find(condition);
+    taken = index == MatchDispatch::NoCase ? successors.back()
+                                           : successors[index];
+  } else {
+    bool bIsTaken = false;
+    if (!decideBranch(opCode, condition, bIsTaken))
+      return false;
+    taken = successors[bIsTaken ? 0 : 1];
+  }
+
+  /* Every other edge leaving the block goes away */
+  IrBlock *block = inTerminator.getBlock();
+  bool bIsKept = false;
+  for (IrBlock *successor : successors) {
+    if (successor == taken && !bIsKept)
+      bIsKept = true;
+    else
+      successor->removePredecessor(block);
+  }
+  inTerminator.setOpCode(IrOpCode::Jump);
+  inTerminator.clearOperands();
+  inTerminator.setSuccessors({taken});
+  inTerminator.setDispatch(nullptr);
+  return true;
+}
+
+bool IrConstantPropagation::decideBranch(IrOpCode inOpCode,
+                                         const RuntimeValue &inCondition,
+                                         bool &outIsTaken) {
+  try {
+    outIsTaken = inOpCode == IrOpCode::ShortCircuitOr
+                   ? ValueOperations::shortCircuits(
+                         Expression::Operator::LogicalOr, inCondition)
+               : inOpCode == IrOpCode::ShortCircuitAnd
+                   ? ValueOperations::shortCircuits(
+                         Expression::Operator::LogicalAnd, inCondition)
+                   : ValueOperations::isTrue(inCondition);
+  } catch (const std::exception &) {
+    /* The operator fails at runtime whatever follows */
+    return false;
+  }
+  return true;
+}
+
+void IrConstantPropagation::replaceByThrow(IrInstruction &inInstruction,
+                                           const std::string &inMessage) {
+  /* Everything after the throw is dead, its successors lose this block */
+  IrBlock *block = inInstruction.getBlock();
+  for (IrBlock *successor : block->getTerminator()->getSuccessors()) {
+    successor->removePredecessor(block);
+  }
+  while (block->getInstructions().back().get() != &inInstruction) {
+    block->remove(block->getInstructions().back().get());
+  }
+  inInstruction.setOpCode(IrOpCode::Throw);
+  inInstruction.setName(inMessage);
+  inInstruction.clearOperands();
+  inInstruction.setSuccessors({});
+}
+
+IrInstruction *IrConstantPropagation::getConstant(IrFunction &inFunction,
+                                                  const RuntimeValue &inConstant) {
+  IrBlock *entry = inFunction.getEntry();
+  for (const auto &instruction : entry->getInstructions()) {
+    const RuntimeValue &value = instruction->getConstant();
+    if (instruction->getOpCode() == IrOpCode::Constant &&
+        value == inConstant &&
+        (value.getType() != RuntimeValue::Type::Float ||
+         std::signbit(value.getFloat()) == std::signbit(inConstant.getFloat())))
+      return instruction.get();
+  }
+  auto constant = std::make_unique<IrInstruction>(IrOpCode::Constant);
+  constant->setConstant(inConstant);
+  return entry->insert(0, std::move(constant));
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "IrOpCode.h"
+#include <cstddef>
+#include <string>
+
+/* Evaluates instructions whose operands are all constants, removes phis
+ * whose operands agree, decides branches and checks on constants and drops
+ * the blocks that can no longer be reached. Instructions that would fail on
+ * their constants are kept so their error is still raised. */
+class IrConstantPropagation {
+public:
+  IrConstantPropagation() = default;
+  void run(class IrProgram &inProgram);
+  void run(class IrFunction &inFunction);
+  size_t getFoldedCount() const;
+
+private:
+  bool foldInstruction(class IrFunction &inFunction,
+                       class IrInstruction &inInstruction);
+  bool foldTerminator(class IrFunction &inFunction,
+                      class IrInstruction &inTerminator);
+  /* False when the condition fails, so the branch has to stay */
+  static bool decideBranch(IrOpCode inOpCode,
+                           const class RuntimeValue &inCondition,
+                           bool &outIsTaken);
+  /* Ends the block of inInstruction with a throw in its place */
+  void replaceByThrow(class IrInstruction &inInstruction,
+                      const std::string &inMessage);
+  class IrInstruction *getConstant(class IrFunction &inFunction,
+                                   const class RuntimeValue &inConstant);
+
+  size_t foldedCount = 0;
+};
@@ -0,0 +1,84 @@
+#include "IrDeadCodeElimination.h"
+#include "IrProgram.h"
+#include <unordered_set>
+
+void IrDeadCodeElimination::run(IrProgram &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    run(*function);
+  }
+}
+
+void IrDeadCodeElimination::run(IrFunction &inFunction) {
+  eliminatedCount += inFunction.removeUnreachableBlocks();
+  removeDeadInstructions(inFunction);
+  mergeBlocks(inFunction);
+}
+
+size_t IrDeadCodeElimination::getEliminatedCount() const {
+  return eliminatedCount;
+}
+
+void IrDeadCodeElimination::removeDeadInstructions(IrFunction &inFunction) {
+  /* Effects are live, and so is everything they read */
+  std::unordered_set<const IrInstruction *> live;
+  std::vector<const IrInstruction *> worklist;
+  for (const auto &block : inFunction.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (!instruction->cannotFail() && live.insert(instruction.get()).second)
+        worklist.push_back(instruction.get());
+    }
+  }
+  while (!worklist.empty()) {
+    const IrInstruction *instruction = worklist.back();
+    worklist.pop_back();
+    for (const IrInstruction *operand : instruction->getOperands()) {
+      if (live.insert(operand).second)
+        worklist.push_back(operand);
+    }
+  }
+
+  for (const auto &block : inFunction.getBlocks()) {
+    std::vector<const IrInstruction *> dead;
+    for (const auto &instruction : block->getInstructions()) {
+      if (!live.count(instruction.get()))
+        dead.push_back(instruction.get());
+    }
+    for (const IrInstruction *instruction : dead) {
+      block->remove(instruction);
+    }
+    eliminatedCount += dead.size();
+  }
+}
+
+void IrDeadCodeElimination::mergeBlocks(IrFunction &inFunction) {
+  bool bIsChanged = true;
+  while (bIsChanged) {
+    bIsChanged = false;
+    for (const auto &block : inFunction.getBlocks()) {
+      IrInstruction *terminator = block->getTerminator();
+      if (terminator->getOpCode() != IrOpCode::Jump)
+        continue;
+      IrBlock *successor = terminator->getSuccessors()[0];
+      if (successor->getPredecessors().size() != 1 ||
+          successor == block.get() || successor == inFunction.getEntry())
+        continue;
+
+      /* Phis of a block with a single predecessor have a single operand */
+      while (successor->getInstructions().front()->getOpCode() ==
+             IrOpCode::Phi) {
+        IrInstruction *phi = successor->getInstructions().front().get();
+        inFunction.replaceAllUses(phi, phi->getOperand(0));
+        successor->remove(phi);
+      }
+      block->remove(terminator);
+      block->splice(*successor);
+      for (IrBlock *next : block->getTerminator()->getSuccessors()) {
+        next->replacePredecessor(successor, block.get());
+      }
+      inFunction.removeBlock(successor);
+      ++eliminatedCount;
+      bIsChanged = true;
+      break;
+    }
+  }
+}
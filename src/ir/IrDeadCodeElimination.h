@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+
+/* Removes unreachable blocks and the instructions no effect depends on,
+ * then merges every block into its predecessor when it is the only
+ * successor of that predecessor and has no other. Instructions that may
+ * fail stay, their error is an effect. */
+class IrDeadCodeElimination {
+public:
+  IrDeadCodeElimination() = default;
+  void run(class IrProgram &inProgram);
+  void run(class IrFunction &inFunction);
+  size_t getEliminatedCount() const;
+
+private:
+  void removeDeadInstructions(class IrFunction &inFunction);
+  void mergeBlocks(class IrFunction &inFunction);
+
+  size_t eliminatedCount = 0;
+};
@@ -0,0 +1,99 @@
+#include "IrDominators.h"
+#include "IrFunction.h"
+#include <algorithm>
+#include <unordered_set>
+
+IrDominators::IrDominators(const IrFunction &inFunction) {
+  /* Post order of a depth first walk, reversed. Successors are walked last
+   * to first so the first one comes first. */
+  std::vector<std::pair<IrBlock *, size_t>> stack = {
+      {inFunction.getEntry(), 0}};
+  std::unordered_set<const IrBlock *> visited = {inFunction.getEntry()};
+  while (!stack.empty()) {
+    auto &[block, next] = stack.back();
+    const IrInstruction *terminator = block->getTerminator();
+    if (terminator && next < terminator->getSuccessors().size()) {
+      const auto &successors = terminator->getSuccessors();
+      IrBlock *successor = successors[successors.size() - ++next];
+      if (visited.insert(successor).second)
+        stack.emplace_back(successor, 0);
+      continue;
+    }
+    reversePostOrder.push_back(block);
+    stack.pop_back();
+  }
+  std::reverse(reversePostOrder.begin(), reversePostOrder.end());
+  for (size_t i = 0; i < reversePostOrder.size(); ++i) {
+    order[reversePostOrder[i]] = i;
+  }
+
+  IrBlock *entry = inFunction.getEntry();
+  immediateDominators[entry] = entry;
+  bool bIsChanged = true;
+  while (bIsChanged) {
+    bIsChanged = false;
+    for (size_t i = 1; i < reversePostOrder.size(); ++i) {
+      IrBlock *block = reversePostOrder[i];
+      IrBlock *dominator = nullptr;
+      for (IrBlock *predecessor : block->getPredecessors()) {
+        if (!immediateDominators.count(predecessor))
+          continue;
+        dominator =
+            dominator ? intersect(predecessor, dominator) : predecessor;
+      }
+      auto known = immediateDominators.find(block);
+      if (known == immediateDominators.end() || known->second != dominator) {
+        immediateDominators[block] = dominator;
+        bIsChanged = true;
+      }
+    }
+  }
+
+  for (size_t i = 1; i < reversePostOrder.size(); ++i) {
+    children[immediateDominators.at(reversePostOrder[i])].push_back(
+        reversePostOrder[i]);
+  }
+}
+
+bool IrDominators::isReachable(const IrBlock *inBlock) const {
+  return order.count(inBlock) > 0;
+}
+
+bool IrDominators::dominates(const IrBlock *inDominator,
+                             const IrBlock *inBlock) const {
+  if (!isReachable(inDominator) || !isReachable(inBlock))
+    return false;
+  const size_t dominatorOrder = order.at(inDominator);
+  /* Dominators precede the blocks they dominate in reverse post order */
+  while (order.at(inBlock) > dominatorOrder) {
+    inBlock = immediateDominators.at(inBlock);
+  }
+  return inBlock == inDominator;
+}
+
+IrBlock *IrDominators::getImmediateDominator(const IrBlock *inBlock) const {
+  return immediateDominators.at(inBlock);
+}
+
+const std::vector<IrBlock *> &
+IrDominators::getChildren(const IrBlock *inBlock) const {
+  static const std::vector<IrBlock *> none;
+  auto blockChildren = children.find(inBlock);
+  return blockChildren == children.end() ? none : blockChildren->second;
+}
+
+const std::vector<IrBlock *> &IrDominators::getReversePostOrder() const {
+  return reversePostOrder;
+}
+
+IrBlock *IrDominators::intersect(IrBlock *inLhs, IrBlock *inRhs) const {
+  while (inLhs != inRhs) {
+    while (order.at(inLhs) > order.at(inRhs)) {
+      inLhs = immediateDominators.at(inLhs);
+    }
+    while (order.at(inRhs) > order.at(inLhs)) {
+      inRhs = immediateDominators.at(inRhs);
+    }
+  }
+  return inLhs;
+}
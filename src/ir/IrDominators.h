@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/* Dominator tree of the blocks reachable from the entry, computed with the
+ * iterative algorithm of Cooper, Harvey and Kennedy */
+class IrDominators {
+public:
+  explicit IrDominators(const class IrFunction &inFunction);
+
+  bool isReachable(const class IrBlock *inBlock) const;
+  /* True when every path from the entry to inBlock passes inDominator,
+   * which dominates itself */
+  bool dominates(const class IrBlock *inDominator,
+                 const class IrBlock *inBlock) const;
+  class IrBlock *getImmediateDominator(const class IrBlock *inBlock) const;
+  const std::vector<class IrBlock *> &
+  getChildren(const class IrBlock *inBlock) const;
+  const std::vector<class IrBlock *> &getReversePostOrder() const;
+
+private:
+  class IrBlock *intersect(class IrBlock *inLhs, class IrBlock *inRhs) const;
+
+  std::vector<class IrBlock *> reversePostOrder;
+  std::unordered_map<const class IrBlock *, size_t> order;
+  std::unordered_map<const class IrBlock *, class IrBlock *> immediateDominators;
+  std::unordered_map<const class IrBlock *, std::vector<class IrBlock *>>
+      children;
+};
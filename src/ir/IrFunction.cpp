@@ -0,0 +1,227 @@
+#include "IrFunction.h"
+#include "IrDominators.h"
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+IrFunction::IrFunction(const std::string &inName) : name(inName) {}
+
+const std::string &IrFunction::getName() const { return name; }
+
+void IrFunction::addParameter(const std::string &inName, bool bInIsMutable) {
+  parameters.emplace_back(inName, bInIsMutable);
+}
+
+const std::vector<std::pair<std::string, bool>> &
+IrFunction::getParameters() const {
+  return parameters;
+}
+
+IrBlock *IrFunction::createBlock() {
+  blocks.push_back(std::make_unique<IrBlock>(blocks.size()));
+  return blocks.back().get();
+}
+
+IrBlock *IrFunction::getEntry() const { return blocks.front().get(); }
+
+const std::vector<std::unique_ptr<IrBlock>> &IrFunction::getBlocks() const {
+  return blocks;
+}
+
+void IrFunction::removeBlock(const IrBlock *inBlock) {
+  blocks.erase(std::find_if(blocks.begin(), blocks.end(),
+                            [inBlock](const auto &inCandidate) {
+                              return inCandidate.get() == inBlock;
+                            }));
+}
+
+size_t IrFunction::removeUnreachableBlocks() {
+  std::unordered_set<const IrBlock *> reachable = {getEntry()};
+  std::vector<const IrBlock *> worklist = {getEntry()};
+  while (!worklist.empty()) {
+    const IrBlock *block = worklist.back();
+    worklist.pop_back();
+    if (!block->getTerminator())
+      continue;
+    for (const IrBlock *successor : block->getTerminator()->getSuccessors()) {
+      if (reachable.insert(successor).second)
+        worklist.push_back(successor);
+    }
+  }
+
+  std::vector<const IrBlock *> unreachable;
+  for (const auto &block : blocks) {
+    if (reachable.count(block.get()))
+      continue;
+    unreachable.push_back(block.get());
+    if (!block->getTerminator())
+      continue;
+    for (IrBlock *successor : block->getTerminator()->getSuccessors()) {
+      if (reachable.count(successor))
+        successor->removePredecessor(block.get());
+    }
+  }
+  for (const IrBlock *block : unreachable) {
+    removeBlock(block);
+  }
+  return unreachable.size();
+}
+
+bool IrFunction::isUsed(const IrInstruction *inValue) const {
+  for (const auto &block : blocks) {
+    for (const auto &instruction : block->getInstructions()) {
+      for (const IrInstruction *operand : instruction->getOperands()) {
+        if (operand == inValue)
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+void IrFunction::replaceAllUses(const IrInstruction *inValue,
+                                IrInstruction *inReplacement) {
+  for (const auto &block : blocks) {
+    for (const auto &instruction : block->getInstructions()) {
+      for (size_t i = 0; i < instruction->getOperands().size(); ++i) {
+        if (instruction->getOperand(i) == inValue)
+          instruction->setOperand(i, inReplacement);
+      }
+    }
+  }
+}
+
+void IrFunction::inferTypes() {
+  typedef RuntimeValue::Type Type;
+  /* A value missing from the map may still have any type */
+  std::unordered_map<const IrInstruction *, Type> types;
+  auto transfer = [&types](const IrInstruction &inInstruction)
+      -> std::optional<Type> {
+    const IrOpCode opCode = inInstruction.getOpCode();
+    const auto &operands = inInstruction.getOperands();
+    switch (opCode) {
+    case IrOpCode::Constant:
+      return inInstruction.getConstant().getType();
+    case IrOpCode::Undefined:
+      return std::nullopt;
+    case IrOpCode::Phi: {
+      /* Undefined operands are never read, the checks raise first */
+      std::optional<Type> joined;
+      for (const IrInstruction *operand : operands) {
+        auto type = types.find(operand);
+        if (type == types.end())
+          continue;
+        if (joined && *joined != type->second)
+          return Type::Void;
+        joined = type->second;
+      }
+      return joined;
+    }
+    case IrOpCode::Negation:
+    case IrOpCode::Sum:
+    case IrOpCode::Substraction:
+    case IrOpCode::Multiplication:
+    case IrOpCode::Division:
+    case IrOpCode::Modulo: {
+      std::vector<Type> operandTypes;
+      for (const IrInstruction *operand : operands) {
+        auto type = types.find(operand);
+        if (type == types.end())
+          return std::nullopt;
+        operandTypes.push_back(type->second);
+      }
+      const Type type = operandTypes[0];
+      if (operandTypes.size() == 2 && operandTypes[1] != type)
+        return Type::Void;
+      if (type == Type::Int || type == Type::Float)
+        return type;
+      if (opCode == IrOpCode::Negation && type == Type::Bool)
+        return type;
+      if (opCode == IrOpCode::Sum && type == Type::String)
+        return type;
+      return Type::Void;
+    }
+    case IrOpCode::ToInt:
+      return Type::Int;
+    case IrOpCode::ToFloat:
+      return Type::Float;
+    case IrOpCode::ToString:
+      return Type::String;
+    case IrOpCode::ToBool:
+    case IrOpCode::MatchCase:
+      return Type::Bool;
+    default:
+      /* Comparisons and logical operators yield a bool for any operands */
+      if (opCode >= IrOpCode::LogicalOr && opCode <= IrOpCode::NotEqual)
+        return Type::Bool;
+      return Type::Void;
+    }
+  };
+
+  /* Values only move from any type to a single one and then to unknown */
+  bool bIsChanged = true;
+  while (bIsChanged) {
+    bIsChanged = false;
+    for (const auto &block : blocks) {
+      for (const auto &instruction : block->getInstructions()) {
+        if (!instruction->hasValue())
+          continue;
+        auto type = transfer(*instruction);
+        auto known = types.find(instruction.get());
+        if (!type || (known != types.end() && known->second == *type))
+          continue;
+        types[instruction.get()] = *type;
+        bIsChanged = true;
+      }
+    }
+  }
+
+  for (const auto &block : blocks) {
+    for (const auto &instruction : block->getInstructions()) {
+      auto type = types.find(instruction.get());
+      instruction->setType(type == types.end() ? Type::Void : type->second);
+    }
+  }
+}
+
+void IrFunction::renumber() {
+  /* Blocks are listed in reverse post order, unreachable ones last */
+  IrDominators dominators(*this);
+  std::vector<std::unique_ptr<IrBlock>> ordered;
+  for (IrBlock *block : dominators.getReversePostOrder()) {
+    auto owned = std::find_if(blocks.begin(), blocks.end(),
+                              [block](const auto &inCandidate) {
+                                return inCandidate.get() == block;
+                              });
+    ordered.push_back(std::move(*owned));
+  }
+  for (auto &block : blocks) {
+    if (block)
+      ordered.push_back(std::move(block));
+  }
+  blocks = std::move(ordered);
+
+  size_t valueId = 0;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    blocks[i]->setId(i);
+    for (const auto &instruction : blocks[i]->getInstructions()) {
+      if (instruction->hasValue())
+        instruction->setId(valueId++);
+    }
+  }
+}
+
+std::string IrFunction::toString() const {
+  std::string result = "fn " + name + "(";
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    result += (i ? ", " : "") +
+              std::string(parameters[i].second ? "mut " : "") +
+              parameters[i].first;
+  }
+  result += ")\n";
+  for (const auto &block : blocks) {
+    result += block->toString();
+  }
+  return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "IrBlock.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Control flow graph of a function in SSA form. The first block is the
+ * entry, it starts with the constants, parameters and Undefined value every
+ * other block may use. */
+class IrFunction {
+public:
+  explicit IrFunction(const std::string &inName);
+
+  const std::string &getName() const;
+  void addParameter(const std::string &inName, bool bInIsMutable);
+  const std::vector<std::pair<std::string, bool>> &getParameters() const;
+  IrBlock *createBlock();
+  IrBlock *getEntry() const;
+  const std::vector<std::unique_ptr<IrBlock>> &getBlocks() const;
+  void removeBlock(const IrBlock *inBlock);
+  /* Removes the blocks control never reaches from the entry, returns how
+   * many */
+  size_t removeUnreachableBlocks();
+  bool isUsed(const IrInstruction *inValue) const;
+  /* Makes every instruction read inReplacement instead of inValue */
+  void replaceAllUses(const IrInstruction *inValue,
+                      IrInstruction *inReplacement);
+  /* Assigns every value a type from the types of its operands, optimistic
+   * around loops */
+  void inferTypes();
+  /* Numbers the blocks and values in order */
+  void renumber();
+  std::string toString() const;
+
+private:
+  std::string name;
+  std::vector<std::pair<std::string, bool>> parameters;
+  std::vector<std::unique_ptr<IrBlock>> blocks;
+};
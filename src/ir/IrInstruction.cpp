@@ -0,0 +1,223 @@
+#include "IrInstruction.h"
+#include "IrBlock.h"
+#include "../interpreter/MatchDispatch.h"
+
+static const char *irOpCodeNames[] = {
+    "Constant", "Parameter", "Undefined", "Phi", "Sum", "Substraction",
+    "Multiplication", "Division", "Modulo", "LogicalOr", "LogicalAnd", "Less",
+    "LessEqual", "More", "MoreEqual", "Equal", "NotEqual", "Negation",
+    "MatchCase", "Call", "ToInt", "ToFloat", "ToString", "ToBool", "Print",
+    "RequireValue", "CheckDeclared", "CheckAssignable", "CheckUndeclared",
+    "Jump", "Branch", "LoopBranch", "ShortCircuitOr", "ShortCircuitAnd",
+    "Switch", "Return", "ReturnVoid", "Throw",
+};
+
+static const char *typeNames[] = {"void", "int", "float", "bool", "string"};
+
+IrInstruction::IrInstruction(IrOpCode inOpCode,
+                             std::vector<IrInstruction *> inOperands)
+    : opCode(inOpCode), operands(std::move(inOperands)) {}
+
+IrOpCode IrInstruction::getOpCode() const { return opCode; }
+
+void IrInstruction::setOpCode(IrOpCode inOpCode) { opCode = inOpCode; }
+
+RuntimeValue::Type IrInstruction::getType() const { return type; }
+
+void IrInstruction::setType(RuntimeValue::Type inType) { type = inType; }
+
+const std::vector<IrInstruction *> &IrInstruction::getOperands() const {
+  return operands;
+}
+
+IrInstruction *IrInstruction::getOperand(size_t inIndex) const {
+  return operands[inIndex];
+}
+
+void IrInstruction::setOperand(size_t inIndex, IrInstruction *inOperand) {
+  operands[inIndex] = inOperand;
+}
+
+void IrInstruction::addOperand(IrInstruction *inOperand) {
+  operands.push_back(inOperand);
+}
+
+void IrInstruction::removeOperand(size_t inIndex) {
+  operands.erase(operands.begin() + inIndex);
+}
+
+void IrInstruction::clearOperands() { operands.clear(); }
+
+const std::vector<IrBlock *> &IrInstruction::getSuccessors() const {
+  return successors;
+}
+
+void IrInstruction::setSuccessors(std::vector<IrBlock *> inSuccessors) {
+  successors = std::move(inSuccessors);
+}
+
+const RuntimeValue &IrInstruction::getConstant() const { return constant; }
+
+void IrInstruction::setConstant(const RuntimeValue &inConstant) {
+  constant = inConstant;
+  type = inConstant.getType();
+}
+
+const std::string &IrInstruction::getName() const { return name; }
+
+void IrInstruction::setName(const std::string &inName) { name = inName; }
+
+const MatchDispatch *IrInstruction::getDispatch() const { return dispatch; }
+
+void IrInstruction::setDispatch(const MatchDispatch *inDispatch) {
+  dispatch = inDispatch;
+}
+
+size_t IrInstruction::getIndex() const { return index; }
+
+void IrInstruction::setIndex(size_t inIndex) { index = inIndex; }
+
+IrBlock *IrInstruction::getBlock() const { return block; }
+
+void IrInstruction::setBlock(IrBlock *inBlock) { block = inBlock; }
+
+size_t IrInstruction::getId() const { return id; }
+
+void IrInstruction::setId(size_t inId) { id = inId; }
+
+bool IrInstruction::isTerminator() const { return opCode >= IrOpCode::Jump; }
+
+bool IrInstruction::hasValue() const {
+  return opCode <= IrOpCode::ToBool;
+}
+
+bool IrInstruction::isPure() const {
+  return opCode <= IrOpCode::ToBool && opCode != IrOpCode::Call;
+}
+
+bool IrInstruction::cannotFail() const {
+  typedef RuntimeValue::Type Type;
+  if (!isPure())
+    return false;
+  if (opCode <= IrOpCode::Phi || opCode == IrOpCode::MatchCase)
+    return true;
+  const Type operandType = operands[0]->getType();
+  if (opCode == IrOpCode::Negation)
+    return operandType != Type::Void && operandType != Type::String;
+  if (opCode == IrOpCode::ToString)
+    return operandType != Type::Void;
+  if (opCode >= IrOpCode::ToInt)
+    return operandType != Type::Void && operandType != Type::String;
+
+  /* Operands are never converted, so only equal types combine */
+  if (operandType == Type::Void || operands[1]->getType() != operandType)
+    return false;
+  switch (operandType) {
+  case Type::Int:
+  case Type::Float:
+    /* An int divisor of -1 overflows for INT_MIN */
+    if (opCode == IrOpCode::Division || opCode == IrOpCode::Modulo) {
+      const IrInstruction *divisor = operands[1];
+      return divisor->getOpCode() == IrOpCode::Constant &&
+             !(divisor->getConstant() == RuntimeValue(0)) &&
+             !(divisor->getConstant() == RuntimeValue(-1)) &&
+             !(divisor->getConstant() == RuntimeValue(0.0f));
+    }
+    return true;
+  case Type::Bool:
+    return opCode == IrOpCode::LogicalOr || opCode == IrOpCode::LogicalAnd ||
+           opCode == IrOpCode::Equal || opCode == IrOpCode::NotEqual;
+  default:
+    return opCode == IrOpCode::Sum || opCode == IrOpCode::Equal ||
+           opCode == IrOpCode::NotEqual;
+  }
+}
+
+std::string IrInstruction::getCheckFailure() const {
+  const IrInstruction *flag = operands[0];
+  if (flag->getOpCode() == IrOpCode::Undefined) {
+    if (opCode == IrOpCode::CheckDeclared)
+      return "No variable with such name " + name + "!";
+    if (opCode == IrOpCode::CheckAssignable)
+      return "Variable " + name + " is not declared!";
+  } else if (opCode == IrOpCode::CheckUndeclared) {
+    return "New declaration of local variable named " + name + " found!";
+  } else if (opCode == IrOpCode::CheckAssignable &&
+             !flag->getConstant().getBool()) {
+    return "Not mutable variable " + name + " cannot be modified!";
+  }
+  return "";
+}
+
+std::string IrInstruction::toString() const {
+  auto value = [](const IrInstruction *inValue) {
+    return "%" + std::to_string(inValue->getId());
+  };
+
+  std::string result = "  ";
+  if (hasValue()) {
+    result += value(this);
+    if (type != RuntimeValue::Type::Void)
+      result += std::string(": ") + typeNames[static_cast<size_t>(type)];
+    result += " = ";
+  }
+  result += irOpCodeNames[static_cast<size_t>(opCode)];
+
+  switch (opCode) {
+  case IrOpCode::Constant:
+    switch (constant.getType()) {
+    case RuntimeValue::Type::Int:
+      result += " " + std::to_string(constant.getInt());
+      break;
+    case RuntimeValue::Type::Float:
+      result += " " + std::to_string(constant.getFloat());
+      break;
+    case RuntimeValue::Type::Bool:
+      result += constant.getBool() ? " true" : " false";
+      break;
+    default:
+      result += " \"" + constant.getString() + "\"";
+      break;
+    }
+    break;
+  case IrOpCode::Parameter:
+    result += " " + std::to_string(index) + " " + name;
+    break;
+  case IrOpCode::Phi:
+    for (size_t i = 0; i < operands.size(); ++i) {
+      result += std::string(i ? ", " : " ") + "[bb" +
+                std::to_string(block->getPredecessors()[i]->getId()) + ": " +
+                value(operands[i]) + "]";
+    }
+    break;
+  case IrOpCode::Call:
+  case IrOpCode::CheckDeclared:
+  case IrOpCode::CheckAssignable:
+  case IrOpCode::CheckUndeclared:
+    result += " " + name;
+    for (const IrInstruction *operand : operands) {
+      result += ", " + value(operand);
+    }
+    break;
+  case IrOpCode::Throw:
+    result += " \"" + name + "\"";
+    break;
+  case IrOpCode::Switch:
+    result += " " + value(operands[0]);
+    for (const IrBlock *successor : successors) {
+      result += ", bb" + std::to_string(successor->getId());
+    }
+    result += " (" + dispatch->toString() + ")";
+    break;
+  default:
+    for (size_t i = 0; i < operands.size(); ++i) {
+      result += (i ? ", " : " ") + value(operands[i]);
+    }
+    for (size_t i = 0; i < successors.size(); ++i) {
+      result += std::string(i || !operands.empty() ? ", " : " ") + "bb" +
+                std::to_string(successors[i]->getId());
+    }
+    break;
+  }
+  return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "IrOpCode.h"
+#include "../interpreter/RuntimeValue.h"
+#include <string>
+#include <vector>
+
+/* Instruction of the SSA form and the value it defines. The type is the one
+ * every value it produces has, Void when it is not known statically. */
+class IrInstruction {
+public:
+  explicit IrInstruction(IrOpCode inOpCode,
+                         std::vector<IrInstruction *> inOperands = {});
+
+  IrOpCode getOpCode() const;
+  void setOpCode(IrOpCode inOpCode);
+  RuntimeValue::Type getType() const;
+  void setType(RuntimeValue::Type inType);
+  const std::vector<IrInstruction *> &getOperands() const;
+  IrInstruction *getOperand(size_t inIndex) const;
+  void setOperand(size_t inIndex, IrInstruction *inOperand);
+  void addOperand(IrInstruction *inOperand);
+  void removeOperand(size_t inIndex);
+  void clearOperands();
+  const std::vector<class IrBlock *> &getSuccessors() const;
+  void setSuccessors(std::vector<class IrBlock *> inSuccessors);
+  const RuntimeValue &getConstant() const;
+  void setConstant(const RuntimeValue &inConstant);
+  /* Callee of a call, variable of a check or message of a throw */
+  const std::string &getName() const;
+  void setName(const std::string &inName);
+  /* Cases a switch dispatches on, owned by the Match it was built from */
+  const class MatchDispatch *getDispatch() const;
+  void setDispatch(const class MatchDispatch *inDispatch);
+  size_t getIndex() const;
+  void setIndex(size_t inIndex);
+  class IrBlock *getBlock() const;
+  void setBlock(class IrBlock *inBlock);
+  size_t getId() const;
+  void setId(size_t inId);
+
+  bool isTerminator() const;
+  bool hasValue() const;
+  /* True when running the instruction has no effect besides its value */
+  bool isPure() const;
+  /* True when the instruction is pure and cannot raise an error for the
+   * types of its operands, so it may be removed or moved */
+  bool cannotFail() const;
+  /* Message a check raises when its flag is a constant or Undefined, empty
+   * when it passes */
+  std::string getCheckFailure() const;
+  std::string toString() const;
+
+private:
+  IrOpCode opCode;
+  RuntimeValue::Type type = RuntimeValue::Type::Void;
+  std::vector<IrInstruction *> operands;
+  std::vector<class IrBlock *> successors;
+  RuntimeValue constant;
+  std::string name;
+  const class MatchDispatch *dispatch = nullptr;
+  size_t index = 0;
+  class IrBlock *block = nullptr;
+  size_t id = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+/* Opcodes of the SSA form. Operands are the values of other instructions,
+ * terminators end every block and name its successors. The checks raise the
+ * errors the tree walker raises for undeclared and immutable variables, they
+ * read the declaration flag of a variable, a bool constant holding its
+ * mutability or Undefined before it is declared. */
+enum class IrOpCode : uint8_t {
+  Constant,        // literal value
+  Parameter,       // argument at index
+  Undefined,       // value of a variable not declared on some path
+  Phi,             // operand of the predecessor control came from
+  Sum,             // operand 0 + operand 1
+  Substraction,
+  Multiplication,
+  Division,
+  Modulo,
+  LogicalOr,
+  LogicalAnd,
+  Less,
+  LessEqual,
+  More,
+  MoreEqual,
+  Equal,
+  NotEqual,
+  Negation,        // -operand 0
+  MatchCase,       // operand 0 matches operand 1
+  Call,            // user function called with the operands
+  ToInt,           // int(operand 0)
+  ToFloat,
+  ToString,
+  ToBool,
+  Print,           // print operand 0
+  RequireValue,    // operand 0 cannot be void
+  CheckDeclared,   // flag operand 0 has to be declared
+  CheckAssignable, // flag operand 0 has to be declared and mutable
+  CheckUndeclared, // flag operand 0 cannot be declared yet
+  Jump,            // goto successor 0
+  Branch,          // successor 0 when operand 0 is true, else successor 1
+  LoopBranch,      // like Branch but operand 0 has to be a bool
+  ShortCircuitOr,  // successor 0 when operand 0 alone decides ||, else 1
+  ShortCircuitAnd, // successor 0 when operand 0 alone decides &&, else 1
+  Switch,          // successor of the case operand 0 takes in the dispatch,
+                   // the last one when it takes none
+  Return,          // return operand 0
+  ReturnVoid,
+  Throw,           // raise the message
+};
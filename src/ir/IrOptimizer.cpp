@@ -0,0 +1,32 @@
+#include "IrOptimizer.h"
+#include "IrConstantPropagation.h"
+#include "IrDeadCodeElimination.h"
+#include "IrProgram.h"
+#include "IrValueNumbering.h"
+#include "IrVerifier.h"
+
+void IrOptimizer::optimize(IrProgram &inProgram) {
+  IrVerifier verifier;
+  verifier.verify(inProgram);
+
+  IrConstantPropagation constantPropagation;
+  constantPropagation.run(inProgram);
+  foldedCount += constantPropagation.getFoldedCount();
+  verifier.verify(inProgram);
+
+  IrValueNumbering valueNumbering;
+  valueNumbering.run(inProgram);
+  numberedCount += valueNumbering.getReplacedCount();
+  verifier.verify(inProgram);
+
+  IrDeadCodeElimination deadCodeElimination;
+  deadCodeElimination.run(inProgram);
+  eliminatedCount += deadCodeElimination.getEliminatedCount();
+  verifier.verify(inProgram);
+}
+
+size_t IrOptimizer::getFoldedCount() const { return foldedCount; }
+
+size_t IrOptimizer::getNumberedCount() const { return numberedCount; }
+
+size_t IrOptimizer::getEliminatedCount() const { return eliminatedCount; }
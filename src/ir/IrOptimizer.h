@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+
+/* Runs the passes over the SSA form enabled by -O, verifying the program
+ * after each of them */
+class IrOptimizer {
+public:
+  IrOptimizer() = default;
+  void optimize(class IrProgram &inProgram);
+  size_t getFoldedCount() const;
+  size_t getNumberedCount() const;
+  size_t getEliminatedCount() const;
+
+private:
+  size_t foldedCount = 0;
+  size_t numberedCount = 0;
+  size_t eliminatedCount = 0;
+};
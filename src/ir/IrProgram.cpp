@@ -0,0 +1,20 @@
+#include "IrProgram.h"
+
+IrFunction *IrProgram::addFunction(std::unique_ptr<IrFunction> inFunction) {
+  functions.push_back(std::move(inFunction));
+  return functions.back().get();
+}
+
+const std::vector<std::unique_ptr<IrFunction>> &
+IrProgram::getFunctions() const {
+  return functions;
+}
+
+std::string IrProgram::toString() const {
+  std::string result;
+  for (const auto &function : functions) {
+    function->renumber();
+    result += (result.empty() ? "" : "\n") + function->toString();
+  }
+  return result;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "IrFunction.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class IrProgram {
+public:
+  IrProgram() = default;
+  IrFunction *addFunction(std::unique_ptr<IrFunction> inFunction);
+  const std::vector<std::unique_ptr<IrFunction>> &getFunctions() const;
+  std::string toString() const;
+
+private:
+  std::vector<std::unique_ptr<IrFunction>> functions;
+};
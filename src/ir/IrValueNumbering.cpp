@@ -0,0 +1,50 @@
+#include "IrValueNumbering.h"
+#include "IrDominators.h"
+#include "IrProgram.h"
+
+void IrValueNumbering::run(IrProgram &inProgram) {
+  for (const auto &function : inProgram.getFunctions()) {
+    run(*function);
+  }
+}
+
+void IrValueNumbering::run(IrFunction &inFunction) {
+  available.clear();
+  IrDominators dominators(inFunction);
+  numberBlock(inFunction, inFunction.getEntry(), dominators);
+}
+
+size_t IrValueNumbering::getReplacedCount() const { return replacedCount; }
+
+void IrValueNumbering::numberBlock(IrFunction &inFunction, IrBlock *inBlock,
+                                   const IrDominators &inDominators) {
+  std::vector<Key> added;
+  for (size_t i = 0; i < inBlock->getInstructions().size();) {
+    IrInstruction *instruction = inBlock->getInstructions()[i].get();
+    const IrOpCode opCode = instruction->getOpCode();
+    if (!instruction->isPure() || opCode <= IrOpCode::Phi) {
+      ++i;
+      continue;
+    }
+
+    Key key(static_cast<int>(opCode), {instruction->getOperands().begin(),
+                                       instruction->getOperands().end()});
+    auto leader = available.find(key);
+    if (leader == available.end()) {
+      available[key] = instruction;
+      added.push_back(std::move(key));
+      ++i;
+      continue;
+    }
+    inFunction.replaceAllUses(instruction, leader->second);
+    inBlock->remove(instruction);
+    ++replacedCount;
+  }
+
+  for (IrBlock *child : inDominators.getChildren(inBlock)) {
+    numberBlock(inFunction, child, inDominators);
+  }
+  for (const Key &key : added) {
+    available.erase(key);
+  }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+/* Global value numbering over the dominator tree: a pure instruction other
+ * than a phi computing what a dominating one with the same opcode and
+ * operands already computed is replaced by it. The dominating instruction
+ * runs first on every path, so one that may fail has failed before the copy
+ * is reached. */
+class IrValueNumbering {
+public:
+  IrValueNumbering() = default;
+  void run(class IrProgram &inProgram);
+  void run(class IrFunction &inFunction);
+  size_t getReplacedCount() const;
+
+private:
+  typedef std::pair<int, std::vector<const class IrInstruction *>> Key;
+
+  void numberBlock(class IrFunction &inFunction, class IrBlock *inBlock,
+                   const class IrDominators &inDominators);
+
+  /* Values available in the dominators of the current block */
+  std::map<Key, class IrInstruction *> available;
+  size_t replacedCount = 0;
+};
@@ -0,0 +1,135 @@
+#include "IrVerifier.h"
+#include "IrDominators.h"
+#include "IrProgram.h"
+#include "../interpreter/InterpreterError.h"
+#include <algorithm>
+#include <unordered_map>
+
+void IrVerifier::verify(const IrProgram &inProgram) const {
+  for (const auto &function : inProgram.getFunctions()) {
+    verify(*function);
+  }
+}
+
+void IrVerifier::verify(const IrFunction &inFunction) const {
+  if (inFunction.getBlocks().empty())
+    fail(inFunction, "no entry block");
+  if (!inFunction.getEntry()->getPredecessors().empty())
+    fail(inFunction, "entry block has predecessors");
+
+  /* Position of every instruction within its block */
+  std::unordered_map<const IrInstruction *, size_t> positions;
+  for (const auto &block : inFunction.getBlocks()) {
+    const auto &instructions = block->getInstructions();
+    const std::string name = "bb" + std::to_string(block->getId());
+    if (!block->getTerminator())
+      fail(inFunction, name + " does not end with a terminator");
+    for (size_t i = 0; i < instructions.size(); ++i) {
+      const IrInstruction &instruction = *instructions[i];
+      positions[&instruction] = i;
+      if (instruction.getBlock() != block.get())
+        fail(inFunction, name + " holds an instruction of another block");
+      if (instruction.isTerminator() && i + 1 != instructions.size())
+        fail(inFunction, name + " has a terminator before its end");
+      if (instruction.getOpCode() == IrOpCode::Phi &&
+          (i > 0 && instructions[i - 1]->getOpCode() != IrOpCode::Phi))
+        fail(inFunction, name + " has a phi after other instructions");
+    }
+  }
+
+  for (const auto &block : inFunction.getBlocks()) {
+    const std::string name = "bb" + std::to_string(block->getId());
+    const auto &successors = block->getTerminator()->getSuccessors();
+    for (const IrBlock *successor : successors) {
+      const auto &predecessors = successor->getPredecessors();
+      if (std::count(predecessors.begin(), predecessors.end(), block.get()) !=
+          std::count(successors.begin(), successors.end(), successor))
+        fail(inFunction, name + " is missing from the predecessors of bb" +
+                             std::to_string(successor->getId()));
+      if (!positions.count(successor->getTerminator()))
+        fail(inFunction, name + " jumps to a block of another function");
+    }
+    for (const IrBlock *predecessor : block->getPredecessors()) {
+      const auto &predecessorSuccessors =
+          predecessor->getTerminator()->getSuccessors();
+      if (std::find(predecessorSuccessors.begin(), predecessorSuccessors.end(),
+                    block.get()) == predecessorSuccessors.end())
+        fail(inFunction, name + " lists bb" +
+                             std::to_string(predecessor->getId()) +
+                             " as a predecessor that never jumps to it");
+    }
+  }
+
+  IrDominators dominators(inFunction);
+  for (const auto &block : inFunction.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      const IrOpCode opCode = instruction->getOpCode();
+      const std::string name =
+          "bb" + std::to_string(block->getId()) + " " +
+          std::to_string(positions.at(instruction.get()));
+      const size_t operandCount = instruction->getOperands().size();
+      size_t expectedOperands = 1;
+      if (opCode <= IrOpCode::Undefined || opCode == IrOpCode::Jump ||
+          opCode == IrOpCode::ReturnVoid || opCode == IrOpCode::Throw)
+        expectedOperands = 0;
+      else if (opCode == IrOpCode::Phi)
+        expectedOperands = block->getPredecessors().size();
+      else if (opCode == IrOpCode::Call)
+        expectedOperands = operandCount;
+      else if (opCode < IrOpCode::Negation || opCode == IrOpCode::MatchCase)
+        expectedOperands = 2;
+      if (operandCount != expectedOperands)
+        fail(inFunction, name + " has " + std::to_string(operandCount) +
+                             " operands instead of " +
+                             std::to_string(expectedOperands));
+
+      size_t expectedSuccessors = 0;
+      if (opCode == IrOpCode::Jump)
+        expectedSuccessors = 1;
+      else if (opCode >= IrOpCode::Branch &&
+               opCode <= IrOpCode::ShortCircuitAnd)
+        expectedSuccessors = 2;
+      else if (opCode == IrOpCode::Switch)
+        expectedSuccessors =
+            std::max<size_t>(instruction->getSuccessors().size(), 1);
+      if (instruction->getSuccessors().size() != expectedSuccessors)
+        fail(inFunction, name + " has a wrong number of successors");
+      if (opCode == IrOpCode::Switch && !instruction->getDispatch())
+        fail(inFunction, name + " switches without cases");
+      if (opCode == IrOpCode::Constant &&
+          instruction->getType() != instruction->getConstant().getType())
+        fail(inFunction, name + " has a constant of another type");
+
+      for (size_t i = 0; i < operandCount; ++i) {
+        const IrInstruction *operand = instruction->getOperand(i);
+        auto position = positions.find(operand);
+        if (position == positions.end())
+          fail(inFunction, name + " reads a value defined elsewhere");
+        if (!operand->hasValue())
+          fail(inFunction, name + " reads an instruction without a value");
+        if (!dominators.isReachable(block.get()))
+          continue;
+
+        /* A phi reads its operand at the end of the matching predecessor */
+        const IrBlock *user = block.get();
+        size_t usePosition = positions.at(instruction.get());
+        if (opCode == IrOpCode::Phi) {
+          user = block->getPredecessors()[i];
+          usePosition = user->getInstructions().size();
+        }
+        const bool bIsDefined =
+            operand->getBlock() == user
+                ? position->second < usePosition
+                : dominators.dominates(operand->getBlock(), user);
+        if (!bIsDefined && dominators.isReachable(user))
+          fail(inFunction, name + " reads a value not defined on every path");
+      }
+    }
+  }
+}
+
+void IrVerifier::fail(const IrFunction &inFunction,
+                      const std::string &inMessage) {
+  throw InterpreterError("Invalid IR in function " + inFunction.getName() +
+                         ": " + inMessage + "!");
+}
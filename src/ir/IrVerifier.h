@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+/* Checks the invariants every pass relies on and every pass has to keep:
+ * blocks end in exactly one terminator, phis lead their block with one
+ * operand per predecessor, predecessors match the successors of the
+ * terminators, operands fit their opcode and every value is defined before
+ * all of its uses. Violations raise an InterpreterError. */
+class IrVerifier {
+public:
+  IrVerifier() = default;
+  void verify(const class IrProgram &inProgram) const;
+  void verify(const class IrFunction &inFunction) const;
+
+private:
+  [[noreturn]] static void fail(const class IrFunction &inFunction,
+                                const std::string &inMessage);
+};
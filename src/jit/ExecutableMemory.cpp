@@ -0,0 +1,38 @@
+#include "ExecutableMemory.h"
+#include "Jit.h"
+#include "JitError.h"
+#include <cstring>
+#if TKOM_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ExecutableMemory::ExecutableMemory(const std::vector<uint8_t> &inCode) {
+#if TKOM_JIT
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size = (inCode.size() + pageSize - 1) / pageSize * pageSize;
+  memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    memory = nullptr;
+    throw JitError("Cannot allocate executable memory!");
+  }
+  std::memcpy(memory, inCode.data(), inCode.size());
+  if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, size);
+    memory = nullptr;
+    throw JitError("Cannot make memory executable!");
+  }
+#else
+  throw JitError("Native code is not supported on this platform!");
+#endif
+}
+
+ExecutableMemory::~ExecutableMemory() {
+#if TKOM_JIT
+  if (memory)
+    munmap(memory, size);
+#endif
+}
+
+const void *ExecutableMemory::getCode() const { return memory; }
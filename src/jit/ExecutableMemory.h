@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Machine code copied into its own mmap'd pages, which are made read-only
+ * and executable once the code is written. */
+class ExecutableMemory {
+public:
+  explicit ExecutableMemory(const std::vector<uint8_t> &inCode);
+  ~ExecutableMemory();
+  ExecutableMemory(const ExecutableMemory &) = delete;
+  ExecutableMemory &operator=(const ExecutableMemory &) = delete;
+  const void *getCode() const;
+
+private:
+  void *memory = nullptr;
+  size_t size = 0;
+};
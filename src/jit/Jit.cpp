@@ -0,0 +1,196 @@
+#include "Jit.h"
+#include "../instructions/Function.h"
+#include "../interpreter/Context.h"
+#include "../interpreter/NativeStack.h"
+#include "JitCompiler.h"
+#include "JitError.h"
+#include "X86Assembler.h"
+#include <bit>
+#include <cmath>
+#include <csetjmp>
+
+/* Inferring the return type of a recursive function takes at most two
+ * passes, one with the type unknown and one confirming the inferred type */
+static constexpr size_t MaxInferencePasses = 3;
+
+/* Where Jit::fail returns to, set for the duration of each native call */
+static thread_local std::jmp_buf *failureTarget = nullptr;
+
+typedef uint64_t (*Trampoline)(const uint64_t *inArguments, size_t inCount,
+                               const void *inEntry);
+
+static std::vector<uint8_t> assembleTrampoline() {
+  /* Pushes inCount words of inArguments in order, keeping rsp aligned at
+   * the call, and calls the entry point */
+  using Register = X86Assembler::Register;
+  X86Assembler assembler;
+  X86Assembler::Label aligned = assembler.newLabel();
+  X86Assembler::Label loop = assembler.newLabel();
+  X86Assembler::Label done = assembler.newLabel();
+  assembler.push(Register::Rbp);
+  assembler.move64(Register::Rbp, Register::Rsp);
+  assembler.test64Immediate(Register::Rsi, 1);
+  assembler.jumpIf(X86Assembler::Condition::Equal, aligned);
+  assembler.arithmeticImmediate64(X86Assembler::Arithmetic::Sub,
+                                  Register::Rsp, 8);
+  assembler.bind(aligned);
+  assembler.arithmetic(X86Assembler::Arithmetic::Xor, Register::Rcx,
+                       Register::Rcx);
+  assembler.bind(loop);
+  assembler.arithmetic(X86Assembler::Arithmetic::Cmp, Register::Rcx,
+                       Register::Rsi);
+  assembler.jumpIf(X86Assembler::Condition::AboveEqual, done);
+  assembler.pushIndexed(Register::Rdi, Register::Rcx);
+  assembler.increment64(Register::Rcx);
+  assembler.jump(loop);
+  assembler.bind(done);
+  assembler.call(Register::Rdx);
+  assembler.leave();
+  assembler.ret();
+  return assembler.finish();
+}
+
+Jit::Jit(Context &inContext, size_t inThreshold)
+    : context(inContext), threshold(inThreshold) {}
+
+std::optional<RuntimeValue> Jit::call(const Function &inFunction,
+                                      size_t inMaxCallDepth) {
+#if TKOM_JIT
+  if (!inFunction.getBlock())
+    return std::nullopt;
+  FunctionProfile &profile = profiles[&inFunction];
+  if (++profile.calls < threshold)
+    return std::nullopt;
+
+  argumentTypes.clear();
+  arguments.clear();
+  for (size_t i = 0; i < inFunction.getArguments().size(); ++i) {
+    const RuntimeValue &value = context.getLocalVariable(i)->getValue();
+    switch (value.getType()) {
+    case RuntimeValue::Type::Int:
+      arguments.push_back(static_cast<uint32_t>(value.getInt()));
+      break;
+    case RuntimeValue::Type::Float:
+      arguments.push_back(std::bit_cast<uint32_t>(value.getFloat()));
+      break;
+    case RuntimeValue::Type::Bool:
+      arguments.push_back(value.getBool() ? 1 : 0);
+      break;
+    default:
+      return std::nullopt;
+    }
+    argumentTypes.push_back(value.getType());
+  }
+
+  JitSpecialization &specialization =
+      getSpecialization(inFunction, argumentTypes);
+  if (specialization.state != JitSpecialization::State::Compiled)
+    return std::nullopt;
+
+  /* The frame of inFunction already counts towards the depth */
+  const size_t depth = context.getDepth();
+  callLimits.remainingCalls =
+      inMaxCallDepth > depth ? inMaxCallDepth - depth : 0;
+  callLimits.stackLimit = NativeStack::getLimit();
+  uint64_t value;
+  if (!invoke(specialization, value)) {
+    /* Native code has no side effects, so the interpreter runs the call
+     * again and reports the error. Later calls stay interpreted. */
+    specialization.state = JitSpecialization::State::Failed;
+    return std::nullopt;
+  }
+
+  auto word = static_cast<uint32_t>(value);
+  switch (specialization.returnType) {
+  case RuntimeValue::Type::Int:
+    return RuntimeValue(static_cast<int>(word));
+  case RuntimeValue::Type::Float:
+    return RuntimeValue(std::bit_cast<float>(word));
+  case RuntimeValue::Type::Bool:
+    return RuntimeValue(word != 0);
+  default:
+    return std::nullopt;
+  }
+#else
+  return std::nullopt;
+#endif
+}
+
+JitSpecialization &Jit::getSpecialization(
+    const Function &inFunction,
+    const std::vector<RuntimeValue::Type> &inParameterTypes) {
+  FunctionProfile &profile = profiles[&inFunction];
+  for (const auto &specialization : profile.specializations) {
+    if (specialization->parameterTypes == inParameterTypes)
+      return *specialization;
+  }
+
+  profile.specializations.push_back(std::make_unique<JitSpecialization>());
+  JitSpecialization &specialization = *profile.specializations.back();
+  specialization.function = &inFunction;
+  specialization.parameterTypes = inParameterTypes;
+  compile(specialization);
+  return specialization;
+}
+
+const Function *Jit::findFunction(const std::string &inName) const {
+  return context.findFunction(inName);
+}
+
+size_t Jit::getCompiledCount() const { return compiledCount; }
+
+Jit::CallLimits &Jit::getCallLimits() { return callLimits; }
+
+void Jit::fail() { std::longjmp(*failureTarget, 1); }
+
+float Jit::modulo(float inLhs, float inRhs) { return std::fmod(inLhs, inRhs); }
+
+void Jit::compile(JitSpecialization &inSpecialization) {
+  try {
+    if (!trampoline)
+      trampoline = std::make_unique<ExecutableMemory>(assembleTrampoline());
+
+    /* Calls of the function itself have the return type assumed by the
+     * current pass, compilation repeats until the inferred type is stable */
+    for (size_t pass = 0;; ++pass) {
+      if (pass == MaxInferencePasses)
+        throw JitError("Return type cannot be inferred!");
+      JitCompiler compiler(*this, inSpecialization, false);
+      compiler.compile();
+      if (compiler.getReturnType() == inSpecialization.returnType)
+        break;
+      inSpecialization.returnType = compiler.getReturnType();
+    }
+    if (inSpecialization.returnType == RuntimeValue::Type::Void)
+      throw JitError("Function does not return a value!");
+
+    JitCompiler compiler(*this, inSpecialization, true);
+    inSpecialization.code =
+        std::make_unique<ExecutableMemory>(compiler.compile());
+    inSpecialization.entry = inSpecialization.code->getCode();
+    inSpecialization.state = JitSpecialization::State::Compiled;
+    ++compiledCount;
+  } catch (const JitError &) {
+    inSpecialization.state = JitSpecialization::State::Failed;
+  }
+}
+
+bool Jit::invoke(const JitSpecialization &inSpecialization,
+                 uint64_t &outResult) {
+  auto entry = reinterpret_cast<Trampoline>(
+      const_cast<void *>(trampoline->getCode()));
+
+  /* Nothing with a destructor lives between setjmp and the native frames
+   * abandoned by longjmp */
+  std::jmp_buf target;
+  std::jmp_buf *previousTarget = failureTarget;
+  failureTarget = &target;
+  if (setjmp(target)) {
+    failureTarget = previousTarget;
+    return false;
+  }
+  outResult =
+      entry(arguments.data(), arguments.size(), inSpecialization.entry);
+  failureTarget = previousTarget;
+  return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "../interpreter/RuntimeValue.h"
+#include "ExecutableMemory.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Native code is only generated for x86-64 Linux, elsewhere every call stays
+ * in the interpreter. */
+#if defined(__x86_64__) && defined(__linux__)
+#define TKOM_JIT 1
+#else
+#define TKOM_JIT 0
+#endif
+
+/* Native code of a function specialised for the types of its arguments.
+ * Ints, floats and bools are passed and returned in the low 32 bits of a
+ * 64-bit word. */
+struct JitSpecialization {
+  enum class State { Compiling, Compiled, Failed };
+
+  const class Function *function;
+  std::vector<RuntimeValue::Type> parameterTypes;
+  /* Void until known */
+  RuntimeValue::Type returnType = RuntimeValue::Type::Void;
+  State state = State::Compiling;
+  /* Called through by generated code, so recursive calls can be emitted
+   * before the code exists */
+  const void *entry = nullptr;
+  std::unique_ptr<ExecutableMemory> code;
+};
+
+/* Baseline compiler for hot functions of the tree walker. Once a function
+ * has been called threshold times it is compiled for the types of its
+ * current arguments. Anything the compiler does not cover, and every error
+ * raised while running native code, leaves the call to the interpreter. */
+class Jit {
+public:
+  static constexpr size_t DefaultThreshold = 100;
+
+  /* Limits of native recursion, checked and updated by every call of the
+   * generated code */
+  struct CallLimits {
+    /* Calls that can still be made before the maximum depth is exceeded */
+    uint64_t remainingCalls = 0;
+    /* Lowest stack pointer a call may be made at */
+    uint64_t stackLimit = 0;
+  };
+
+  explicit Jit(class Context &inContext,
+               size_t inThreshold = DefaultThreshold);
+  /* Runs the function whose frame is current natively, nullopt if the
+   * interpreter has to run it. Native calls nested deeper than
+   * inMaxCallDepth or running out of native stack leave it to the
+   * interpreter, which then reports the error. */
+  std::optional<RuntimeValue> call(const class Function &inFunction,
+                                   size_t inMaxCallDepth);
+  /* Compiles inFunction for inParameterTypes unless already attempted */
+  JitSpecialization &
+  getSpecialization(const class Function &inFunction,
+                    const std::vector<RuntimeValue::Type> &inParameterTypes);
+  const class Function *findFunction(const std::string &inName) const;
+  size_t getCompiledCount() const;
+  /* Read and written in place by generated code */
+  CallLimits &getCallLimits();
+
+  /* Entry points called by generated code */
+  [[noreturn]] static void fail();
+  static float modulo(float inLhs, float inRhs);
+
+private:
+  struct FunctionProfile {
+    size_t calls = 0;
+    std::vector<std::unique_ptr<JitSpecialization>> specializations;
+  };
+
+  void compile(JitSpecialization &inSpecialization);
+  bool invoke(const JitSpecialization &inSpecialization, uint64_t &outResult);
+
+  Context &context;
+  size_t threshold;
+  size_t compiledCount = 0;
+  std::unordered_map<const class Function *, FunctionProfile> profiles;
+  std::vector<RuntimeValue::Type> argumentTypes;
+  std::vector<uint64_t> arguments;
+  CallLimits callLimits;
+  /* Pushes an argument array and calls an entry point */
+  std::unique_ptr<ExecutableMemory> trampoline;
+};
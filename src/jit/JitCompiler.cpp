@@ -0,0 +1,669 @@
+#include "JitCompiler.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "Jit.h"
+#include "JitError.h"
+#include <bit>
+#include <cstddef>
+
+using Condition = X86Assembler::Condition;
+using Arithmetic = X86Assembler::Arithmetic;
+using ScalarFloat = X86Assembler::ScalarFloat;
+using Xmm = X86Assembler::Xmm;
+using Type = RuntimeValue::Type;
+
+JitCompiler::JitCompiler(Jit &inJit, JitSpecialization &inSpecialization,
+                         bool bInRequireTypes)
+    : jit(inJit), specialization(inSpecialization),
+      bRequireTypes(bInRequireTypes) {}
+
+std::vector<uint8_t> JitCompiler::compile() {
+  const Function &function = *specialization.function;
+  const auto &parameters = function.getArguments();
+  slots.assign(function.getSlotCount(), Slot());
+  returnLabel = assembler.newLabel();
+  failLabel = assembler.newLabel();
+
+  /* Keep rsp 16 byte aligned while no temporaries are pushed */
+  size_t frameSize = (slots.size() + slots.size() % 2) * 8;
+  assembler.push(Register::Rbp);
+  assembler.move64(Register::Rbp, Register::Rsp);
+  if (frameSize)
+    assembler.arithmeticImmediate64(Arithmetic::Sub, Register::Rsp,
+                                    static_cast<int32_t>(frameSize));
+
+  /* Arguments are pushed in order above the return address */
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    assembler.load64(
+        Register::Rax, Register::Rbp,
+        static_cast<int32_t>(16 + 8 * (parameters.size() - 1 - i)));
+    assembler.store64(Register::Rbp, slotOffset(i), Register::Rax);
+    slots[i] = Slot{Slot::State::Declared, specialization.parameterTypes[i],
+                    parameters[i]->isMutable()};
+  }
+
+  function.getBlock()->accept(*this);
+
+  /* Falling off the end returns nothing, which is left to the interpreter */
+  assembler.jump(failLabel);
+
+  assembler.bind(returnLabel);
+  assembler.leave();
+  assembler.ret();
+
+  assembler.bind(failLabel);
+  assembler.arithmeticImmediate64(Arithmetic::And, Register::Rsp, -16);
+  assembler.moveImmediate64(Register::Rax,
+                            reinterpret_cast<uint64_t>(&Jit::fail));
+  assembler.call(Register::Rax);
+  return assembler.finish();
+}
+
+RuntimeValue::Type JitCompiler::getReturnType() const { return returnType; }
+
+Completion JitCompiler::visit(const Program &inProgram) {
+  throw JitError("Programs are not compiled!");
+}
+
+Completion JitCompiler::visit(const BinaryExpression &inBinaryExpression) {
+  if (inBinaryExpression.isLogical()) {
+    /* A left operand that decides is already the result in eax */
+    X86Assembler::Label endLabel = assembler.newLabel();
+    inBinaryExpression.getLhs()->accept(*this);
+    requireBool();
+    assembler.test(Register::Rax, Register::Rax);
+    assembler.jumpIf(inBinaryExpression.getOperator() ==
+                             Expression::Operator::LogicalOr
+                         ? Condition::NotEqual
+                         : Condition::Equal,
+                     endLabel);
+    inBinaryExpression.getRhs()->accept(*this);
+    requireBool();
+    assembler.bind(endLabel);
+    type = Type::Bool;
+    return Completion::Normal;
+  }
+
+  compileOperation(inBinaryExpression.getOperator(),
+                   compileOperands(inBinaryExpression));
+  return Completion::Normal;
+}
+
+Type JitCompiler::compileOperands(const BinaryExpression &inBinaryExpression) {
+  inBinaryExpression.getLhs()->accept(*this);
+  Type lhsType = type;
+  push();
+  inBinaryExpression.getRhs()->accept(*this);
+  Type rhsType = type;
+  assembler.move(Register::Rcx, Register::Rax);
+  pop(Register::Rax);
+
+  if (lhsType == Type::Void || rhsType == Type::Void) {
+    requireType(Type::Void);
+    return Type::Void;
+  }
+  if (lhsType != rhsType)
+    throw JitError("Operands of different types!");
+  return lhsType;
+}
+
+void JitCompiler::compileOperation(Expression::Operator inOperator,
+                                   Type inOperandType) {
+  switch (inOperandType) {
+  case Type::Void:
+    type = inOperator >= Expression::Operator::Less ? Type::Bool : Type::Void;
+    break;
+  case Type::Int:
+    compileIntOperation(inOperator);
+    break;
+  case Type::Float:
+    compileFloatOperation(inOperator);
+    break;
+  case Type::Bool:
+    compileBoolOperation(inOperator);
+    break;
+  default:
+    throw JitError("Unsupported operand type!");
+  }
+}
+
+void JitCompiler::compileIntOperation(Expression::Operator inOperator) {
+  type = Type::Int;
+  switch (inOperator) {
+  case Expression::Operator::Sum:
+    assembler.arithmetic(Arithmetic::Add, Register::Rax, Register::Rcx);
+    return;
+  case Expression::Operator::Substraction:
+    assembler.arithmetic(Arithmetic::Sub, Register::Rax, Register::Rcx);
+    return;
+  case Expression::Operator::Multiplication:
+    assembler.multiply(Register::Rax, Register::Rcx);
+    return;
+  case Expression::Operator::Division:
+  case Expression::Operator::Modulo:
+    /* Division by zero is reported by the interpreter, dividing by -1 may
+     * trap on overflow */
+    assembler.test(Register::Rcx, Register::Rcx);
+    assembler.jumpIf(Condition::Equal, failLabel);
+    assembler.arithmeticImmediate(Arithmetic::Cmp, Register::Rcx, -1);
+    assembler.jumpIf(Condition::Equal, failLabel);
+    assembler.signExtendEax();
+    assembler.signedDivide(Register::Rcx);
+    if (inOperator == Expression::Operator::Modulo)
+      assembler.move(Register::Rax, Register::Rdx);
+    return;
+  case Expression::Operator::Less:
+    return compileComparison(Condition::Less);
+  case Expression::Operator::LessEqual:
+    return compileComparison(Condition::LessEqual);
+  case Expression::Operator::More:
+    return compileComparison(Condition::Greater);
+  case Expression::Operator::MoreEqual:
+    return compileComparison(Condition::GreaterEqual);
+  case Expression::Operator::Equal:
+    return compileComparison(Condition::Equal);
+  case Expression::Operator::NotEqual:
+    return compileComparison(Condition::NotEqual);
+  default:
+    throw JitError("Unsupported int operator!");
+  }
+}
+
+void JitCompiler::compileFloatOperation(Expression::Operator inOperator) {
+  type = Type::Float;
+  assembler.moveToXmm(Xmm::Xmm0, Register::Rax);
+  assembler.moveToXmm(Xmm::Xmm1, Register::Rcx);
+  switch (inOperator) {
+  case Expression::Operator::Sum:
+    assembler.scalarFloat(ScalarFloat::Add, Xmm::Xmm0, Xmm::Xmm1);
+    break;
+  case Expression::Operator::Substraction:
+    assembler.scalarFloat(ScalarFloat::Subtract, Xmm::Xmm0, Xmm::Xmm1);
+    break;
+  case Expression::Operator::Multiplication:
+    assembler.scalarFloat(ScalarFloat::Multiply, Xmm::Xmm0, Xmm::Xmm1);
+    break;
+  case Expression::Operator::Division:
+  case Expression::Operator::Modulo: {
+    /* Fail on a divisor equal to 0.0, NaN compares unordered */
+    X86Assembler::Label nonZero = assembler.newLabel();
+    assembler.clearXmm(Xmm::Xmm2);
+    assembler.compareFloat(Xmm::Xmm1, Xmm::Xmm2);
+    assembler.jumpIf(Condition::Parity, nonZero);
+    assembler.jumpIf(Condition::Equal, failLabel);
+    assembler.bind(nonZero);
+    if (inOperator == Expression::Operator::Division) {
+      assembler.scalarFloat(ScalarFloat::Divide, Xmm::Xmm0, Xmm::Xmm1);
+    } else {
+      compileHelperCall(reinterpret_cast<const void *>(&Jit::modulo));
+    }
+    break;
+  }
+  /* Comparisons are unsigned on flags of ucomiss, operands are swapped for
+   * less so that an unordered result is false */
+  case Expression::Operator::Less:
+    assembler.compareFloat(Xmm::Xmm1, Xmm::Xmm0);
+    return compileComparison(Condition::Above);
+  case Expression::Operator::LessEqual:
+    assembler.compareFloat(Xmm::Xmm1, Xmm::Xmm0);
+    return compileComparison(Condition::AboveEqual);
+  case Expression::Operator::More:
+    assembler.compareFloat(Xmm::Xmm0, Xmm::Xmm1);
+    return compileComparison(Condition::Above);
+  case Expression::Operator::MoreEqual:
+    assembler.compareFloat(Xmm::Xmm0, Xmm::Xmm1);
+    return compileComparison(Condition::AboveEqual);
+  case Expression::Operator::Equal:
+    assembler.compareFloat(Xmm::Xmm0, Xmm::Xmm1);
+    assembler.setIf(Condition::Equal, Register::Rax);
+    assembler.setIf(Condition::NoParity, Register::Rcx);
+    assembler.arithmeticByte(Arithmetic::And, Register::Rax, Register::Rcx);
+    assembler.zeroExtendByte(Register::Rax, Register::Rax);
+    type = Type::Bool;
+    return;
+  case Expression::Operator::NotEqual:
+    assembler.compareFloat(Xmm::Xmm0, Xmm::Xmm1);
+    assembler.setIf(Condition::NotEqual, Register::Rax);
+    assembler.setIf(Condition::Parity, Register::Rcx);
+    assembler.arithmeticByte(Arithmetic::Or, Register::Rax, Register::Rcx);
+    assembler.zeroExtendByte(Register::Rax, Register::Rax);
+    type = Type::Bool;
+    return;
+  default:
+    throw JitError("Unsupported float operator!");
+  }
+  assembler.moveFromXmm(Register::Rax, Xmm::Xmm0);
+}
+
+void JitCompiler::compileBoolOperation(Expression::Operator inOperator) {
+  type = Type::Bool;
+  switch (inOperator) {
+  case Expression::Operator::Equal:
+    return compileComparison(Condition::Equal);
+  case Expression::Operator::NotEqual:
+    return compileComparison(Condition::NotEqual);
+  default:
+    throw JitError("Unsupported bool operator!");
+  }
+}
+
+bool JitCompiler::compileBranch(const Expression &inCondition, bool bJumpIf,
+                                X86Assembler::Label inTarget) {
+  /* || and && become jumps on their operands. The left operand of || jumps
+   * when true and the one of && when false, to the target when that is the
+   * outcome wanted and past the right operand otherwise */
+  auto *binaryExpression = dynamic_cast<const BinaryExpression *>(&inCondition);
+  if (binaryExpression && binaryExpression->isLogical()) {
+    const bool bIsOr =
+        binaryExpression->getOperator() == Expression::Operator::LogicalOr;
+    X86Assembler::Label skipLabel = assembler.newLabel();
+    if (!compileBranch(*binaryExpression->getLhs(), bIsOr,
+                       bIsOr == bJumpIf ? inTarget : skipLabel) ||
+        !compileBranch(*binaryExpression->getRhs(), bJumpIf, inTarget))
+      throw JitError("Logical operators are only compiled for bools!");
+    assembler.bind(skipLabel);
+    return true;
+  }
+
+  /* Comparisons jump on the flags they set */
+  if (binaryExpression && binaryExpression->isComparison()) {
+    const Type operandType = compileOperands(*binaryExpression);
+    if (auto condition =
+            compileFlags(binaryExpression->getOperator(), operandType)) {
+      assembler.jumpIf(bJumpIf ? *condition
+                               : static_cast<Condition>(
+                                     static_cast<uint8_t>(*condition) ^ 1),
+                       inTarget);
+      return true;
+    }
+    compileOperation(binaryExpression->getOperator(), operandType);
+  } else {
+    inCondition.accept(*this);
+  }
+  if (type != Type::Bool && type != Type::Void)
+    return false;
+  assembler.test(Register::Rax, Register::Rax);
+  assembler.jumpIf(bJumpIf ? Condition::NotEqual : Condition::Equal, inTarget);
+  return true;
+}
+
+std::optional<Condition>
+JitCompiler::compileFlags(Expression::Operator inOperator, Type inOperandType) {
+  /* Float equality also has to test parity, so it keeps its bool */
+  using Op = Expression::Operator;
+  if (inOperandType == Type::Int ||
+      (inOperandType == Type::Bool &&
+       (inOperator == Op::Equal || inOperator == Op::NotEqual))) {
+    assembler.arithmetic(Arithmetic::Cmp, Register::Rax, Register::Rcx);
+    switch (inOperator) {
+    case Op::Less:
+      return Condition::Less;
+    case Op::LessEqual:
+      return Condition::LessEqual;
+    case Op::More:
+      return Condition::Greater;
+    case Op::MoreEqual:
+      return Condition::GreaterEqual;
+    case Op::Equal:
+      return Condition::Equal;
+    default:
+      return Condition::NotEqual;
+    }
+  }
+  if (inOperandType != Type::Float || inOperator > Op::MoreEqual)
+    return std::nullopt;
+
+  assembler.moveToXmm(Xmm::Xmm0, Register::Rax);
+  assembler.moveToXmm(Xmm::Xmm1, Register::Rcx);
+  if (inOperator == Op::Less || inOperator == Op::LessEqual)
+    assembler.compareFloat(Xmm::Xmm1, Xmm::Xmm0);
+  else
+    assembler.compareFloat(Xmm::Xmm0, Xmm::Xmm1);
+  return inOperator == Op::Less || inOperator == Op::More
+             ? Condition::Above
+             : Condition::AboveEqual;
+}
+
+void JitCompiler::compileComparison(Condition inCondition) {
+  /* Integer operands are still in eax and ecx, float flags are already set */
+  if (type != Type::Float)
+    assembler.arithmetic(Arithmetic::Cmp, Register::Rax, Register::Rcx);
+  assembler.setIf(inCondition, Register::Rax);
+  assembler.zeroExtendByte(Register::Rax, Register::Rax);
+  type = Type::Bool;
+}
+
+void JitCompiler::compileHelperCall(const void *inFunction) {
+  bool bPad = stackDepth % 2 != 0;
+  if (bPad)
+    assembler.arithmeticImmediate64(Arithmetic::Sub, Register::Rsp, 8);
+  assembler.moveImmediate64(Register::Rax,
+                            reinterpret_cast<uint64_t>(inFunction));
+  assembler.call(Register::Rax);
+  if (bPad)
+    assembler.arithmeticImmediate64(Arithmetic::Add, Register::Rsp, 8);
+}
+
+Completion JitCompiler::visit(const Block &inBlock) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    instruction->accept(*this);
+  }
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const Case &inCase) {
+  throw JitError("Match is not supported!");
+}
+
+Completion JitCompiler::visit(const Function &inFunction) {
+  throw JitError("Functions are compiled through compile!");
+}
+
+Completion JitCompiler::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  compileCall(*static_cast<const InstructionFunctionCall *>(
+      inFunctionCallExpression.getFunctionCall()));
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const IfElse &inIfElse) {
+  X86Assembler::Label elseLabel = assembler.newLabel();
+  X86Assembler::Label endLabel = assembler.newLabel();
+  if (!compileBranch(*inIfElse.getExpression(), false, elseLabel)) {
+    /* Conditions other than bools are false */
+    assembler.jump(elseLabel);
+  }
+
+  std::vector<Slot> savedSlots = slots;
+  inIfElse.getBlockIf()->accept(*this);
+  std::swap(slots, savedSlots);
+  if (inIfElse.getBlockElse()) {
+    assembler.jump(endLabel);
+    assembler.bind(elseLabel);
+    inIfElse.getBlockElse()->accept(*this);
+  } else {
+    assembler.bind(elseLabel);
+  }
+  assembler.bind(endLabel);
+  mergeSlots(savedSlots);
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const InstructionAssigment &inAssigment) {
+  Slot &slot = slots[inAssigment.getVariable()->getSlot()];
+  if (slot.state != Slot::State::Declared || !slot.bIsMutable)
+    throw JitError("Assignment checked at runtime!");
+
+  inAssigment.getExpression()->accept(*this);
+  if (slot.type == Type::Void) {
+    slot.type = type;
+  } else if (type != Type::Void && type != slot.type) {
+    throw JitError("Variable changes its type!");
+  }
+  assembler.store64(Register::Rbp,
+                    slotOffset(inAssigment.getVariable()->getSlot()),
+                    Register::Rax);
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  /* A declaration runs again on the next iteration and has to fail then */
+  if (loopDepth > 0)
+    throw JitError("Declaration inside a loop!");
+  Slot &slot = slots[inDeclarationVariable.getSlot()];
+  if (slot.state != Slot::State::Undeclared)
+    throw JitError("Redeclaration checked at runtime!");
+
+  if (inDeclarationVariable.getExpression()) {
+    inDeclarationVariable.getExpression()->accept(*this);
+  } else {
+    assembler.moveImmediate(Register::Rax, 0);
+    type = Type::Int;
+  }
+  assembler.store64(Register::Rbp, slotOffset(inDeclarationVariable.getSlot()),
+                    Register::Rax);
+  slot = Slot{Slot::State::Declared, type, inDeclarationVariable.isMutable()};
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const InstructionFunctionCall &inFunctionCall) {
+  compileCall(inFunctionCall);
+  return Completion::Normal;
+}
+
+void JitCompiler::compileCall(const InstructionFunctionCall &inFunctionCall) {
+  const Function *function = jit.findFunction(inFunctionCall.getFunctionName());
+  if (function == nullptr || !function->getBlock())
+    throw JitError("Only calls of user functions are supported!");
+  const auto &arguments = inFunctionCall.getExpressions();
+  if (function->getArguments().size() != arguments.size())
+    throw JitError("Invalid number of arguments!");
+
+  size_t padding = (stackDepth + arguments.size()) % 2;
+  if (padding) {
+    assembler.arithmeticImmediate64(Arithmetic::Sub, Register::Rsp, 8);
+    stackDepth += padding;
+  }
+  std::vector<Type> argumentTypes;
+  bool bKnownTypes = true;
+  for (const auto &argument : arguments) {
+    argument->accept(*this);
+    argumentTypes.push_back(type);
+    bKnownTypes = bKnownTypes && type != Type::Void;
+    push();
+  }
+
+  if (!bKnownTypes) {
+    requireType(Type::Void);
+    type = Type::Void;
+  } else {
+    const JitSpecialization *callee = &specialization;
+    if (function != specialization.function ||
+        argumentTypes != specialization.parameterTypes) {
+      callee = &jit.getSpecialization(*function, argumentTypes);
+      if (callee->state != JitSpecialization::State::Compiled)
+        throw JitError("Callee cannot be compiled!");
+    }
+    compileCallLimitCheck();
+    assembler.moveImmediate64(Register::Rax,
+                              reinterpret_cast<uint64_t>(&callee->entry));
+    assembler.callIndirect(Register::Rax);
+    /* Give back the call taken by the check */
+    assembler.moveImmediate64(
+        Register::Rcx, reinterpret_cast<uint64_t>(&jit.getCallLimits()));
+    assembler.load64(Register::Rdx, Register::Rcx,
+                     offsetof(Jit::CallLimits, remainingCalls));
+    assembler.increment64(Register::Rdx);
+    assembler.store64(Register::Rcx, offsetof(Jit::CallLimits, remainingCalls),
+                      Register::Rdx);
+    type = callee->returnType;
+    if (type == Type::Void)
+      requireType(type);
+  }
+
+  size_t words = arguments.size() + padding;
+  if (words)
+    assembler.arithmeticImmediate64(Arithmetic::Add, Register::Rsp,
+                                    static_cast<int32_t>(8 * words));
+  stackDepth -= words;
+}
+
+void JitCompiler::compileCallLimitCheck() {
+  /* Calls past the maximum depth or too close to the end of the native stack
+   * fail, so the interpreter reports them */
+  assembler.moveImmediate64(Register::Rax,
+                            reinterpret_cast<uint64_t>(&jit.getCallLimits()));
+  assembler.load64(Register::Rcx, Register::Rax,
+                   offsetof(Jit::CallLimits, remainingCalls));
+  assembler.test64Immediate(Register::Rcx, -1);
+  assembler.jumpIf(Condition::Equal, failLabel);
+  assembler.arithmeticImmediate64(Arithmetic::Sub, Register::Rcx, 1);
+  assembler.store64(Register::Rax, offsetof(Jit::CallLimits, remainingCalls),
+                    Register::Rcx);
+  assembler.load64(Register::Rcx, Register::Rax,
+                   offsetof(Jit::CallLimits, stackLimit));
+  assembler.arithmetic64(Arithmetic::Cmp, Register::Rsp, Register::Rcx);
+  assembler.jumpIf(Condition::Below, failLabel);
+}
+
+Completion JitCompiler::visit(const IntFunction &inIntFunction) {
+  throw JitError("Builtins are not supported!");
+}
+
+Completion JitCompiler::visit(const StringFunction &inStringFunction) {
+  throw JitError("Builtins are not supported!");
+}
+
+Completion JitCompiler::visit(const FloatFunction &inFloatFunction) {
+  throw JitError("Builtins are not supported!");
+}
+
+Completion JitCompiler::visit(const BoolFunction &inBoolFunction) {
+  throw JitError("Builtins are not supported!");
+}
+
+Completion JitCompiler::visit(const PrintFunction &inPrintFunction) {
+  throw JitError("Builtins are not supported!");
+}
+
+Completion JitCompiler::visit(const InstructionReturn &inReturn) {
+  if (!inReturn.getExpression()) {
+    assembler.jump(failLabel);
+    return Completion::Normal;
+  }
+
+  inReturn.getExpression()->accept(*this);
+  if (returnType == Type::Void) {
+    returnType = type;
+  } else if (type != Type::Void && type != returnType) {
+    throw JitError("Returned values of different types!");
+  }
+  assembler.jump(returnLabel);
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const Match &inMatch) {
+  throw JitError("Match is not supported!");
+}
+
+Completion JitCompiler::visit(const UnaryExpression &inUnaryExpression) {
+  inUnaryExpression.getExpression()->accept(*this);
+  switch (type) {
+  case Type::Int:
+    assembler.negate(Register::Rax);
+    break;
+  case Type::Float:
+    assembler.arithmeticImmediate(Arithmetic::Xor, Register::Rax,
+                                  static_cast<int32_t>(0x80000000u));
+    break;
+  case Type::Bool:
+    assembler.arithmeticImmediate(Arithmetic::Xor, Register::Rax, 1);
+    break;
+  case Type::Void:
+    requireType(Type::Void);
+    break;
+  default:
+    throw JitError("Unsupported operand type!");
+  }
+  return Completion::Normal;
+}
+
+Completion
+JitCompiler::visit(const VariableExpression &inVariableExpression) {
+  const auto &variable = inVariableExpression.getVariable();
+  if (const auto &value = variable->getValue()) {
+    const RuntimeValue &constant = value->getRuntimeValue();
+    type = constant.getType();
+    switch (type) {
+    case Type::Int:
+      assembler.moveImmediate(Register::Rax,
+                              static_cast<uint32_t>(constant.getInt()));
+      break;
+    case Type::Float:
+      assembler.moveImmediate(
+          Register::Rax, std::bit_cast<uint32_t>(constant.getFloat()));
+      break;
+    case Type::Bool:
+      assembler.moveImmediate(Register::Rax, constant.getBool() ? 1 : 0);
+      break;
+    default:
+      throw JitError("Unsupported constant type!");
+    }
+    return Completion::Normal;
+  }
+
+  const Slot &slot = slots[variable->getSlot()];
+  if (slot.state != Slot::State::Declared)
+    throw JitError("Read checked at runtime!");
+  assembler.load64(Register::Rax, Register::Rbp,
+                   slotOffset(variable->getSlot()));
+  type = slot.type;
+  if (type == Type::Void)
+    requireType(type);
+  return Completion::Normal;
+}
+
+Completion JitCompiler::visit(const While &inWhile) {
+  X86Assembler::Label startLabel = assembler.newLabel();
+  X86Assembler::Label endLabel = assembler.newLabel();
+  assembler.bind(startLabel);
+  if (!compileBranch(*inWhile.getExpression(), false, endLabel)) {
+    /* The interpreter reports conditions other than bools */
+    assembler.jump(failLabel);
+  }
+
+  ++loopDepth;
+  inWhile.getBody()->accept(*this);
+  --loopDepth;
+  assembler.jump(startLabel);
+  assembler.bind(endLabel);
+  return Completion::Normal;
+}
+
+void JitCompiler::mergeSlots(const std::vector<Slot> &inOther) {
+  for (size_t i = 0; i < slots.size(); ++i) {
+    const Slot &other = inOther[i];
+    if (slots[i].state != other.state || slots[i].type != other.type ||
+        slots[i].bIsMutable != other.bIsMutable)
+      slots[i].state = Slot::State::Maybe;
+  }
+}
+
+void JitCompiler::requireBool() const {
+  if (type != Type::Bool && type != Type::Void)
+    throw JitError("Logical operators are only compiled for bools!");
+  requireType(type);
+}
+
+void JitCompiler::requireType(Type inType) const {
+  if (inType == Type::Void && bRequireTypes)
+    throw JitError("Type of expression is not known!");
+}
+
+void JitCompiler::push() {
+  assembler.push(Register::Rax);
+  ++stackDepth;
+}
+
+void JitCompiler::pop(Register inRegister) {
+  assembler.pop(inRegister);
+  --stackDepth;
+}
+
+int32_t JitCompiler::slotOffset(size_t inSlot) {
+  return -8 * static_cast<int32_t>(inSlot + 1);
+}
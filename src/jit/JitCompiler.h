@@ -0,0 +1,109 @@
+#pragma once
+#include "../instructions/Expression.h"
+#include "../interpreter/VisitorInterpreter.h"
+#include "X86Assembler.h"
+#include <optional>
+#include <vector>
+
+/* Template compiler from the AST of one function to x86-64 code. Values are
+ * computed into eax with temporaries on the machine stack, locals live in
+ * the native frame below rbp. Types are tracked statically from the
+ * parameter types of the specialization, a Void type means not known yet:
+ * it is tolerated while the return type of a recursive function is inferred
+ * and rejected by the final pass. Anything that is not supported throws a
+ * JitError. */
+class JitCompiler : public VisitorInterpreter {
+public:
+  JitCompiler(class Jit &inJit, struct JitSpecialization &inSpecialization,
+              bool bInRequireTypes);
+  std::vector<uint8_t> compile();
+  /* Common type of all returned values, Void if none is known */
+  RuntimeValue::Type getReturnType() const;
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  typedef X86Assembler::Register Register;
+
+  /* Declaration state of a slot along the current path. Maybe marks slots
+   * declared on some paths only, which the interpreter would have to check
+   * at runtime. */
+  struct Slot {
+    enum class State { Undeclared, Declared, Maybe };
+    State state = State::Undeclared;
+    RuntimeValue::Type type = RuntimeValue::Type::Void;
+    bool bIsMutable = false;
+  };
+
+  void compileCall(const class InstructionFunctionCall &inFunctionCall);
+  /* Takes a call from Jit::CallLimits before calling into native code */
+  void compileCallLimitCheck();
+  void compileIntOperation(Expression::Operator inOperator);
+  void compileFloatOperation(Expression::Operator inOperator);
+  void compileBoolOperation(Expression::Operator inOperator);
+  /* Evaluates the operands into eax and ecx, returns their common type or
+   * Void when it is not known */
+  RuntimeValue::Type
+  compileOperands(const class BinaryExpression &inBinaryExpression);
+  void compileOperation(Expression::Operator inOperator,
+                        RuntimeValue::Type inOperandType);
+  void compileComparison(X86Assembler::Condition inCondition);
+  /* Sets the flags for a comparison and returns the condition holding when
+   * it is true, nullopt when it has to be computed as a bool instead */
+  std::optional<X86Assembler::Condition>
+  compileFlags(Expression::Operator inOperator,
+               RuntimeValue::Type inOperandType);
+  /* Jumps to inTarget when inCondition is bJumpIf, false when it is not a
+   * bool */
+  bool compileBranch(const class Expression &inCondition, bool bJumpIf,
+                     X86Assembler::Label inTarget);
+  void compileHelperCall(const void *inFunction);
+  void mergeSlots(const std::vector<Slot> &inOther);
+  void requireType(RuntimeValue::Type inType) const;
+  /* Operands of || and && are compiled for bools only */
+  void requireBool() const;
+  void push();
+  void pop(Register inRegister);
+  static int32_t slotOffset(size_t inSlot);
+
+  Jit &jit;
+  JitSpecialization &specialization;
+  bool bRequireTypes;
+  X86Assembler assembler;
+  X86Assembler::Label returnLabel = 0;
+  X86Assembler::Label failLabel = 0;
+  std::vector<Slot> slots;
+  /* Type of the value in eax */
+  RuntimeValue::Type type = RuntimeValue::Type::Void;
+  RuntimeValue::Type returnType = RuntimeValue::Type::Void;
+  /* Words pushed since the frame was set up, kept to align calls */
+  size_t stackDepth = 0;
+  size_t loopDepth = 0;
+};
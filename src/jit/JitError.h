@@ -0,0 +1,12 @@
+#pragma once
+#include <stdexcept>
+
+/* Reason why a function cannot be compiled to native code, the function is
+ * then left to the interpreter */
+class JitError : public std::runtime_error {
+public:
+  explicit JitError(const std::string &_Message)
+      : std::runtime_error(_Message.c_str()) {}
+
+  explicit JitError(const char *_Message) : std::runtime_error(_Message) {}
+};
@@ -0,0 +1,259 @@
+#include "X86Assembler.h"
+#include "JitError.h"
+#include <limits>
+
+static constexpr size_t UnboundLabel = std::numeric_limits<size_t>::max();
+static constexpr uint8_t Rex64 = 0x48;
+
+static uint8_t encoding(X86Assembler::Register inRegister) {
+  return static_cast<uint8_t>(inRegister);
+}
+
+static uint8_t encoding(X86Assembler::Xmm inRegister) {
+  return static_cast<uint8_t>(inRegister);
+}
+
+X86Assembler::Label X86Assembler::newLabel() {
+  labels.push_back(UnboundLabel);
+  return labels.size() - 1;
+}
+
+void X86Assembler::bind(Label inLabel) { labels[inLabel] = code.size(); }
+
+void X86Assembler::jump(Label inLabel) {
+  emit(0xE9);
+  emitLabel(inLabel);
+}
+
+void X86Assembler::jumpIf(Condition inCondition, Label inLabel) {
+  emit(0x0F);
+  emit(0x80 | static_cast<uint8_t>(inCondition));
+  emitLabel(inLabel);
+}
+
+void X86Assembler::push(Register inRegister) {
+  emit(0x50 | encoding(inRegister));
+}
+
+void X86Assembler::pushIndexed(Register inBase, Register inIndex) {
+  /* push qword [base + index * 8] */
+  emit(0xFF);
+  emitModRM(0, 6, 4);
+  emit(0xC0 | (encoding(inIndex) << 3) | encoding(inBase));
+}
+
+void X86Assembler::pop(Register inRegister) {
+  emit(0x58 | encoding(inRegister));
+}
+
+void X86Assembler::moveImmediate(Register inRegister, uint32_t inValue) {
+  emit(0xB8 | encoding(inRegister));
+  emit32(inValue);
+}
+
+void X86Assembler::moveImmediate64(Register inRegister, uint64_t inValue) {
+  emit(Rex64);
+  emit(0xB8 | encoding(inRegister));
+  emit32(static_cast<uint32_t>(inValue));
+  emit32(static_cast<uint32_t>(inValue >> 32));
+}
+
+void X86Assembler::move(Register inDestination, Register inSource) {
+  emit(0x89);
+  emitModRM(3, encoding(inSource), encoding(inDestination));
+}
+
+void X86Assembler::move64(Register inDestination, Register inSource) {
+  emit(Rex64);
+  move(inDestination, inSource);
+}
+
+void X86Assembler::load64(Register inDestination, Register inBase,
+                          int32_t inOffset) {
+  emit(Rex64);
+  emit(0x8B);
+  emitModRM(2, encoding(inDestination), encoding(inBase));
+  emit32(static_cast<uint32_t>(inOffset));
+}
+
+void X86Assembler::store64(Register inBase, int32_t inOffset,
+                           Register inSource) {
+  emit(Rex64);
+  emit(0x89);
+  emitModRM(2, encoding(inSource), encoding(inBase));
+  emit32(static_cast<uint32_t>(inOffset));
+}
+
+void X86Assembler::arithmetic(Arithmetic inOperation, Register inDestination,
+                              Register inSource) {
+  emit(static_cast<uint8_t>(inOperation));
+  emitModRM(3, encoding(inSource), encoding(inDestination));
+}
+
+void X86Assembler::arithmetic64(Arithmetic inOperation,
+                                Register inDestination, Register inSource) {
+  emit(Rex64);
+  arithmetic(inOperation, inDestination, inSource);
+}
+
+void X86Assembler::arithmeticImmediate(Arithmetic inOperation,
+                                       Register inDestination,
+                                       int32_t inValue) {
+  uint8_t digit = static_cast<uint8_t>(inOperation) >> 3;
+  if (inValue >= -128 && inValue <= 127) {
+    emit(0x83);
+    emitModRM(3, digit, encoding(inDestination));
+    emit(static_cast<uint8_t>(inValue));
+  } else {
+    emit(0x81);
+    emitModRM(3, digit, encoding(inDestination));
+    emit32(static_cast<uint32_t>(inValue));
+  }
+}
+
+void X86Assembler::arithmeticImmediate64(Arithmetic inOperation,
+                                         Register inDestination,
+                                         int32_t inValue) {
+  emit(Rex64);
+  arithmeticImmediate(inOperation, inDestination, inValue);
+}
+
+void X86Assembler::test(Register inLhs, Register inRhs) {
+  emit(0x85);
+  emitModRM(3, encoding(inRhs), encoding(inLhs));
+}
+
+void X86Assembler::test64Immediate(Register inRegister, int32_t inValue) {
+  emit(Rex64);
+  emit(0xF7);
+  emitModRM(3, 0, encoding(inRegister));
+  emit32(static_cast<uint32_t>(inValue));
+}
+
+void X86Assembler::multiply(Register inDestination, Register inSource) {
+  emit(0x0F);
+  emit(0xAF);
+  emitModRM(3, encoding(inDestination), encoding(inSource));
+}
+
+void X86Assembler::signedDivide(Register inDivisor) {
+  emit(0xF7);
+  emitModRM(3, 7, encoding(inDivisor));
+}
+
+void X86Assembler::signExtendEax() { emit(0x99); }
+
+void X86Assembler::negate(Register inRegister) {
+  emit(0xF7);
+  emitModRM(3, 3, encoding(inRegister));
+}
+
+void X86Assembler::increment64(Register inRegister) {
+  emit(Rex64);
+  emit(0xFF);
+  emitModRM(3, 0, encoding(inRegister));
+}
+
+void X86Assembler::setIf(Condition inCondition, Register inRegister) {
+  /* Without a REX prefix only the low bytes of rax to rbx are addressable */
+  if (encoding(inRegister) > encoding(Register::Rbx))
+    throw JitError("Byte register not encodable!");
+  emit(0x0F);
+  emit(0x90 | static_cast<uint8_t>(inCondition));
+  emitModRM(3, 0, encoding(inRegister));
+}
+
+void X86Assembler::zeroExtendByte(Register inDestination, Register inSource) {
+  emit(0x0F);
+  emit(0xB6);
+  emitModRM(3, encoding(inDestination), encoding(inSource));
+}
+
+void X86Assembler::arithmeticByte(Arithmetic inOperation,
+                                  Register inDestination, Register inSource) {
+  emit(static_cast<uint8_t>(inOperation) - 1);
+  emitModRM(3, encoding(inSource), encoding(inDestination));
+}
+
+void X86Assembler::moveToXmm(Xmm inDestination, Register inSource) {
+  emit(0x66);
+  emit(0x0F);
+  emit(0x6E);
+  emitModRM(3, encoding(inDestination), encoding(inSource));
+}
+
+void X86Assembler::moveFromXmm(Register inDestination, Xmm inSource) {
+  emit(0x66);
+  emit(0x0F);
+  emit(0x7E);
+  emitModRM(3, encoding(inSource), encoding(inDestination));
+}
+
+void X86Assembler::scalarFloat(ScalarFloat inOperation, Xmm inDestination,
+                               Xmm inSource) {
+  emit(0xF3);
+  emit(0x0F);
+  emit(static_cast<uint8_t>(inOperation));
+  emitModRM(3, encoding(inDestination), encoding(inSource));
+}
+
+void X86Assembler::compareFloat(Xmm inLhs, Xmm inRhs) {
+  emit(0x0F);
+  emit(0x2E);
+  emitModRM(3, encoding(inLhs), encoding(inRhs));
+}
+
+void X86Assembler::clearXmm(Xmm inRegister) {
+  emit(0x0F);
+  emit(0x57);
+  emitModRM(3, encoding(inRegister), encoding(inRegister));
+}
+
+void X86Assembler::call(Register inTarget) {
+  emit(0xFF);
+  emitModRM(3, 2, encoding(inTarget));
+}
+
+void X86Assembler::callIndirect(Register inAddress) {
+  if (inAddress == Register::Rsp || inAddress == Register::Rbp)
+    throw JitError("Indirect call through rsp or rbp not encodable!");
+  emit(0xFF);
+  emitModRM(0, 2, encoding(inAddress));
+}
+
+void X86Assembler::leave() { emit(0xC9); }
+
+void X86Assembler::ret() { emit(0xC3); }
+
+std::vector<uint8_t> X86Assembler::finish() {
+  for (const auto &fixup : fixups) {
+    size_t target = labels[fixup.label];
+    if (target == UnboundLabel)
+      throw JitError("Jump to unbound label!");
+    auto offset = static_cast<uint32_t>(static_cast<int64_t>(target) -
+                                        static_cast<int64_t>(fixup.position) -
+                                        4);
+    for (size_t i = 0; i < 4; ++i) {
+      code[fixup.position + i] = static_cast<uint8_t>(offset >> (8 * i));
+    }
+  }
+  fixups.clear();
+  return code;
+}
+
+void X86Assembler::emit(uint8_t inByte) { code.push_back(inByte); }
+
+void X86Assembler::emit32(uint32_t inValue) {
+  for (size_t i = 0; i < 4; ++i) {
+    emit(static_cast<uint8_t>(inValue >> (8 * i)));
+  }
+}
+
+void X86Assembler::emitModRM(uint8_t inMode, uint8_t inReg, uint8_t inRm) {
+  emit(static_cast<uint8_t>((inMode << 6) | (inReg << 3) | inRm));
+}
+
+void X86Assembler::emitLabel(Label inLabel) {
+  fixups.push_back(Fixup{code.size(), inLabel});
+  emit32(0);
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Encodes the handful of x86-64 instructions the JIT needs. Only the first
+ * eight general purpose registers are supported, so no REX.B/R prefixes are
+ * ever required. Jumps take labels which are resolved by finish. */
+class X86Assembler {
+public:
+  enum class Register : uint8_t { Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi };
+  enum class Xmm : uint8_t { Xmm0, Xmm1, Xmm2 };
+  /* Condition codes as encoded in Jcc and SETcc, each one and its negation
+   * differ in the lowest bit */
+  enum class Condition : uint8_t {
+    Below = 0x2,
+    AboveEqual = 0x3,
+    Equal = 0x4,
+    NotEqual = 0x5,
+    BelowEqual = 0x6,
+    Above = 0x7,
+    Parity = 0xA,
+    NoParity = 0xB,
+    Less = 0xC,
+    GreaterEqual = 0xD,
+    LessEqual = 0xE,
+    Greater = 0xF,
+  };
+  /* Opcode of the register form and /digit of the immediate form */
+  enum class Arithmetic : uint8_t {
+    Add = 0x01,
+    Or = 0x09,
+    And = 0x21,
+    Sub = 0x29,
+    Xor = 0x31,
+    Cmp = 0x39,
+  };
+  enum class ScalarFloat : uint8_t {
+    Add = 0x58,
+    Multiply = 0x59,
+    Subtract = 0x5C,
+    Divide = 0x5E,
+  };
+  typedef size_t Label;
+
+  Label newLabel();
+  void bind(Label inLabel);
+  void jump(Label inLabel);
+  void jumpIf(Condition inCondition, Label inLabel);
+
+  void push(Register inRegister);
+  void pushIndexed(Register inBase, Register inIndex);
+  void pop(Register inRegister);
+  void moveImmediate(Register inRegister, uint32_t inValue);
+  void moveImmediate64(Register inRegister, uint64_t inValue);
+  void move(Register inDestination, Register inSource);
+  void move64(Register inDestination, Register inSource);
+  void load64(Register inDestination, Register inBase, int32_t inOffset);
+  void store64(Register inBase, int32_t inOffset, Register inSource);
+  void arithmetic(Arithmetic inOperation, Register inDestination,
+                  Register inSource);
+  void arithmetic64(Arithmetic inOperation, Register inDestination,
+                    Register inSource);
+  void arithmeticImmediate(Arithmetic inOperation, Register inDestination,
+                           int32_t inValue);
+  void arithmeticImmediate64(Arithmetic inOperation, Register inDestination,
+                             int32_t inValue);
+  void test(Register inLhs, Register inRhs);
+  void test64Immediate(Register inRegister, int32_t inValue);
+  void multiply(Register inDestination, Register inSource);
+  void signedDivide(Register inDivisor);
+  void signExtendEax();
+  void negate(Register inRegister);
+  void increment64(Register inRegister);
+  void setIf(Condition inCondition, Register inRegister);
+  void zeroExtendByte(Register inDestination, Register inSource);
+  void arithmeticByte(Arithmetic inOperation, Register inDestination,
+                      Register inSource);
+  void moveToXmm(Xmm inDestination, Register inSource);
+  void moveFromXmm(Register inDestination, Xmm inSource);
+  void scalarFloat(ScalarFloat inOperation, Xmm inDestination, Xmm inSource);
+  void compareFloat(Xmm inLhs, Xmm inRhs);
+  void clearXmm(Xmm inRegister);
+  void call(Register inTarget);
+  void callIndirect(Register inAddress);
+  void leave();
+  void ret();
+
+  /* Resolves jumps and returns the machine code */
+  std::vector<uint8_t> finish();
+
+private:
+  struct Fixup {
+    size_t position;
+    Label label;
+  };
+
+  void emit(uint8_t inByte);
+  void emit32(uint32_t inValue);
+  void emitModRM(uint8_t inMode, uint8_t inReg, uint8_t inRm);
+  void emitLabel(Label inLabel);
+
+  std::vector<uint8_t> code;
+  std::vector<size_t> labels;
+  std::vector<Fixup> fixups;
+};
@@ -1,6 +1,7 @@
 #include "Lexer.h"
 #include "SourcePosition.h"
 #include <cstdio>
+#include <limits>
 #include <stdexcept>
 
 Lexer::Lexer(std::unique_ptr<Source> inSource) : source(std::move(inSource)) {}
@@ -1,25 +1,111 @@
 #include "lexer/Lexer.h"
 #include "lexer/SourceFile.h"
 #include "parser/Parser.h"
+#include "instructions/Program.h"
+#include "interpreter/Resolver.h"
+#include "interpreter/TypeInference.h"
 #include "interpreter/VisitorInterpreter.h"
 #include "interpreter/VisitorInterpreterImpl.h"
+#include "bytecode/BytecodeInterpreter.h"
+#include "bytecode/RegisterInterpreter.h"
+#include "bytecode/Dispatch.h"
+#include "closure/ClosureInterpreter.h"
+#include "aot/CEmitter.h"
+#include "optimizer/Optimizer.h"
+#include "ir/IrBuilder.h"
+#include "ir/IrOptimizer.h"
+#include "ir/IrVerifier.h"
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <string>
+
+static const char *const Usage =
+    "Usage: TKOM [--engine=tree|jit|closure|bytecode|register] [-O] [--stats] "
+    "[--max-depth=<calls>] [--dump-ir] [--emit-c] [--compile] "
+    "[--output=<binary>] <file>";
+
+/* Number of calls from 1 up, anything else is rejected */
+static bool parseMaxCallDepth(const std::string &inText, size_t &outDepth) {
+  if (inText.empty() || !std::isdigit(static_cast<unsigned char>(inText[0])))
+    return false;
+  char *end = nullptr;
+  errno = 0;
+  const unsigned long long depth = std::strtoull(inText.c_str(), &end, 10);
+  if (*end != '\0' || errno == ERANGE || depth == 0 ||
+      depth > std::numeric_limits<size_t>::max())
+    return false;
+  outDepth = static_cast<size_t>(depth);
+  return true;
+}
 
 int main(int argc, char **argv) {
   std::unique_ptr<Source> source;
   std::unique_ptr<Lexer> lexer;
   std::unique_ptr<Parser> parser;
-  std::unique_ptr<VisitorInterpreter> interpreter;
+  std::unique_ptr<Interpreter> interpreter;
+  std::string path;
+  std::string engine = "tree";
+  bool bPrintStats = false;
+  bool bEmitC = false;
+  bool bCompile = false;
+  bool bOptimize = false;
+  bool bDumpIr = false;
+  size_t maxCallDepth = Interpreter::DefaultMaxCallDepth;
+  std::string outputPath;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    if (argument.rfind("--engine=", 0) == 0)
+      engine = argument.substr(std::string("--engine=").size());
+    else if (argument == "--stats")
+      bPrintStats = true;
+    else if (argument == "--emit-c")
+      bEmitC = true;
+    else if (argument == "--compile")
+      bCompile = true;
+    else if (argument == "-O")
+      bOptimize = true;
+    else if (argument == "--dump-ir")
+      bDumpIr = true;
+    else if (argument.rfind("--max-depth=", 0) == 0) {
+      const std::string depth =
+          argument.substr(std::string("--max-depth=").size());
+      if (!parseMaxCallDepth(depth, maxCallDepth)) {
+        std::cout << "Invalid maximum call depth " << depth
+                  << "! It has to be a number of calls from 1 to "
+                  << std::numeric_limits<size_t>::max() << std::endl;
+        std::cout << Usage << std::endl;
+        return -1;
+      }
+    } else if (argument.rfind("--output=", 0) == 0)
+      outputPath = argument.substr(std::string("--output=").size());
+    else
+      path = argument;
+  }
+
+  if (engine != "tree" && engine != "jit" && engine != "closure" &&
+      engine != "bytecode" && engine != "register") {
+    std::cout << "Unknown engine " << engine
+              << "! Available engines: tree, jit, closure, bytecode, register"
+              << std::endl;
+    return -1;
+  }
 
-  if (argc > 1)
+  if (!path.empty())
     try {
-      source = std::make_unique<SourceFile>(argv[1]);
+      source = std::make_unique<SourceFile>(path);
     } catch (const std::runtime_error &error) {
       std::cout << "Source error: " << error.what() << std::endl;
       return -1;
     }
   else {
       std::cout << "Program requires path to file as an argument!" << std::endl;
+      std::cout << Usage << std::endl;
       return -1;
   }
 
@@ -38,9 +124,89 @@ int main(int argc, char **argv) {
     return -1;
   }
 
+  Optimizer optimizer;
+  if (bOptimize)
+    optimizer.optimize(*parser->parseProgram());
+
+  if (bDumpIr) {
+    try {
+      /* The IR the register engine runs */
+      Program *program = parser->parseProgram();
+      Resolver().resolve(*program);
+      TypeInference().infer(*program);
+      auto ir = IrBuilder().build(*program);
+      if (bOptimize)
+        IrOptimizer().optimize(*ir);
+      else
+        IrVerifier().verify(*ir);
+      std::cout << ir->toString();
+    } catch (const std::runtime_error &error) {
+      std::cout << "Compiler error: " << error.what() << std::endl;
+      return -1;
+    }
+    return 0;
+  }
+
+  if (bEmitC || bCompile) {
+    std::string code;
+    try {
+      CEmitter emitter(maxCallDepth);
+      code = emitter.emit(*parser->parseProgram());
+    } catch (const std::runtime_error &error) {
+      std::cout << "Compiler error: " << error.what() << std::endl;
+      return -1;
+    }
+    if (bEmitC) {
+      std::cout << code;
+      return 0;
+    }
+
+    /* The binary is named after the source unless an output is given */
+    if (outputPath.empty()) {
+      size_t extension = path.rfind('.');
+      size_t directory = path.find_last_of("/\\");
+      if (extension == std::string::npos ||
+          (directory != std::string::npos && extension < directory))
+        outputPath = path + ".out";
+      else
+        outputPath = path.substr(0, extension);
+    }
+    const std::string sourcePath = outputPath + ".cpp";
+    std::ofstream(sourcePath) << code;
+    const char *compiler = std::getenv("CXX");
+#ifdef _WIN32
+    const char *threads = "";
+#else
+    /* The runtime grows the native stack of deep calls on new threads */
+    const char *threads = " -pthread";
+#endif
+    const std::string command = std::string(compiler ? compiler : "c++") +
+                                " -std=c++17 -O2" + threads + " -o \"" +
+                                outputPath + "\" \"" + sourcePath + "\"";
+    if (std::system(command.c_str()) != 0) {
+      std::cout << "Compiler error: " << command << " failed!" << std::endl;
+      return -1;
+    }
+    return 0;
+  }
+
    try {
-    interpreter = std::make_unique<VisitorInterpreterImpl>(std::move(parser));
+    if (engine == "closure")
+      interpreter = std::make_unique<ClosureInterpreter>(std::move(parser));
+    else if (engine == "bytecode")
+      interpreter = std::make_unique<BytecodeInterpreter>(std::move(parser));
+    else if (engine == "register")
+      interpreter =
+          std::make_unique<RegisterInterpreter>(std::move(parser), bOptimize);
+    else if (engine == "jit")
+      interpreter = std::make_unique<VisitorInterpreterImpl>(
+          std::move(parser), Jit::DefaultThreshold);
+    else
+      interpreter = std::make_unique<VisitorInterpreterImpl>(std::move(parser));
+    interpreter->setMaxCallDepth(maxCallDepth);
+    auto start = std::chrono::steady_clock::now();
     auto returnValue = interpreter->execute();
+    auto elapsed = std::chrono::steady_clock::now() - start;
     if (returnValue.has_value()) {
       std::visit(overload{
                      [](const auto &in) { std::cout << in; },
@@ -48,6 +214,46 @@ int main(int argc, char **argv) {
                  },
                  returnValue->first);
     }
+    if (bPrintStats) {
+      std::cerr << std::endl
+                << "Engine: " << engine << std::endl
+                << "Wall clock: "
+                << std::chrono::duration<double, std::milli>(elapsed).count()
+                << " ms" << std::endl;
+      if (bOptimize)
+        std::cerr << "Inlined calls: " << optimizer.getInlinedCount()
+                  << std::endl
+                  << "Folded constants: " << optimizer.getFoldedCount()
+                  << std::endl
+                  << "Eliminated nodes: " << optimizer.getEliminatedCount()
+                  << std::endl
+                  << "Hoisted expressions: " << optimizer.getHoistedCount()
+                  << std::endl
+                  << "Reused expressions: " << optimizer.getReusedCount()
+                  << std::endl;
+      if (size_t count = interpreter->getExecutedInstructionCount())
+        std::cerr << "Dispatch: " << DispatchStrategy << std::endl
+                  << "Executed instructions: " << count << std::endl
+                  << "Time per instruction: "
+                  << std::chrono::duration<double, std::nano>(elapsed).count() /
+                         count
+                  << " ns" << std::endl;
+      if (auto *bytecodeInterpreter =
+              dynamic_cast<BytecodeInterpreter *>(interpreter.get()))
+        std::cerr << "Quickened instructions: "
+                  << bytecodeInterpreter->getQuickenedInstructionCount()
+                  << " (deoptimized "
+                  << bytecodeInterpreter->getDeoptimizedInstructionCount()
+                  << ")" << std::endl;
+      if (auto *treeInterpreter =
+              dynamic_cast<VisitorInterpreterImpl *>(interpreter.get())) {
+        std::cerr << "Memoized calls: "
+                  << treeInterpreter->getMemoizedCallCount() << std::endl;
+        if (const Jit *jit = treeInterpreter->getJit())
+          std::cerr << "Compiled functions: " << jit->getCompiledCount()
+                    << std::endl;
+      }
+    }
   } catch (const std::runtime_error &error) {
     std::cout << "Interpreter error: " << error.what() << std::endl;
     return -1;
@@ -55,4 +261,4 @@ int main(int argc, char **argv) {
 
 
   return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
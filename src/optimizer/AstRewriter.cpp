@@ -0,0 +1,302 @@
+#include "AstRewriter.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Value.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include "../interpreter/InterpreterError.h"
+#include "../interpreter/Resolver.h"
+#include "../interpreter/TypeInference.h"
+
+void AstRewriter::rewrite(Program &inProgram) {
+  program = &inProgram;
+  /* Bodies are swapped once all are rewritten, a pass may read other
+   * functions while rewriting one */
+  std::vector<std::unique_ptr<Block>> bodies;
+  for (const auto &function : inProgram.getFunctions()) {
+    if (function->getBlock())
+      function->accept(*this);
+    bodies.push_back(std::move(block));
+  }
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    if (bodies[i])
+      inProgram.getFunctions()[i]->setBody(std::move(bodies[i]));
+  }
+}
+
+Completion AstRewriter::visit(const Program &inProgram) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const BinaryExpression &inBinaryExpression) {
+  auto lhs = rewriteExpression(*inBinaryExpression.getLhs());
+  auto rhs = rewriteExpression(*inBinaryExpression.getRhs());
+  expression = std::make_unique<BinaryExpression>(
+      std::move(lhs), inBinaryExpression.getOperator(), std::move(rhs));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const Block &inBlock) {
+  auto rewritten = std::make_unique<Block>();
+  for (const auto &instruction : inBlock.getInstructions()) {
+    rewritten->addInstruction(rewriteInstruction(*instruction));
+  }
+  block = std::move(rewritten);
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const Case &inCase) {
+  auto caseExpression = rewriteExpression(*inCase.getExpression());
+  instruction = std::make_unique<Case>(std::move(caseExpression),
+                                       rewriteBlock(*inCase.getBlock()));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const Function &inFunction) {
+  currentFunction = &inFunction;
+  hiddenVariables.clear();
+  block = rewriteBlock(*inFunction.getBlock());
+  for (size_t i = 0; i < hiddenVariables.size(); ++i) {
+    block->insertInstruction(
+        i, std::make_unique<InstructionDeclarationVariable>(hiddenVariables[i],
+                                                            true));
+  }
+  return Completion::Normal;
+}
+
+Completion
+AstRewriter::visit(const FunctionCallExpression &inFunctionCallExpression) {
+  expression = std::make_unique<FunctionCallExpression>(
+      rewriteCall(*static_cast<const InstructionFunctionCall *>(
+          inFunctionCallExpression.getFunctionCall())));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const IfElse &inIfElse) {
+  auto condition = rewriteExpression(*inIfElse.getExpression());
+  auto blockIf = rewriteBlock(*inIfElse.getBlockIf());
+  std::unique_ptr<Block> blockElse;
+  if (inIfElse.getBlockElse())
+    blockElse = rewriteBlock(*inIfElse.getBlockElse());
+  instruction = std::make_unique<IfElse>(
+      std::move(condition), std::move(blockIf), std::move(blockElse));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const InstructionAssigment &inAssigment) {
+  auto value = rewriteExpression(*inAssigment.getExpression());
+  instruction = std::make_unique<InstructionAssigment>(
+      copyVariable(*inAssigment.getVariable()), std::move(value));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  std::unique_ptr<Expression> value;
+  if (inDeclarationVariable.getExpression())
+    value = rewriteExpression(*inDeclarationVariable.getExpression());
+  instruction = std::make_unique<InstructionDeclarationVariable>(
+      inDeclarationVariable.getIdentifier(),
+      inDeclarationVariable.isMutable(), std::move(value));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const InstructionFunctionCall &inFunctionCall) {
+  instruction = rewriteCall(inFunctionCall);
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const IntFunction &inIntFunction) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const StringFunction &inStringFunction) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const FloatFunction &inFloatFunction) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const BoolFunction &inBoolFunction) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const PrintFunction &inPrintFunction) {
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const InstructionReturn &inReturn) {
+  std::unique_ptr<Expression> value;
+  if (inReturn.getExpression())
+    value = rewriteExpression(*inReturn.getExpression());
+  instruction = std::make_unique<InstructionReturn>(std::move(value));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const Match &inMatch) {
+  auto match =
+      std::make_unique<Match>(rewriteExpression(*inMatch.getExpression()));
+  for (const auto &caseInstruction : inMatch.getCases()) {
+    caseInstruction->accept(*this);
+    match->addCase(
+        std::unique_ptr<Case>(static_cast<Case *>(instruction.release())));
+  }
+  instruction = std::move(match);
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const UnaryExpression &inUnaryExpression) {
+  expression = std::make_unique<UnaryExpression>(
+      inUnaryExpression.getOperator(),
+      rewriteExpression(*inUnaryExpression.getExpression()));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const VariableExpression &inVariableExpression) {
+  expression = std::make_unique<VariableExpression>(
+      copyVariable(*inVariableExpression.getVariable()));
+  return Completion::Normal;
+}
+
+Completion AstRewriter::visit(const While &inWhile) {
+  auto condition = rewriteExpression(*inWhile.getExpression());
+  instruction = std::make_unique<While>(std::move(condition),
+                                        rewriteBlock(*inWhile.getBody()));
+  return Completion::Normal;
+}
+
+std::unique_ptr<Expression>
+AstRewriter::rewriteExpression(const Expression &inExpression) {
+  inExpression.accept(*this);
+  return std::move(expression);
+}
+
+std::unique_ptr<Instruction>
+AstRewriter::rewriteInstruction(const Instruction &inInstruction) {
+  inInstruction.accept(*this);
+  return std::move(instruction);
+}
+
+std::unique_ptr<Block> AstRewriter::rewriteBlock(const Block &inBlock) {
+  inBlock.accept(*this);
+  return std::move(block);
+}
+
+std::unique_ptr<InstructionFunctionCall>
+AstRewriter::rewriteCall(const InstructionFunctionCall &inFunctionCall) {
+  auto call =
+      std::make_unique<InstructionFunctionCall>(inFunctionCall.getFunctionName());
+  for (const auto &argument : inFunctionCall.getExpressions()) {
+    call->addArgument(rewriteExpression(*argument));
+  }
+  return call;
+}
+
+std::unique_ptr<Variable> AstRewriter::copyVariable(const Variable &inVariable) {
+  if (inVariable.getName())
+    return std::make_unique<Variable>(*inVariable.getName());
+  const Value *value = inVariable.getValue();
+  return std::make_unique<Variable>(
+      std::make_unique<Value>(value->getType(), value->getValue()));
+}
+
+std::unique_ptr<Expression>
+AstRewriter::makeConstant(const RuntimeValue &inValue) {
+  const ValueType valueType = inValue.toValueType();
+  return std::make_unique<VariableExpression>(std::make_unique<Variable>(
+      std::make_unique<Value>(valueType.second, valueType.first)));
+}
+
+const RuntimeValue *AstRewriter::getConstant(const Expression &inExpression) {
+  auto *variableExpression =
+      dynamic_cast<const VariableExpression *>(&inExpression);
+  if (!variableExpression || !variableExpression->getVariable()->getValue())
+    return nullptr;
+  return &variableExpression->getVariable()->getValue()->getRuntimeValue();
+}
+
+std::string AstRewriter::addHiddenVariable(const std::string &inPrefix) {
+  hiddenVariables.push_back("@" + inPrefix +
+                            std::to_string(hiddenVariables.size()));
+  return hiddenVariables.back();
+}
+
+bool AstRewriter::annotateTypes(const Program &inProgram) {
+  try {
+    Resolver().resolve(inProgram);
+    TypeInference().infer(inProgram);
+  } catch (const InterpreterError &) {
+    return false;
+  }
+  return true;
+}
+
+bool AstRewriter::cannotFail(const Expression &inExpression) {
+  typedef Expression::Operator Op;
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression)) {
+    if (binaryExpression->getOperandType() == RuntimeValue::Type::Void)
+      return false;
+    const Op op = binaryExpression->getOperator();
+    if (op == Op::Division || op == Op::Modulo) {
+      const RuntimeValue *divisor = getConstant(*binaryExpression->getRhs());
+      if (!divisor ||
+          !(divisor->getType() == RuntimeValue::Type::Int
+                ? divisor->getInt() != 0 && divisor->getInt() != -1
+                : divisor->getType() == RuntimeValue::Type::Float &&
+                      divisor->getFloat() != 0.0f))
+        return false;
+    }
+    return cannotFail(*binaryExpression->getLhs()) &&
+           cannotFail(*binaryExpression->getRhs());
+  }
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return unaryExpression->getOperandType() != RuntimeValue::Type::Void &&
+           cannotFail(*unaryExpression->getExpression());
+  if (dynamic_cast<const VariableExpression *>(&inExpression))
+    return true;
+
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      static_cast<const FunctionCallExpression &>(inExpression)
+          .getFunctionCall());
+  return call->getFunctionName() == "string" &&
+         call->getExpressions().size() == 1 &&
+         cannotFail(*call->getExpressions()[0]);
+}
+
+void AstRewriter::collectAssigned(const Block &inBlock,
+                                  std::unordered_set<std::string> &outNames) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    if (auto *assignment =
+            dynamic_cast<const InstructionAssigment *>(instruction.get()))
+      outNames.insert(assignment->getVariable()->toString());
+    else if (auto *declaration =
+                 dynamic_cast<const InstructionDeclarationVariable *>(
+                     instruction.get()))
+      outNames.insert(declaration->getIdentifier());
+    else if (auto *ifElse = dynamic_cast<const IfElse *>(instruction.get())) {
+      collectAssigned(*ifElse->getBlockIf(), outNames);
+      if (ifElse->getBlockElse())
+        collectAssigned(*ifElse->getBlockElse(), outNames);
+    } else if (auto *loop = dynamic_cast<const While *>(instruction.get()))
+      collectAssigned(*loop->getBody(), outNames);
+    else if (auto *match = dynamic_cast<const Match *>(instruction.get()))
+      for (const auto &caseInstruction : match->getCases()) {
+        collectAssigned(*caseInstruction->getBlock(), outNames);
+      }
+  }
+}
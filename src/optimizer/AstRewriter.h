@@ -0,0 +1,90 @@
+#pragma once
+#include "../instructions/Block.h"
+#include "../instructions/Expression.h"
+#include "../instructions/Instruction.h"
+#include "../interpreter/RuntimeValue.h"
+#include "../interpreter/VisitorInterpreter.h"
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/* Base of the optimizer passes. Rebuilds the body of every function node by
+ * node, a pass overrides the visits of the nodes it changes and everything
+ * else is copied as it is. Slots and type annotations are not copied, the
+ * engines resolve and infer the rewritten program again. */
+class AstRewriter : public VisitorInterpreter {
+public:
+  AstRewriter() = default;
+  /* Replaces the body of every function of inProgram by its rewritten copy */
+  void rewrite(class Program &inProgram);
+
+  virtual Completion visit(const class Program &inProgram) override;
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Case &inCase) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class IfElse &inIfElse) override;
+  virtual Completion
+  visit(const class InstructionAssigment &inAssigment) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class IntFunction &inIntFunction) override;
+  virtual Completion
+  visit(const class StringFunction &inStringFunction) override;
+  virtual Completion visit(const class FloatFunction &inFloatFunction) override;
+  virtual Completion visit(const class BoolFunction &inBoolFunction) override;
+  virtual Completion visit(const class PrintFunction &inPrintFunction) override;
+  virtual Completion visit(const class InstructionReturn &inReturn) override;
+  virtual Completion visit(const class Match &inMatch) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+protected:
+  std::unique_ptr<class Expression>
+  rewriteExpression(const class Expression &inExpression);
+  std::unique_ptr<class Instruction>
+  rewriteInstruction(const class Instruction &inInstruction);
+  std::unique_ptr<class Block> rewriteBlock(const class Block &inBlock);
+  std::unique_ptr<class InstructionFunctionCall>
+  rewriteCall(const class InstructionFunctionCall &inFunctionCall);
+  static std::unique_ptr<class Variable>
+  copyVariable(const class Variable &inVariable);
+  /* Literal expression holding inValue */
+  static std::unique_ptr<class Expression>
+  makeConstant(const RuntimeValue &inValue);
+  /* Value of a literal expression, nullptr for anything else */
+  static const RuntimeValue *getConstant(const class Expression &inExpression);
+  /* Declares a mutable variable no source name can clash with at the start
+   * of the function being rewritten, so it exists before any loop */
+  std::string addHiddenVariable(const std::string &inPrefix);
+  /* Resolves and infers inProgram so the operand types of its expressions
+   * are known, false when it has a type error for the engine to report */
+  static bool annotateTypes(const class Program &inProgram);
+  /* True for an expression of an annotated program that neither fails nor
+   * has side effects, given the variables it reads are declared: operand
+   * types are known, division is only by literals other than 0 and, for
+   * ints, -1, and the only call is string(), which converts every value */
+  static bool cannotFail(const class Expression &inExpression);
+  /* Variables assigned or declared anywhere in inBlock */
+  static void collectAssigned(const class Block &inBlock,
+                              std::unordered_set<std::string> &outNames);
+
+  const class Program *program = nullptr;
+  const class Function *currentFunction = nullptr;
+  /* Node built by the last visit */
+  std::unique_ptr<class Expression> expression;
+  std::unique_ptr<class Instruction> instruction;
+  std::unique_ptr<class Block> block;
+
+private:
+  std::vector<std::string> hiddenVariables;
+};
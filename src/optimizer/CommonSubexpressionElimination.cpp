@@ -0,0 +1,496 @@
+#include "CommonSubexpressionElimination.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+#include <cstdio>
+
+static void countDeclarations(const Block &inBlock,
+                              std::unordered_map<std::string, size_t> &outCounts) {
+  for (const auto &instruction : inBlock.getInstructions()) {
+    if (auto *declaration = dynamic_cast<const InstructionDeclarationVariable *>(
+            instruction.get()))
+      ++outCounts[declaration->getIdentifier()];
+    else if (auto *ifElse = dynamic_cast<const IfElse *>(instruction.get())) {
+      countDeclarations(*ifElse->getBlockIf(), outCounts);
+      if (ifElse->getBlockElse())
+        countDeclarations(*ifElse->getBlockElse(), outCounts);
+    } else if (auto *loop = dynamic_cast<const While *>(instruction.get()))
+      countDeclarations(*loop->getBody(), outCounts);
+    else if (auto *match = dynamic_cast<const Match *>(instruction.get()))
+      for (const auto &caseInstruction : match->getCases()) {
+        countDeclarations(*caseInstruction->getBlock(), outCounts);
+      }
+  }
+}
+
+void CommonSubexpressionElimination::eliminate(Program &inProgram) {
+  if (!annotateTypes(inProgram))
+    return;
+  for (const auto &function : inProgram.getFunctions()) {
+    ++definitions[function->getIdentifier()];
+  }
+  rewrite(inProgram);
+}
+
+size_t CommonSubexpressionElimination::getReusedCount() const {
+  return reusedCount;
+}
+
+Completion CommonSubexpressionElimination::visit(
+    const BinaryExpression &inBinaryExpression) {
+  auto value = computed.find(getKey(inBinaryExpression));
+  if (value == computed.end())
+    return AstRewriter::visit(inBinaryExpression);
+  expression = std::make_unique<VariableExpression>(
+      std::make_unique<Variable>(value->second.variable));
+  return Completion::Normal;
+}
+
+Completion CommonSubexpressionElimination::visit(const Block &inBlock) {
+  auto enclosingComputed = computed;
+  auto enclosingDeclared = declared;
+  auto rewritten = std::make_unique<Block>();
+  const auto &instructions = inBlock.getInstructions();
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    for (const Expression *evaluated : getEvaluated(*instructions[i])) {
+      hoistRepeated(*evaluated, instructions, i, *rewritten);
+    }
+    rewritten->addInstruction(rewriteInstruction(*instructions[i]));
+
+    /* Values stay valid across statements that do not assign what they
+     * read */
+    std::unordered_set<std::string> assigned;
+    if (auto *assignment = dynamic_cast<const InstructionAssigment *>(
+            instructions[i].get()))
+      assigned.insert(assignment->getVariable()->toString());
+    else if (auto *declaration =
+                 dynamic_cast<const InstructionDeclarationVariable *>(
+                     instructions[i].get())) {
+      assigned.insert(declaration->getIdentifier());
+      declared[declaration->getIdentifier()] = declaration->isMutable();
+    } else {
+      if (auto *ifElse = dynamic_cast<const IfElse *>(instructions[i].get())) {
+        collectAssigned(*ifElse->getBlockIf(), assigned);
+        if (ifElse->getBlockElse())
+          collectAssigned(*ifElse->getBlockElse(), assigned);
+      } else if (auto *loop =
+                     dynamic_cast<const While *>(instructions[i].get()))
+        collectAssigned(*loop->getBody(), assigned);
+      else if (auto *match = dynamic_cast<const Match *>(instructions[i].get()))
+        for (const auto &caseInstruction : match->getCases()) {
+          collectAssigned(*caseInstruction->getBlock(), assigned);
+        }
+    }
+    kill(assigned);
+  }
+
+  /* Values computed in this block may not exist once it is left */
+  std::unordered_set<std::string> assigned;
+  collectAssigned(inBlock, assigned);
+  computed = std::move(enclosingComputed);
+  kill(assigned);
+  declared = std::move(enclosingDeclared);
+  block = std::move(rewritten);
+  return Completion::Normal;
+}
+
+Completion CommonSubexpressionElimination::visit(const Function &inFunction) {
+  computed.clear();
+  declared.clear();
+  declarations.clear();
+  loopDepth = 0;
+  for (const auto &argument : inFunction.getArguments()) {
+    declared[argument->getName()] = argument->isMutable();
+    ++declarations[argument->getName()];
+  }
+  countDeclarations(*inFunction.getBlock(), declarations);
+  return AstRewriter::visit(inFunction);
+}
+
+Completion CommonSubexpressionElimination::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  auto value = computed.find(getKey(inFunctionCallExpression));
+  if (value == computed.end())
+    return AstRewriter::visit(inFunctionCallExpression);
+  expression = std::make_unique<VariableExpression>(
+      std::make_unique<Variable>(value->second.variable));
+  return Completion::Normal;
+}
+
+Completion
+CommonSubexpressionElimination::visit(const UnaryExpression &inUnaryExpression) {
+  auto value = computed.find(getKey(inUnaryExpression));
+  if (value == computed.end())
+    return AstRewriter::visit(inUnaryExpression);
+  expression = std::make_unique<VariableExpression>(
+      std::make_unique<Variable>(value->second.variable));
+  return Completion::Normal;
+}
+
+Completion CommonSubexpressionElimination::visit(const While &inWhile) {
+  /* The condition and body run again after the body assigns */
+  std::unordered_set<std::string> assigned;
+  collectAssigned(*inWhile.getBody(), assigned);
+  kill(assigned);
+  ++loopDepth;
+  AstRewriter::visit(inWhile);
+  --loopDepth;
+  return Completion::Normal;
+}
+
+void CommonSubexpressionElimination::hoistRepeated(
+    const Expression &inExpression,
+    const std::vector<std::unique_ptr<Instruction>> &inInstructions,
+    size_t inIndex, Block &outBlock) {
+  if (isCandidate(inExpression)) {
+    const std::string key = getKey(inExpression);
+    if (computed.count(key))
+      return;
+
+    std::unordered_set<std::string> reads;
+    collectReads(inExpression, reads);
+    const size_t occurrences =
+        countOccurrences(inInstructions, inIndex, key, reads);
+    if (occurrences > 1 &&
+        (isSafe(inExpression) ||
+         hasCleanPrefix(*inInstructions[inIndex], inExpression))) {
+      const std::string name = addHiddenVariable("common");
+      outBlock.addInstruction(std::make_unique<InstructionAssigment>(
+          std::make_unique<Variable>(name), rewriteExpression(inExpression)));
+      computed[key] = Computed{name, std::move(reads)};
+      reusedCount += occurrences - 1;
+      return;
+    }
+  }
+
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression)) {
+    hoistRepeated(*binaryExpression->getLhs(), inInstructions, inIndex,
+                  outBlock);
+    hoistRepeated(*binaryExpression->getRhs(), inInstructions, inIndex,
+                  outBlock);
+  } else if (auto *unaryExpression =
+                 dynamic_cast<const UnaryExpression *>(&inExpression))
+    hoistRepeated(*unaryExpression->getExpression(), inInstructions, inIndex,
+                  outBlock);
+  else if (auto *callExpression =
+               dynamic_cast<const FunctionCallExpression *>(&inExpression))
+    for (const auto &argument :
+         static_cast<const InstructionFunctionCall *>(
+             callExpression->getFunctionCall())
+             ->getExpressions()) {
+      hoistRepeated(*argument, inInstructions, inIndex, outBlock);
+    }
+}
+
+size_t CommonSubexpressionElimination::countOccurrences(
+    const std::vector<std::unique_ptr<Instruction>> &inInstructions,
+    size_t inIndex, const std::string &inKey,
+    const std::unordered_set<std::string> &inReads) const {
+  size_t occurrences = 0;
+  for (size_t i = inIndex; i < inInstructions.size(); ++i) {
+    for (const Expression *evaluated : getEvaluated(*inInstructions[i])) {
+      occurrences += countOccurrences(*evaluated, inKey);
+    }
+
+    /* A statement evaluates its expressions before it assigns */
+    std::unordered_set<std::string> assigned;
+    if (auto *assignment = dynamic_cast<const InstructionAssigment *>(
+            inInstructions[i].get()))
+      assigned.insert(assignment->getVariable()->toString());
+    else if (auto *declaration =
+                 dynamic_cast<const InstructionDeclarationVariable *>(
+                     inInstructions[i].get()))
+      assigned.insert(declaration->getIdentifier());
+    else if (!dynamic_cast<const InstructionReturn *>(inInstructions[i].get()) &&
+             !dynamic_cast<const InstructionFunctionCall *>(
+                 inInstructions[i].get()))
+      break;
+    for (const auto &name : assigned) {
+      if (inReads.count(name))
+        return occurrences;
+    }
+    if (dynamic_cast<const InstructionReturn *>(inInstructions[i].get()))
+      break;
+  }
+  return occurrences;
+}
+
+size_t
+CommonSubexpressionElimination::countOccurrences(const Expression &inExpression,
+                                                 const std::string &inKey) {
+  if (getKey(inExpression) == inKey)
+    return 1;
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression))
+    return countOccurrences(*binaryExpression->getLhs(), inKey) +
+           countOccurrences(*binaryExpression->getRhs(), inKey);
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return countOccurrences(*unaryExpression->getExpression(), inKey);
+  size_t occurrences = 0;
+  if (auto *callExpression =
+          dynamic_cast<const FunctionCallExpression *>(&inExpression))
+    for (const auto &argument :
+         static_cast<const InstructionFunctionCall *>(
+             callExpression->getFunctionCall())
+             ->getExpressions()) {
+      occurrences += countOccurrences(*argument, inKey);
+    }
+  return occurrences;
+}
+
+std::vector<const Expression *>
+CommonSubexpressionElimination::getEvaluated(const Instruction &inInstruction) {
+  std::vector<const Expression *> evaluated;
+  if (auto *assignment =
+          dynamic_cast<const InstructionAssigment *>(&inInstruction))
+    evaluated.push_back(assignment->getExpression());
+  else if (auto *declaration =
+               dynamic_cast<const InstructionDeclarationVariable *>(
+                   &inInstruction)) {
+    if (declaration->getExpression())
+      evaluated.push_back(declaration->getExpression());
+  } else if (auto *returnInstruction =
+                 dynamic_cast<const InstructionReturn *>(&inInstruction)) {
+    if (returnInstruction->getExpression())
+      evaluated.push_back(returnInstruction->getExpression());
+  } else if (auto *call =
+                 dynamic_cast<const InstructionFunctionCall *>(&inInstruction))
+    for (const auto &argument : call->getExpressions()) {
+      evaluated.push_back(argument.get());
+    }
+  else if (auto *ifElse = dynamic_cast<const IfElse *>(&inInstruction))
+    evaluated.push_back(ifElse->getExpression());
+  else if (auto *match = dynamic_cast<const Match *>(&inInstruction))
+    evaluated.push_back(match->getExpression());
+  return evaluated;
+}
+
+bool CommonSubexpressionElimination::hasCleanPrefix(
+    const Instruction &inInstruction, const Expression &inTarget) const {
+  /* Statements check their target or callee before evaluating anything */
+  if (auto *assignment =
+          dynamic_cast<const InstructionAssigment *>(&inInstruction)) {
+    auto variable = declared.find(assignment->getVariable()->toString());
+    if (variable == declared.end() || !variable->second)
+      return false;
+  } else if (auto *declaration =
+                 dynamic_cast<const InstructionDeclarationVariable *>(
+                     &inInstruction)) {
+    if (loopDepth > 0 || declarations.at(declaration->getIdentifier()) != 1)
+      return false;
+  } else if (auto *call =
+                 dynamic_cast<const InstructionFunctionCall *>(&inInstruction)) {
+    if (!isChecked(*call))
+      return false;
+  }
+
+  for (const Expression *evaluated : getEvaluated(inInstruction)) {
+    const int clean = findClean(*evaluated, inTarget);
+    if (clean != 0)
+      return clean > 0;
+    if (!isSafe(*evaluated))
+      return false;
+  }
+  return false;
+}
+
+int CommonSubexpressionElimination::findClean(const Expression &inExpression,
+                                              const Expression &inTarget) const {
+  if (&inExpression == &inTarget)
+    return 1;
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression)) {
+    const int lhs = findClean(*binaryExpression->getLhs(), inTarget);
+    if (lhs != 0)
+      return lhs;
+    const int rhs = findClean(*binaryExpression->getRhs(), inTarget);
+    if (rhs <= 0)
+      return rhs;
+    /* The rhs of || and && may never run */
+    return !binaryExpression->isLogical() &&
+                   isSafe(*binaryExpression->getLhs())
+               ? 1
+               : -1;
+  }
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return findClean(*unaryExpression->getExpression(), inTarget);
+  auto *callExpression =
+      dynamic_cast<const FunctionCallExpression *>(&inExpression);
+  if (!callExpression)
+    return 0;
+
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      callExpression->getFunctionCall());
+  bool bIsPrefixSafe = isChecked(*call);
+  for (const auto &argument : call->getExpressions()) {
+    const int clean = findClean(*argument, inTarget);
+    if (clean != 0)
+      return clean > 0 && bIsPrefixSafe ? 1 : -1;
+    bIsPrefixSafe &= isSafe(*argument);
+  }
+  return 0;
+}
+
+bool CommonSubexpressionElimination::isSafe(
+    const Expression &inExpression) const {
+  if (!cannotFail(inExpression))
+    return false;
+  std::unordered_set<std::string> reads;
+  collectReads(inExpression, reads);
+  for (const auto &name : reads) {
+    if (!declared.count(name))
+      return false;
+  }
+  return true;
+}
+
+bool CommonSubexpressionElimination::isCandidate(
+    const Expression &inExpression) const {
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression))
+    return (isCandidate(*binaryExpression->getLhs()) ||
+            dynamic_cast<const VariableExpression *>(
+                binaryExpression->getLhs())) &&
+           (isCandidate(*binaryExpression->getRhs()) ||
+            dynamic_cast<const VariableExpression *>(
+                binaryExpression->getRhs())) &&
+           getKey(inExpression).find(" _ ") == std::string::npos;
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return (isCandidate(*unaryExpression->getExpression()) ||
+            dynamic_cast<const VariableExpression *>(
+                unaryExpression->getExpression())) &&
+           getKey(inExpression).find(" _ ") == std::string::npos;
+  auto *callExpression =
+      dynamic_cast<const FunctionCallExpression *>(&inExpression);
+  if (!callExpression)
+    return false;
+
+  /* Conversions are the only builtins without side effects */
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      callExpression->getFunctionCall());
+  const std::string &name = call->getFunctionName();
+  if ((name != "int" && name != "float" && name != "string" &&
+       name != "bool") ||
+      definitions.count(name) || call->getExpressions().size() != 1)
+    return false;
+  const Expression &argument = *call->getExpressions()[0];
+  return (isCandidate(argument) ||
+          dynamic_cast<const VariableExpression *>(&argument)) &&
+         getKey(inExpression).find(" _ ") == std::string::npos;
+}
+
+bool CommonSubexpressionElimination::isChecked(
+    const InstructionFunctionCall &inCall) const {
+  /* The callee must be unambiguous for its arity to be known */
+  const std::string &name = inCall.getFunctionName();
+  auto userDefinitions = definitions.find(name);
+  const Function *function = builtins.findFunction(name);
+  if (userDefinitions != definitions.end()) {
+    if (function || userDefinitions->second != 1)
+      return false;
+    for (const auto &candidate : program->getFunctions()) {
+      if (candidate->getIdentifier() == name)
+        function = candidate.get();
+    }
+  }
+  return function &&
+         function->getArguments().size() == inCall.getExpressions().size();
+}
+
+void CommonSubexpressionElimination::kill(
+    const std::unordered_set<std::string> &inNames) {
+  for (auto it = computed.begin(); it != computed.end();) {
+    bool bIsKilled = false;
+    for (const auto &name : inNames) {
+      bIsKilled |= it->second.reads.count(name) > 0;
+    }
+    it = bIsKilled ? computed.erase(it) : std::next(it);
+  }
+}
+
+std::string
+CommonSubexpressionElimination::getKey(const Expression &inExpression) {
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression))
+    return "(" + getKey(*binaryExpression->getLhs()) + " " +
+           std::to_string(static_cast<int>(binaryExpression->getOperator())) +
+           " " + getKey(*binaryExpression->getRhs()) + ")";
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return "(" +
+           std::to_string(static_cast<int>(unaryExpression->getOperator())) +
+           " " + getKey(*unaryExpression->getExpression()) + ")";
+  if (auto *callExpression =
+          dynamic_cast<const FunctionCallExpression *>(&inExpression)) {
+    auto *call = static_cast<const InstructionFunctionCall *>(
+        callExpression->getFunctionCall());
+    std::string key = "(" + call->getFunctionName();
+    for (const auto &argument : call->getExpressions()) {
+      key += " " + getKey(*argument);
+    }
+    return key + ")";
+  }
+
+  /* Literals are tagged with their type, names are padded so '_' can be
+   * spotted */
+  const Variable *variable =
+      static_cast<const VariableExpression &>(inExpression).getVariable();
+  if (variable->getName())
+    return " " + *variable->getName() + " ";
+  const RuntimeValue &value = variable->getValue()->getRuntimeValue();
+  switch (value.getType()) {
+  case RuntimeValue::Type::Int:
+    return "i" + std::to_string(value.getInt());
+  case RuntimeValue::Type::Float: {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%a", value.getFloat());
+    return std::string("f") + digits;
+  }
+  case RuntimeValue::Type::Bool:
+    return value.getBool() ? "true" : "false";
+  default:
+    return "s" + std::to_string(value.getString().size()) + ":" +
+           value.getString();
+  }
+}
+
+void CommonSubexpressionElimination::collectReads(
+    const Expression &inExpression, std::unordered_set<std::string> &outNames) {
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression)) {
+    collectReads(*binaryExpression->getLhs(), outNames);
+    collectReads(*binaryExpression->getRhs(), outNames);
+  } else if (auto *unaryExpression =
+                 dynamic_cast<const UnaryExpression *>(&inExpression))
+    collectReads(*unaryExpression->getExpression(), outNames);
+  else if (auto *callExpression =
+               dynamic_cast<const FunctionCallExpression *>(&inExpression))
+    for (const auto &argument :
+         static_cast<const InstructionFunctionCall *>(
+             callExpression->getFunctionCall())
+             ->getExpressions()) {
+      collectReads(*argument, outNames);
+    }
+  else if (auto &name = static_cast<const VariableExpression &>(inExpression)
+                            .getVariable()
+                            ->getName())
+    outNames.insert(*name);
+}
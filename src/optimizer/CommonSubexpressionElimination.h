@@ -0,0 +1,77 @@
+#pragma once
+#include "AstRewriter.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/* Computes a pure expression once when a block evaluates it repeatedly. Its
+ * first occurrence is assigned to a hidden variable in front of the
+ * statement and every later one reads that variable, until a statement
+ * assigns a variable the expression reads. Candidates are operators and int,
+ * float, string and bool calls over variables and literals. Computing the
+ * value ahead of its statement must stay invisible, so it either cannot
+ * fail, or nothing the statement evaluates before it can. */
+class CommonSubexpressionElimination : public AstRewriter {
+public:
+  CommonSubexpressionElimination() = default;
+  void eliminate(class Program &inProgram);
+  size_t getReusedCount() const;
+
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  struct Computed {
+    std::string variable;
+    std::unordered_set<std::string> reads;
+  };
+
+  /* Hoists the repeated candidates of the statement at inIndex into outBlock */
+  void hoistRepeated(const class Expression &inExpression,
+                     const std::vector<std::unique_ptr<class Instruction>>
+                         &inInstructions,
+                     size_t inIndex, class Block &outBlock);
+  size_t countOccurrences(const std::vector<std::unique_ptr<class Instruction>>
+                              &inInstructions,
+                          size_t inIndex, const std::string &inKey,
+                          const std::unordered_set<std::string> &inReads) const;
+  static size_t countOccurrences(const class Expression &inExpression,
+                                 const std::string &inKey);
+  /* Expressions a statement evaluates itself, in evaluation order */
+  static std::vector<const class Expression *>
+  getEvaluated(const class Instruction &inInstruction);
+  /* True when nothing inInstruction evaluates before inTarget can fail */
+  bool hasCleanPrefix(const class Instruction &inInstruction,
+                      const class Expression &inTarget) const;
+  /* 1 when inTarget is reached without anything failing first, -1 when
+   * something may, 0 when inTarget is not in inExpression */
+  int findClean(const class Expression &inExpression,
+                const class Expression &inTarget) const;
+  bool isSafe(const class Expression &inExpression) const;
+  bool isCandidate(const class Expression &inExpression) const;
+  bool isChecked(const class InstructionFunctionCall &inCall) const;
+  void kill(const std::unordered_set<std::string> &inNames);
+  static std::string getKey(const class Expression &inExpression);
+  static void collectReads(const class Expression &inExpression,
+                           std::unordered_set<std::string> &outNames);
+
+  Context builtins;
+  /* Number of definitions of every user function */
+  std::unordered_map<std::string, size_t> definitions;
+  /* Declarations of every name in the current function */
+  std::unordered_map<std::string, size_t> declarations;
+  /* Mutability of the variables declared on every path to this point */
+  std::unordered_map<std::string, bool> declared;
+  /* Hidden variables holding the values of candidates by key */
+  std::unordered_map<std::string, Computed> computed;
+  size_t loopDepth = 0;
+  size_t reusedCount = 0;
+};
@@ -0,0 +1,143 @@
+#include "ConstantFolding.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../interpreter/ValueOperations.h"
+#include <exception>
+
+size_t ConstantFolding::getFoldedCount() const { return foldedCount; }
+
+Completion ConstantFolding::visit(const BinaryExpression &inBinaryExpression) {
+  AstRewriter::visit(inBinaryExpression);
+  auto *binaryExpression = static_cast<BinaryExpression *>(expression.get());
+  const RuntimeValue *lhs = getConstant(*binaryExpression->getLhs());
+  const RuntimeValue *rhs = getConstant(*binaryExpression->getRhs());
+  const Expression::Operator op = binaryExpression->getOperator();
+  try {
+    /* The rhs of || and && is dropped when it would never run */
+    if (lhs && ValueOperations::shortCircuits(op, *lhs)) {
+      expression =
+          makeConstant(RuntimeValue(op == Expression::Operator::LogicalOr));
+      ++foldedCount;
+      return Completion::Normal;
+    }
+  } catch (const std::exception &) {
+    return Completion::Normal;
+  }
+  if (!lhs || !rhs)
+    return Completion::Normal;
+
+  try {
+    expression = makeConstant(ValueOperations::binaryOperation(
+        binaryExpression->getOperator(), *lhs, *rhs));
+    ++foldedCount;
+  } catch (const std::exception &) {
+  }
+  return Completion::Normal;
+}
+
+Completion ConstantFolding::visit(const Block &inBlock) {
+  /* Declarations of a nested block may not have run once it is left */
+  auto enclosingConstants = constants;
+  AstRewriter::visit(inBlock);
+  constants = std::move(enclosingConstants);
+  return Completion::Normal;
+}
+
+Completion ConstantFolding::visit(const Function &inFunction) {
+  constants.clear();
+  return AstRewriter::visit(inFunction);
+}
+
+Completion ConstantFolding::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  AstRewriter::visit(inFunctionCallExpression);
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      static_cast<FunctionCallExpression *>(expression.get())
+          ->getFunctionCall());
+  const std::string &name = call->getFunctionName();
+  if (call->getExpressions().size() != 1 || isUserFunction(name))
+    return Completion::Normal;
+  const RuntimeValue *argument = getConstant(*call->getExpressions()[0]);
+  if (!argument)
+    return Completion::Normal;
+
+  try {
+    if (name == "int")
+      expression = makeConstant(ValueOperations::toInt(*argument));
+    else if (name == "float")
+      expression = makeConstant(ValueOperations::toFloat(*argument));
+    else if (name == "string")
+      expression = makeConstant(ValueOperations::toString(*argument));
+    else if (name == "bool")
+      expression = makeConstant(ValueOperations::toBool(*argument));
+    else
+      return Completion::Normal;
+    ++foldedCount;
+  } catch (const std::exception &) {
+  }
+  return Completion::Normal;
+}
+
+Completion ConstantFolding::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  AstRewriter::visit(inDeclarationVariable);
+  auto *declaration =
+      static_cast<InstructionDeclarationVariable *>(instruction.get());
+  const std::string &name = declaration->getIdentifier();
+  /* A second declaration fails at runtime, nothing after it runs */
+  constants.erase(name);
+  if (declaration->isMutable() || name == "_")
+    return Completion::Normal;
+
+  if (!declaration->getExpression())
+    constants.insert(std::make_pair(name, RuntimeValue(0)));
+  else if (const RuntimeValue *value =
+               getConstant(*declaration->getExpression()))
+    constants.insert(std::make_pair(name, *value));
+  return Completion::Normal;
+}
+
+Completion ConstantFolding::visit(const UnaryExpression &inUnaryExpression) {
+  AstRewriter::visit(inUnaryExpression);
+  const RuntimeValue *value = getConstant(
+      *static_cast<UnaryExpression *>(expression.get())->getExpression());
+  if (!value)
+    return Completion::Normal;
+
+  try {
+    expression = makeConstant(ValueOperations::unaryOperation(*value));
+    ++foldedCount;
+  } catch (const std::exception &) {
+  }
+  return Completion::Normal;
+}
+
+Completion
+ConstantFolding::visit(const VariableExpression &inVariableExpression) {
+  const Variable *variable = inVariableExpression.getVariable();
+  if (variable->getName()) {
+    auto it = constants.find(*variable->getName());
+    if (it != constants.end()) {
+      expression = makeConstant(it->second);
+      ++foldedCount;
+      return Completion::Normal;
+    }
+  }
+  return AstRewriter::visit(inVariableExpression);
+}
+
+bool ConstantFolding::isUserFunction(const std::string &inName) const {
+  for (const auto &function : program->getFunctions()) {
+    if (function->getIdentifier() == inName)
+      return true;
+  }
+  return false;
+}
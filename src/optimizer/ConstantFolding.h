@@ -0,0 +1,37 @@
+#pragma once
+#include "AstRewriter.h"
+#include <string>
+#include <unordered_map>
+
+/* Evaluates operators and builtin conversions whose operands are literals
+ * and replaces reads of immutable variables declared with a literal by that
+ * literal, so folding carries on through them. A variable is only
+ * propagated where its declaration has run on every path. Operations that
+ * fail, like a division by zero, are left in place and still raise their
+ * error when, and only if, they run. */
+class ConstantFolding : public AstRewriter {
+public:
+  ConstantFolding() = default;
+  size_t getFoldedCount() const;
+
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+
+private:
+  bool isUserFunction(const std::string &inName) const;
+
+  /* Literals of the immutable variables declared so far in the enclosing
+   * blocks */
+  std::unordered_map<std::string, RuntimeValue> constants;
+  size_t foldedCount = 0;
+};
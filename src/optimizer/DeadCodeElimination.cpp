@@ -0,0 +1,153 @@
+#include "DeadCodeElimination.h"
+#include "../instructions/Block.h"
+#include "../instructions/Case.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/IfElse.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/Match.h"
+#include "../instructions/Program.h"
+#include "../instructions/While.h"
+#include "../interpreter/ValueOperations.h"
+#include <unordered_set>
+
+void DeadCodeElimination::eliminate(Program &inProgram) {
+  rewrite(inProgram);
+  removeUnreachableFunctions(inProgram);
+}
+
+size_t DeadCodeElimination::getEliminatedCount() const {
+  return eliminatedCount;
+}
+
+Completion DeadCodeElimination::visit(const Block &inBlock) {
+  auto rewritten = std::make_unique<Block>();
+  appendLive(*rewritten, inBlock);
+  block = std::move(rewritten);
+  return Completion::Normal;
+}
+
+Completion DeadCodeElimination::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  calls[currentFunction].push_back(
+      static_cast<const InstructionFunctionCall *>(
+          inFunctionCallExpression.getFunctionCall())
+          ->getFunctionName());
+  return AstRewriter::visit(inFunctionCallExpression);
+}
+
+Completion
+DeadCodeElimination::visit(const InstructionFunctionCall &inFunctionCall) {
+  calls[currentFunction].push_back(inFunctionCall.getFunctionName());
+  return AstRewriter::visit(inFunctionCall);
+}
+
+Completion DeadCodeElimination::visit(const Match &inMatch) {
+  auto match =
+      std::make_unique<Match>(rewriteExpression(*inMatch.getExpression()));
+  const RuntimeValue *subject = getConstant(*match->getExpression());
+  const auto &cases = inMatch.getCases();
+  for (size_t i = 0; i < cases.size(); ++i) {
+    const RuntimeValue *caseValue = getConstant(*cases[i]->getExpression());
+    if (caseValue && subject &&
+        !ValueOperations::matchesCase(*subject, *caseValue)) {
+      ++eliminatedCount;
+      continue;
+    }
+
+    cases[i]->accept(*this);
+    match->addCase(
+        std::unique_ptr<Case>(static_cast<Case *>(instruction.release())));
+    if (caseValue && (ValueOperations::isTrue(*caseValue) || subject)) {
+      eliminatedCount += cases.size() - i - 1;
+      break;
+    }
+  }
+  instruction = std::move(match);
+  return Completion::Normal;
+}
+
+bool DeadCodeElimination::appendLive(Block &outBlock, const Block &inBlock) {
+  const auto &instructions = inBlock.getInstructions();
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    if (auto *ifElse = dynamic_cast<const IfElse *>(instructions[i].get())) {
+      if (const RuntimeValue *condition =
+              getConstant(*ifElse->getExpression())) {
+        /* Blocks do not scope locals, the taken branch joins this one */
+        ++eliminatedCount;
+        const Block *taken = ValueOperations::isTrue(*condition)
+                                 ? ifElse->getBlockIf()
+                                 : ifElse->getBlockElse();
+        if (taken && appendLive(outBlock, *taken)) {
+          eliminatedCount += instructions.size() - i - 1;
+          return true;
+        }
+        continue;
+      }
+    } else if (auto *loop = dynamic_cast<const While *>(instructions[i].get())) {
+      const RuntimeValue *condition = getConstant(*loop->getExpression());
+      if (condition && condition->getType() == RuntimeValue::Type::Bool &&
+          !condition->getBool()) {
+        ++eliminatedCount;
+        continue;
+      }
+    }
+
+    auto live = rewriteInstruction(*instructions[i]);
+    const bool bReturns = alwaysReturns(*live);
+    outBlock.addInstruction(std::move(live));
+    if (bReturns) {
+      eliminatedCount += instructions.size() - i - 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DeadCodeElimination::removeUnreachableFunctions(Program &inProgram) {
+  std::unordered_map<std::string, std::vector<const Function *>> byName;
+  for (const auto &function : inProgram.getFunctions()) {
+    byName[function->getIdentifier()].push_back(function.get());
+  }
+  if (byName.find("main") == byName.end())
+    return;
+
+  std::unordered_set<std::string> reached = {"main"};
+  std::vector<std::string> pending = {"main"};
+  while (!pending.empty()) {
+    auto it = byName.find(pending.back());
+    pending.pop_back();
+    if (it == byName.end())
+      continue;
+    for (const Function *function : it->second) {
+      for (const auto &name : calls[function]) {
+        if (reached.insert(name).second)
+          pending.push_back(name);
+      }
+    }
+  }
+
+  const Context builtins;
+  for (const auto &entry : byName) {
+    if (reached.count(entry.first) || entry.second.size() != 1 ||
+        builtins.findFunction(entry.first))
+      continue;
+    inProgram.removeFunction(entry.second.front());
+    ++eliminatedCount;
+  }
+}
+
+bool DeadCodeElimination::alwaysReturns(const Instruction &inInstruction) {
+  if (dynamic_cast<const InstructionReturn *>(&inInstruction))
+    return true;
+  auto *ifElse = dynamic_cast<const IfElse *>(&inInstruction);
+  return ifElse && ifElse->getBlockElse() &&
+         alwaysReturns(*ifElse->getBlockIf()) &&
+         alwaysReturns(*ifElse->getBlockElse());
+}
+
+bool DeadCodeElimination::alwaysReturns(const Block &inBlock) {
+  const auto &instructions = inBlock.getInstructions();
+  return !instructions.empty() && alwaysReturns(*instructions.back());
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "AstRewriter.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Drops code that can never run: instructions after a return, the untaken
+ * branch of an if on a literal, whiles on false, match cases that cannot
+ * match or follow one that always does, and functions main never calls.
+ * Meant to run after ConstantFolding, which turns conditions into literals.
+ * Functions whose name is defined twice or shadows a builtin are kept, so
+ * their redefinition is still reported. */
+class DeadCodeElimination : public AstRewriter {
+public:
+  DeadCodeElimination() = default;
+  void eliminate(class Program &inProgram);
+  size_t getEliminatedCount() const;
+
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion
+  visit(const class InstructionFunctionCall &inFunctionCall) override;
+  virtual Completion visit(const class Match &inMatch) override;
+
+private:
+  /* Appends the live instructions of inBlock to outBlock, true once one of
+   * them always returns */
+  bool appendLive(class Block &outBlock, const class Block &inBlock);
+  void removeUnreachableFunctions(class Program &inProgram);
+  static bool alwaysReturns(const class Instruction &inInstruction);
+  static bool alwaysReturns(const class Block &inBlock);
+
+  /* Names called by the kept code of every function */
+  std::unordered_map<const class Function *, std::vector<std::string>> calls;
+  size_t eliminatedCount = 0;
+};
@@ -0,0 +1,201 @@
+#include "Inlining.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/InstructionReturn.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include <unordered_set>
+
+void Inlining::inlineCalls(Program &inProgram) {
+  findCandidates(inProgram);
+  if (!candidates.empty() && annotateTypes(inProgram))
+    rewrite(inProgram);
+}
+
+size_t Inlining::getInlinedCount() const { return inlinedCount; }
+
+Completion
+Inlining::visit(const FunctionCallExpression &inFunctionCallExpression) {
+  AstRewriter::visit(inFunctionCallExpression);
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      static_cast<FunctionCallExpression *>(expression.get())
+          ->getFunctionCall());
+  auto candidate = candidates.find(call->getFunctionName());
+  if (candidate == candidates.end() ||
+      !canInline(candidate->second, *call,
+                 *static_cast<const InstructionFunctionCall *>(
+                     inFunctionCallExpression.getFunctionCall())))
+    return Completion::Normal;
+
+  /* The arguments live in the call until the body is rewritten */
+  std::unique_ptr<Expression> callExpression = std::move(expression);
+  std::unordered_map<std::string, const Expression *> arguments;
+  for (size_t i = 0; i < candidate->second.parameters.size(); ++i) {
+    arguments[candidate->second.parameters[i]] =
+        call->getExpressions()[i].get();
+  }
+  substitutions.push_back(std::move(arguments));
+  expression = rewriteExpression(*candidate->second.body);
+  substitutions.pop_back();
+  ++inlinedCount;
+  return Completion::Normal;
+}
+
+Completion Inlining::visit(const VariableExpression &inVariableExpression) {
+  const Variable *variable = inVariableExpression.getVariable();
+  if (substitutions.empty() || !variable->getName())
+    return AstRewriter::visit(inVariableExpression);
+
+  /* Arguments belong to the outermost caller, nothing in them is
+   * substituted again */
+  const Expression *argument = substitutions.back().at(*variable->getName());
+  auto enclosingSubstitutions = std::move(substitutions);
+  substitutions.clear();
+  expression = rewriteExpression(*argument);
+  substitutions = std::move(enclosingSubstitutions);
+  return Completion::Normal;
+}
+
+bool Inlining::inspect(const Expression &inExpression, Candidate &outCandidate,
+                       bool bIsConditional) {
+  ++outCandidate.size;
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression))
+    return inspect(*binaryExpression->getLhs(), outCandidate,
+                   bIsConditional) &&
+           inspect(*binaryExpression->getRhs(), outCandidate,
+                   bIsConditional || binaryExpression->isLogical());
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return inspect(*unaryExpression->getExpression(), outCandidate,
+                   bIsConditional);
+  if (auto *variableExpression =
+          dynamic_cast<const VariableExpression *>(&inExpression)) {
+    const Variable *variable = variableExpression->getVariable();
+    if (!variable->getName())
+      return true;
+    auto read = outCandidate.reads.find(*variable->getName());
+    if (read == outCandidate.reads.end())
+      return false;
+    ++read->second;
+    if (!bIsConditional)
+      outCandidate.certainReads.insert(read->first);
+    return true;
+  }
+
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      static_cast<const FunctionCallExpression &>(inExpression)
+          .getFunctionCall());
+  outCandidate.calls.push_back(call->getFunctionName());
+  for (const auto &argument : call->getExpressions()) {
+    if (!inspect(*argument, outCandidate, bIsConditional))
+      return false;
+  }
+  return true;
+}
+
+void Inlining::findCandidates(const Program &inProgram) {
+  std::unordered_map<std::string, size_t> definitions;
+  for (const auto &function : inProgram.getFunctions()) {
+    ++definitions[function->getIdentifier()];
+  }
+
+  for (const auto &function : inProgram.getFunctions()) {
+    const std::string &name = function->getIdentifier();
+    if (definitions[name] != 1 || builtins.findFunction(name) ||
+        !function->getBlock())
+      continue;
+    const auto &instructions = function->getBlock()->getInstructions();
+    auto *returnInstruction =
+        instructions.size() == 1
+            ? dynamic_cast<const InstructionReturn *>(instructions[0].get())
+            : nullptr;
+    if (!returnInstruction || !returnInstruction->getExpression())
+      continue;
+
+    Candidate candidate;
+    candidate.body = returnInstruction->getExpression();
+    bool bIsValid = true;
+    for (const auto &argument : function->getArguments()) {
+      candidate.parameters.push_back(argument->getName());
+      bIsValid &= argument->getName() != "_" &&
+                  candidate.reads.emplace(argument->getName(), 0).second;
+    }
+    if (bIsValid && inspect(*candidate.body, candidate) &&
+        candidate.size <= InlineSizeLimit)
+      candidates.emplace(name, std::move(candidate));
+  }
+
+  /* Drop candidates calling other user functions or themselves, until the
+   * remaining ones only call builtins and each other without cycles */
+  bool bChanged = true;
+  while (bChanged) {
+    bChanged = false;
+    for (auto it = candidates.begin(); it != candidates.end();) {
+      std::unordered_set<std::string> reached;
+      std::vector<std::string> pending = it->second.calls;
+      bool bIsInlinable = true;
+      while (!pending.empty() && bIsInlinable) {
+        std::string name = pending.back();
+        pending.pop_back();
+        auto callee = candidates.find(name);
+        if (callee == candidates.end()) {
+          bIsInlinable = definitions.count(name) == 0 &&
+                         builtins.findFunction(name) != nullptr;
+          continue;
+        }
+        bIsInlinable = callee != it;
+        if (reached.insert(name).second)
+          pending.insert(pending.end(), callee->second.calls.begin(),
+                         callee->second.calls.end());
+      }
+      if (bIsInlinable) {
+        ++it;
+        continue;
+      }
+      it = candidates.erase(it);
+      bChanged = true;
+    }
+  }
+}
+
+bool Inlining::cannotFailInlined(const Expression &inArgument) const {
+  if (auto *callExpression =
+          dynamic_cast<const FunctionCallExpression *>(&inArgument)) {
+    auto *call = static_cast<const InstructionFunctionCall *>(
+        callExpression->getFunctionCall());
+    auto candidate = candidates.find(call->getFunctionName());
+    if (candidate != candidates.end())
+      return cannotFail(*candidate->second.body) &&
+             canInline(candidate->second, *call, *call);
+  }
+  return cannotFail(inArgument);
+}
+
+bool Inlining::canInline(const Candidate &inCandidate,
+                         const InstructionFunctionCall &inCall,
+                         const InstructionFunctionCall &inOriginalCall) const {
+  const auto &arguments = inCall.getExpressions();
+  if (arguments.size() != inCandidate.parameters.size())
+    return false;
+
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const size_t reads = inCandidate.reads.at(inCandidate.parameters[i]);
+    if (reads == 0 || !cannotFailInlined(*inOriginalCall.getExpressions()[i]))
+      return false;
+    auto *variableExpression =
+        dynamic_cast<const VariableExpression *>(arguments[i].get());
+    if (reads > 1 && !variableExpression)
+      return false;
+    if (!inCandidate.certainReads.count(inCandidate.parameters[i]) &&
+        (!variableExpression || variableExpression->getVariable()->getName()))
+      return false;
+  }
+  return true;
+}
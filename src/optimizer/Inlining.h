@@ -0,0 +1,62 @@
+#pragma once
+#include "AstRewriter.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/* Replaces calls of small functions by their body. A function is inlined
+ * when its body is a single return of at most InlineSizeLimit nodes reading
+ * only its parameters and calling only builtins and other inlined functions,
+ * which rules out recursion. Such a body never assigns its parameters, so mut
+ * parameters need no copy. Arguments are substituted for the parameters, so a
+ * call is only inlined when its arguments have no side effects, every
+ * parameter is read and parameters read more than once get a literal or a
+ * variable. Parameters read only on the right of || or && may not be read at
+ * all, so they need a literal too. The body reads the arguments in its own
+ * order, so they must not fail either, or the error reported could change. */
+class Inlining : public AstRewriter {
+public:
+  static const size_t InlineSizeLimit = 16;
+
+  Inlining() = default;
+  void inlineCalls(class Program &inProgram);
+  size_t getInlinedCount() const;
+
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion
+  visit(const class VariableExpression &inVariableExpression) override;
+
+private:
+  struct Candidate {
+    const class Expression *body = nullptr;
+    std::vector<std::string> parameters;
+    std::unordered_map<std::string, size_t> reads;
+    /* Parameters read whatever || and && decide */
+    std::unordered_set<std::string> certainReads;
+    std::vector<std::string> calls;
+    size_t size = 0;
+  };
+
+  /* Collects the reads, calls and size of inExpression, false when it cannot
+   * be inlined */
+  bool inspect(const class Expression &inExpression, Candidate &outCandidate,
+               bool bIsConditional = false);
+  void findCandidates(const class Program &inProgram);
+  /* Like cannotFail, also accepting calls that are inlined into an
+   * expression that cannot fail */
+  bool cannotFailInlined(const class Expression &inArgument) const;
+  /* inCall is the rewritten inOriginalCall, whose arguments still have
+   * their operand types */
+  bool canInline(const Candidate &inCandidate,
+                 const class InstructionFunctionCall &inCall,
+                 const class InstructionFunctionCall &inOriginalCall) const;
+
+  Context builtins;
+  std::unordered_map<std::string, Candidate> candidates;
+  /* Arguments standing for the parameters of the bodies being inlined */
+  std::vector<std::unordered_map<std::string, const class Expression *>>
+      substitutions;
+  size_t inlinedCount = 0;
+};
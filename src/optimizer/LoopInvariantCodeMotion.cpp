@@ -0,0 +1,139 @@
+#include "LoopInvariantCodeMotion.h"
+#include "../instructions/BinaryExpression.h"
+#include "../instructions/Block.h"
+#include "../instructions/Function.h"
+#include "../instructions/FunctionCallExpression.h"
+#include "../instructions/InstructionAssigment.h"
+#include "../instructions/InstructionDeclarationVariable.h"
+#include "../instructions/InstructionFunctionCall.h"
+#include "../instructions/ParameterDefinition.h"
+#include "../instructions/Program.h"
+#include "../instructions/UnaryExpression.h"
+#include "../instructions/Variable.h"
+#include "../instructions/VariableExpression.h"
+#include "../instructions/While.h"
+
+void LoopInvariantCodeMotion::hoist(Program &inProgram) {
+  if (annotateTypes(inProgram))
+    rewrite(inProgram);
+}
+
+size_t LoopInvariantCodeMotion::getHoistedCount() const {
+  return hoistedCount;
+}
+
+Completion
+LoopInvariantCodeMotion::visit(const BinaryExpression &inBinaryExpression) {
+  if (hoistExpression(inBinaryExpression))
+    return Completion::Normal;
+  return AstRewriter::visit(inBinaryExpression);
+}
+
+Completion LoopInvariantCodeMotion::visit(const Block &inBlock) {
+  auto enclosingDeclared = declared;
+  auto rewritten = std::make_unique<Block>();
+  for (const auto &instruction : inBlock.getInstructions()) {
+    auto live = rewriteInstruction(*instruction);
+    for (auto &assignment : preheader) {
+      rewritten->addInstruction(std::move(assignment));
+    }
+    preheader.clear();
+    rewritten->addInstruction(std::move(live));
+  }
+  declared = std::move(enclosingDeclared);
+  block = std::move(rewritten);
+  return Completion::Normal;
+}
+
+Completion LoopInvariantCodeMotion::visit(const Function &inFunction) {
+  declared.clear();
+  for (const auto &argument : inFunction.getArguments()) {
+    declared.insert(argument->getName());
+  }
+  return AstRewriter::visit(inFunction);
+}
+
+Completion LoopInvariantCodeMotion::visit(
+    const FunctionCallExpression &inFunctionCallExpression) {
+  if (hoistExpression(inFunctionCallExpression))
+    return Completion::Normal;
+  return AstRewriter::visit(inFunctionCallExpression);
+}
+
+Completion LoopInvariantCodeMotion::visit(
+    const InstructionDeclarationVariable &inDeclarationVariable) {
+  AstRewriter::visit(inDeclarationVariable);
+  declared.insert(inDeclarationVariable.getIdentifier());
+  return Completion::Normal;
+}
+
+Completion
+LoopInvariantCodeMotion::visit(const UnaryExpression &inUnaryExpression) {
+  if (hoistExpression(inUnaryExpression))
+    return Completion::Normal;
+  return AstRewriter::visit(inUnaryExpression);
+}
+
+Completion LoopInvariantCodeMotion::visit(const While &inWhile) {
+  Loop loop;
+  loop.available = declared;
+  collectAssigned(*inWhile.getBody(), loop.assigned);
+  loops.push_back(std::move(loop));
+
+  auto condition = rewriteExpression(*inWhile.getExpression());
+  auto body = rewriteBlock(*inWhile.getBody());
+  preheader = std::move(loops.back().preheader);
+  loops.pop_back();
+  instruction = std::make_unique<While>(std::move(condition), std::move(body));
+  return Completion::Normal;
+}
+
+bool LoopInvariantCodeMotion::hoistExpression(const Expression &inExpression) {
+  if (loops.empty() || !cannotFail(inExpression))
+    return false;
+
+  /* Outer loops come first, an expression invariant in one is invariant in
+   * every loop nested in it */
+  for (size_t i = 0; i < loops.size(); ++i) {
+    if (!isInvariant(inExpression, loops[i]))
+      continue;
+
+    const std::string name = addHiddenVariable("invariant");
+    auto enclosingLoops = std::move(loops);
+    loops.clear();
+    auto value = rewriteExpression(inExpression);
+    loops = std::move(enclosingLoops);
+
+    loops[i].preheader.push_back(std::make_unique<InstructionAssigment>(
+        std::make_unique<Variable>(name), std::move(value)));
+    expression = std::make_unique<VariableExpression>(
+        std::make_unique<Variable>(name));
+    ++hoistedCount;
+    return true;
+  }
+  return false;
+}
+
+bool LoopInvariantCodeMotion::isInvariant(const Expression &inExpression,
+                                          const Loop &inLoop) const {
+  if (auto *binaryExpression =
+          dynamic_cast<const BinaryExpression *>(&inExpression))
+    return isInvariant(*binaryExpression->getLhs(), inLoop) &&
+           isInvariant(*binaryExpression->getRhs(), inLoop);
+  if (auto *unaryExpression =
+          dynamic_cast<const UnaryExpression *>(&inExpression))
+    return isInvariant(*unaryExpression->getExpression(), inLoop);
+  if (auto *variableExpression =
+          dynamic_cast<const VariableExpression *>(&inExpression)) {
+    const auto &name = variableExpression->getVariable()->getName();
+    return !name || (*name != "_" && inLoop.available.count(*name) &&
+                     !inLoop.assigned.count(*name));
+  }
+
+  auto *call = static_cast<const InstructionFunctionCall *>(
+      static_cast<const FunctionCallExpression &>(inExpression)
+          .getFunctionCall());
+  return call->getFunctionName() == "string" &&
+         call->getExpressions().size() == 1 &&
+         isInvariant(*call->getExpressions()[0], inLoop);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "AstRewriter.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/* Moves expressions of a while condition or body that compute the same value
+ * on every iteration in front of the loop. An expression is moved when it
+ * only reads variables declared before the loop and never assigned or
+ * declared inside it, and when it cannot fail: its operand types must be
+ * known from TypeInference and it may not divide by anything but a nonzero
+ * literal, so running it when the loop does not is invisible. The value is
+ * kept in a hidden variable declared at the start of the function and
+ * assigned in front of the outermost loop the expression is invariant in. */
+class LoopInvariantCodeMotion : public AstRewriter {
+public:
+  LoopInvariantCodeMotion() = default;
+  void hoist(class Program &inProgram);
+  size_t getHoistedCount() const;
+
+  virtual Completion
+  visit(const class BinaryExpression &inBinaryExpression) override;
+  virtual Completion visit(const class Block &inBlock) override;
+  virtual Completion visit(const class Function &inFunction) override;
+  virtual Completion visit(
+      const class FunctionCallExpression &inFunctionCallExpression) override;
+  virtual Completion visit(const class InstructionDeclarationVariable &inDeclarationVariable)
+      override;
+  virtual Completion
+  visit(const class UnaryExpression &inUnaryExpression) override;
+  virtual Completion visit(const class While &inWhile) override;
+
+private:
+  struct Loop {
+    /* Variables declared on every path to the loop */
+    std::unordered_set<std::string> available;
+    /* Variables assigned or declared anywhere inside the loop */
+    std::unordered_set<std::string> assigned;
+    /* Assignments of the hidden variables, run in front of the loop */
+    std::vector<std::unique_ptr<class Instruction>> preheader;
+  };
+
+  /* Replaces inExpression by a hidden variable when it can be hoisted */
+  bool hoistExpression(const class Expression &inExpression);
+  bool isInvariant(const class Expression &inExpression,
+                   const Loop &inLoop) const;
+
+  std::vector<Loop> loops;
+  /* Assignments to run in front of the loop built by the last visit */
+  std::vector<std::unique_ptr<class Instruction>> preheader;
+  /* Variables declared on every path to the current instruction */
+  std::unordered_set<std::string> declared;
+  size_t hoistedCount = 0;
+};
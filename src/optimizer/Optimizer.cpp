@@ -0,0 +1,39 @@
+#include "Optimizer.h"
+#include "CommonSubexpressionElimination.h"
+#include "ConstantFolding.h"
+#include "DeadCodeElimination.h"
+#include "Inlining.h"
+#include "LoopInvariantCodeMotion.h"
+#include "../instructions/Program.h"
+
+void Optimizer::optimize(Program &inProgram) {
+  Inlining inlining;
+  inlining.inlineCalls(inProgram);
+  inlinedCount += inlining.getInlinedCount();
+
+  ConstantFolding constantFolding;
+  constantFolding.rewrite(inProgram);
+  foldedCount += constantFolding.getFoldedCount();
+
+  DeadCodeElimination deadCodeElimination;
+  deadCodeElimination.eliminate(inProgram);
+  eliminatedCount += deadCodeElimination.getEliminatedCount();
+
+  LoopInvariantCodeMotion loopInvariantCodeMotion;
+  loopInvariantCodeMotion.hoist(inProgram);
+  hoistedCount += loopInvariantCodeMotion.getHoistedCount();
+
+  CommonSubexpressionElimination commonSubexpressionElimination;
+  commonSubexpressionElimination.eliminate(inProgram);
+  reusedCount += commonSubexpressionElimination.getReusedCount();
+}
+
+size_t Optimizer::getInlinedCount() const { return inlinedCount; }
+
+size_t Optimizer::getFoldedCount() const { return foldedCount; }
+
+size_t Optimizer::getEliminatedCount() const { return eliminatedCount; }
+
+size_t Optimizer::getHoistedCount() const { return hoistedCount; }
+
+size_t Optimizer::getReusedCount() const { return reusedCount; }
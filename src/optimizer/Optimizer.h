@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+/* Runs the AST passes enabled by -O over a parsed program, before any engine
+ * resolves it */
+class Optimizer {
+public:
+  Optimizer() = default;
+  void optimize(class Program &inProgram);
+  size_t getInlinedCount() const;
+  size_t getFoldedCount() const;
+  size_t getEliminatedCount() const;
+  size_t getHoistedCount() const;
+  size_t getReusedCount() const;
+
+private:
+  size_t inlinedCount = 0;
+  size_t foldedCount = 0;
+  size_t eliminatedCount = 0;
+  size_t hoistedCount = 0;
+  size_t reusedCount = 0;
+};
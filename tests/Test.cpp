@@ -1,8 +1,10 @@
 ﻿#define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE Tests
 
+#include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include "../src/instructions/BinaryExpression.h"
 #include "../src/instructions/Block.h"
 #include "../src/instructions/Case.h"
 #include "../src/instructions/Function.h"
@@ -17,8 +19,20 @@
 #include "../src/instructions/Variable.h"
 #include "../src/instructions/While.h"
 #include "../src/interpreter/InterpreterError.h"
+#include "../src/interpreter/MemoTable.h"
+#include "../src/interpreter/PurityAnalysis.h"
+#include "../src/interpreter/Resolver.h"
+#include "../src/interpreter/TypeInference.h"
 #include "../src/interpreter/VisitorInterpreter.h"
 #include "../src/interpreter/VisitorInterpreterImpl.h"
+#include "../src/bytecode/BytecodeInterpreter.h"
+#include "../src/bytecode/RegisterInterpreter.h"
+#include "../src/closure/ClosureInterpreter.h"
+#include "../src/aot/CEmitter.h"
+#include "../src/optimizer/Optimizer.h"
+#include "../src/ir/IrBuilder.h"
+#include "../src/ir/IrOptimizer.h"
+#include "../src/ir/IrVerifier.h"
 #include "../src/lexer/Lexer.h"
 #include "../src/lexer/SourceStream.h"
 #include "../src/parser/Parser.h"
@@ -36,12 +50,41 @@ std::unique_ptr<Parser> configureParser(const std::string_view &program) {
   return std::make_unique<Parser>(std::move(lexer));
 }
 
-std::unique_ptr<VisitorInterpreter>
+/* Tree walker compiling each function on its first call */
+class EagerJitInterpreter : public VisitorInterpreterImpl {
+public:
+  explicit EagerJitInterpreter(std::unique_ptr<Parser> inParser)
+      : VisitorInterpreterImpl(std::move(inParser), 1) {}
+};
+
+/* Register machine running the IR after the passes of -O */
+class OptimizedRegisterInterpreter : public RegisterInterpreter {
+public:
+  explicit OptimizedRegisterInterpreter(std::unique_ptr<Parser> inParser)
+      : RegisterInterpreter(std::move(inParser), true) {}
+};
+
+/* Every interpreter test runs against each execution engine */
+typedef boost::mpl::list<VisitorInterpreterImpl, EagerJitInterpreter,
+                         ClosureInterpreter, BytecodeInterpreter,
+                         RegisterInterpreter, OptimizedRegisterInterpreter>
+    Interpreters;
+
+template <class InterpreterType>
+std::unique_ptr<Interpreter>
 configureInterpreter(const std::string_view &program) {
   std::unique_ptr<Source> source = std::make_unique<SourceStream>(program);
   std::unique_ptr<Lexer> lexer(std::make_unique<Lexer>(std::move(source)));
   std::unique_ptr<Parser> parser(std::make_unique<Parser>(std::move(lexer)));
-  return std::make_unique<VisitorInterpreterImpl>(std::move(parser));
+  return std::make_unique<InterpreterType>(std::move(parser));
+}
+
+template <class InterpreterType>
+std::unique_ptr<Interpreter>
+configureOptimizedInterpreter(const std::string_view &program) {
+  auto parser = configureParser(program);
+  Optimizer().optimize(*parser->parseProgram());
+  return std::make_unique<InterpreterType>(std::move(parser));
 }
 
 BOOST_AUTO_TEST_SUITE(LEXER)
@@ -1113,137 +1156,137 @@ BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(INTERPRETER)
 
-BOOST_AUTO_TEST_CASE(EmptyReturnTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(EmptyReturnTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(interpreter->execute().has_value(), false);
 }
 
-BOOST_AUTO_TEST_CASE(IntReturnTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(IntReturnTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 1; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
 }
 
-BOOST_AUTO_TEST_CASE(AdditionTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(AdditionTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 5; var b = 6; return a + b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 11);
 }
 
-BOOST_AUTO_TEST_CASE(AssignValueTwiceTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(AssignValueTwiceTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { mut var a = 5; a = 5.14; return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_TEST(std::get<float>(interpreter->execute()->first) == 5.14,
              boost::test_tools::tolerance(0.001));
 }
 
-BOOST_AUTO_TEST_CASE(AdditionTwoTypesTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(AdditionTwoTypesTest, InterpreterType, Interpreters) {
   std::string program =
       "fn main() { var a = 5.0; var b = 6; return int(a) + b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 11);
 }
 
-BOOST_AUTO_TEST_CASE(ScopeTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ScopeTest, InterpreterType, Interpreters) {
   std::string program = "fn test(var a) { var b = 6; return a + b; }fn main() { var b = 5; return test(b); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 11);
 }
 
-BOOST_AUTO_TEST_CASE(ExpressionTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ExpressionTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5 * 3 / 10; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
 }
 
-BOOST_AUTO_TEST_CASE(ExpressionTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ExpressionTest2, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0 * 3.0 / 10.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<float>(interpreter->execute()->first), 1.5);
 }
 
-BOOST_AUTO_TEST_CASE(ExpressionTest3) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ExpressionTest3, InterpreterType, Interpreters) {
   std::string program = "fn main() { return !(( 5<6 )||( 6<7 )); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), false);
 }
 
-BOOST_AUTO_TEST_CASE(ModuloTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5 % 3; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2);
 }
 
-BOOST_AUTO_TEST_CASE(BoolToBoolTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(BoolToBoolTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(true); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(NegationTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(NegationTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return !false; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(StringToBoolTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringToBoolTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(\"true\"); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(IntToBoolTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(IntToBoolTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(2); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(IntToBoolTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(IntToBoolTest2, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(-2); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), false);
 }
 
-BOOST_AUTO_TEST_CASE(FloatToBoolTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(FloatToBoolTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(2.5); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(FloatToBoolTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(FloatToBoolTest2, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(-2.5); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), false);
 }
 
-BOOST_AUTO_TEST_CASE(StringToFloatTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringToFloatTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return float(\"3.0\"); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<float>(interpreter->execute()->first), 3.0);
 }
 
-BOOST_AUTO_TEST_CASE(FloatToStringTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(FloatToStringTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return string(3.0); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first)[0],
                     '3');
@@ -1253,266 +1296,1331 @@ BOOST_AUTO_TEST_CASE(FloatToStringTest) {
                     '0');
 }
 
-BOOST_AUTO_TEST_CASE(BoolToStringTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(BoolToStringTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return string(true); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
                     "true");
 }
 
-BOOST_AUTO_TEST_CASE(ModuloTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloTest2, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0 % 3.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<float>(interpreter->execute()->first), 2.0);
 }
 
-BOOST_AUTO_TEST_CASE(LessEqualTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(LessEqualTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 2; var b = 3; return a <= b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
 }
 
-BOOST_AUTO_TEST_CASE(TwoFunctionsTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(TwoFunctionsTest, InterpreterType, Interpreters) {
   std::string program = "fn add(var a, var b) { return (a + b); } fn main() { "
                         "var c = add(5, 6); return c; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 11);
 }
 
-BOOST_AUTO_TEST_CASE(TwoFunctionsTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(TwoFunctionsTest2, InterpreterType, Interpreters) {
   std::string program = "fn add(var a, var b) { return (a + b); } fn main() { "
                         "var d = 5; var c = add(5, 6); return c + d; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 16);
 }
 
-BOOST_AUTO_TEST_CASE(FibTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(FibTest, InterpreterType, Interpreters) {
   std::string program =
       "fn fib(var n) { if (n <= 1) {return n;} else { return fib(n-1) + "
       "fib(n-2);}} fn main() {var n = fib(3); return n; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2);
 }
 
-BOOST_AUTO_TEST_CASE(WhileTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(WhileTest, InterpreterType, Interpreters) {
   std::string program = "fn main(){ mut var a = 10; mut var c = 0; while(a > "
                         "0){ c = c + 1; a = a - 1;} return c;}";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 10);
 }
 
-BOOST_AUTO_TEST_CASE(TypeChangeTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(TypeChangeTest, InterpreterType, Interpreters) {
   std::string program =
       "fn main() { mut var a = 5.0; a = \"dynamiczny\"; return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
                     "dynamiczny");
 }
 
-BOOST_AUTO_TEST_CASE(TypeChangeTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(TypeChangeTest2, InterpreterType, Interpreters) {
   std::string program =
       "fn main() { mut var a = 5.0; var b = 6; a = int(a); return a + b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 11);
 }
 
 
-BOOST_AUTO_TEST_CASE(MatchTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(MatchTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { mut var a = \"dynamiczny\"; match(a){ "
                         "case (_ == \"quit\") || (_ == \"exit\"): { a = "
                         "\"quit\"; } case _: { a = \"unknown\"; }} return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
                     "unknown");
 }
 
-BOOST_AUTO_TEST_CASE(MatchTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(MatchTest2, InterpreterType, Interpreters) {
   std::string program = "fn main() { mut var a = \"exit\"; match(a){ "
                         "case (_ == \"quit\") || (_ == \"exit\"): { a = "
                         "\"quit\"; } case _: { a = \"unknown\"; }} return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
                     "quit");
 }
 
-BOOST_AUTO_TEST_CASE(MatchTest3) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(MatchTest3, InterpreterType, Interpreters) {
   std::string program = "fn main() { mut var a = 5; var b = 6; match(a+b){ "
                         "case a < b: { a = 6; } case _: { a = \"unknown\"; }} return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 6);
 }
 
-BOOST_AUTO_TEST_CASE(NoInitializationTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(MatchInLoopTest, InterpreterType, Interpreters) {
+  std::string program = "fn main() { mut var i = 0; mut var odd = 0; while (i "
+                        "< 4) { match(i % 2){ case _ == 1: { odd = odd + 1; "
+                        "} } i = i + 1; } return odd; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(LiteralMatchTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn dense(var n) { match (n) { case 3: { return 30; } case 1: { return "
+      "10; } case 3: { return 0; } case 2: { return _ * 10; } } return -1; } "
+      "fn sparse(var n) { match (n) { case 1000: { return 1; } case 7: { "
+      "return 2; } case 1: { return 3; } case true: { return 4; } case 8: { "
+      "return 5; } } return -1; } fn code(var s) { match (s) { case \"get\": "
+      "{ return 1; } case \"put\": { return 2; } case \"\": { return 3; } } "
+      "return -1; } fn main() { return string(dense(1)) + string(dense(2)) + "
+      "string(dense(3)) + string(dense(4)) + string(dense(\"3\")) + "
+      "string(sparse(1)) + string(sparse(8)) + string(sparse(1000)) + "
+      "string(code(\"put\")) + string(code(\"\")) + string(code(\"got\")) + "
+      "string(code(2)); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "102030-1-134123-1-1");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ShortCircuitTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn down(var n) { return (n == 0) || down(n - 1); } fn guard(var x) { "
+      "if ((x != 0) && ((10 / x) > 1)) { return 1; } return 0; } fn main() { mut "
+      "var i = 0; while ((i < 5) && (i != 3)) { i = i + 1; } "
+      "return "
+      "string(down(3)) + string(guard(0)) + string(guard(2)) + string(i) + "
+      "string(true || \"s\") + string(false && (1 / 0)) + string(1 || 2); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "true013truefalsetrue");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ComparisonConditionTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn count(var start, var n, var step) { mut var i = start; mut var c = "
+      "0; while (i < n) { i = i + step; c = c + 1; } return c; } fn main() { "
+      "mut var s = "
+      "\"\"; mut var total = 0; while (s != \"aaa\") { s = s + \"a\"; } if "
+      "(1.5 >= 1.5) { total = total + 1; } if (2 <= 1) { total = total + 10; "
+      "} return string(count(0, 10, 3)) + string(count(0.0, 1.0, 0.25)) + "
+      "s + string(total); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "44aaa1");
+
+  program = "fn main() { var a = 1; while (a < \"2\") { return 1; } return "
+            "0; }";
+  BOOST_CHECK_THROW(configureInterpreter<InterpreterType>(program)->execute(),
+                    std::exception);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(CallChainScopeTest, InterpreterType, Interpreters) {
+  std::string program = "fn h() { return 1; } fn g() { return h() + 1; } fn "
+                        "f() { var a = 10; var b = g(); return a + b; } fn "
+                        "main() { return f(); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 12);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(NestedCallArgumentsTest, InterpreterType, Interpreters) {
+  std::string program = "fn add(var a, var b) { return a + b; } fn main() { "
+                        "return add(add(1, 2), add(int(3.5), add(4, 5))); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 15);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(VoidReturnTest, InterpreterType, Interpreters) {
+  std::string program = "fn f() { return; var a = 1 / 0; } fn main() { f(); "
+                        "return 1; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(CallStatementTest, InterpreterType, Interpreters) {
+  std::string program = "fn f() { return 5; } fn main() { f(); return 1; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(NoInitializationTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a; return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 0);
 }
 
-BOOST_AUTO_TEST_CASE(ModuloFloatTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloFloatTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0%1.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
  BOOST_TEST(std::get<float>(interpreter->execute()->first) == 0.0,
             boost::test_tools::tolerance(0.001));
 }
 
-BOOST_AUTO_TEST_CASE(DefaultValueTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(DefaultValueTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a; return a + 5; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 5);
 }
 
-BOOST_AUTO_TEST_CASE(StringAdditionTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringAdditionTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 'abc'; return a + 'abc'; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first), "abcabc");
 }
 
-BOOST_AUTO_TEST_CASE(StringSubstractionFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringCopyTest, InterpreterType, Interpreters) {
+  std::string program = "fn main() { mut var a = 'abc'; var b = a; a = a + "
+                        "'d'; return b + a; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first), "abcabcd");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringSubstractionFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 'abc'; return a - 'abc'; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(DefaultValueFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(DefaultValueFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a; return a + 'abc'; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ModuloBy0FailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloBy0FailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5%0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ModuloBy0FloatFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloBy0FloatFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0%0.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(DivisionByZeroFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(DivisionByZeroFailTest, InterpreterType, Interpreters) {
   std::string program =
       "fn main() { return 5/0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(DivisionByZeroFloatFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(DivisionByZeroFloatFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0/0.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(RedefinitionFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(RedefinitionFailTest, InterpreterType, Interpreters) {
   std::string program =
       "fn print() { return 0; } fn main() { return print(0); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ReturnPrintFail) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReturnPrintFail, InterpreterType, Interpreters) {
   std::string program =
       "fn main() { return print(0); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(AdditionTwoTypesFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(AdditionTwoTypesFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 5.0; var b = 6; return a + b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(VariableScopeFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(VariableScopeFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 5; mut var b; if(true) { var a = "
                         "7; b = a; } return a + b; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ExpressionFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ExpressionFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0 * 3 / 10.0; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ModuloFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ModuloFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return 5.0 % \"test\"; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ReturningFunctionWithNoReturnValueFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReturningFunctionWithNoReturnValueFailTest, InterpreterType, Interpreters) {
   std::string program =
       "fn test(var a) {} fn main() { return test(10); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(ReturningFunctionWithNoReturnValueFailTest2) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReturningFunctionWithNoReturnValueFailTest2, InterpreterType, Interpreters) {
   std::string program =
       "fn test(var a) { return; } fn main() { return test(10); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(RedefinitionInArgumentFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(RedefinitionInArgumentFailTest, InterpreterType, Interpreters) {
   std::string program = "fn test(var a) { var a = 5; return a; } fn main() { return test(10); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(StringToBoolFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(StringToBoolFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { return bool(\"test\"); }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(AssignValueTwiceFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(AssignValueTwiceFailTest, InterpreterType, Interpreters) {
   std::string program = "fn main() { var a = 5; a = 5.14; return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
 }
 
-BOOST_AUTO_TEST_CASE(NoMainFailTest) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(NoMainFailTest, InterpreterType, Interpreters) {
   std::string program = "fn test() { var a = 5; a = 5.14; return a; }";
-  auto interpreter = configureInterpreter(program);
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(IfWithoutElseTest, InterpreterType, Interpreters) {
+  std::string program =
+      "fn main() { mut var a = 1; if (a > 5) { a = 2; } return a; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(LoopSumTest, InterpreterType, Interpreters) {
+  std::string program =
+      "fn main() { mut var i = 0; mut var sum = 0; while (i < 100) { "
+      "sum = sum + i; i = i + 1; } return sum; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 4950);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(DeepFibTest, InterpreterType, Interpreters) {
+  std::string program =
+      "fn fib(var n) { if (n <= 1) {return n;} else { return fib(n-1) + "
+      "fib(n-2);}} fn main() { return fib(15); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 610);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(UndeclaredVariableFailTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn main() { return b; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(UnknownFunctionFailTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn main() { return test(1); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(MainParametersTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn main(var p, mut var q) { q = q + 1; return p + q; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 1);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(VariableErrorMessageTest, InterpreterType,
+                              Interpreters) {
+  auto message = [](const std::string &inProgram) {
+    try {
+      configureInterpreter<InterpreterType>(inProgram)->execute();
+    } catch (const InterpreterError &error) {
+      return std::string(error.what());
+    }
+    return std::string();
+  };
+
+  BOOST_CHECK_EQUAL(message("fn main() { return b; }"),
+                    "No variable with such name b!");
+  BOOST_CHECK_EQUAL(message("fn main() { b = 1; return 0; }"),
+                    "Variable b is not declared!");
+  BOOST_CHECK_EQUAL(message("fn main(var p) { p = 1; return p; }"),
+                    "Not mutable variable p cannot be modified!");
+  BOOST_CHECK_EQUAL(message("fn main() { var c = 1; var c = 2; return c; }"),
+                    "New declaration of local variable named c found!");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(StaticTypeErrorTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn sub(var a, var b) { return a - b; } fn main() { "
+                        "print(1); return sub(\"a\", 1); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Cannot calculate (-) on string and int in "
+                                 "function sub!";
+                        });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(UncalledTypeErrorTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn unused() { return \"a\" - 1; } fn main() { "
+                        "mut var a = 1; a = 2.5; return a * 2.0; }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<float>(interpreter->execute()->first), 5.0f);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ConditionalTypeErrorTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn sub(var a) { return a - 1; } fn main(var p) { mut var x = \"s\"; "
+      "if (1 > 2) { x = 1; } if (p > 0) { return x - 1; } if (p > 0) { "
+      "return sub(\"a\"); } return x; }";
+
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first), "s");
+  auto optimized = configureOptimizedInterpreter<InterpreterType>(program);
+  BOOST_CHECK_EQUAL(std::get<std::string>(optimized->execute()->first), "s");
+}
+
+BOOST_AUTO_TEST_CASE(OperandTypeAnnotationTest) {
+  std::string program = "fn twice(var x) { return x + x; } fn main() { var "
+                        "a = twice(2); return twice(a); }";
+  auto parser = configureParser(program);
+  Program *parsedProgram = parser->parseProgram();
+  Resolver resolver;
+  resolver.resolve(*parsedProgram);
+  TypeInference typeInference;
+  typeInference.infer(*parsedProgram);
+
+  const auto *returnInstruction = dynamic_cast<const InstructionReturn *>(
+      parsedProgram->getFunctions()[0]
+          ->getBlock()
+          ->getInstructions()[0]
+          .get());
+  const auto *sum = dynamic_cast<const BinaryExpression *>(
+      returnInstruction->getExpression());
+  BOOST_CHECK(sum->getOperandType() == RuntimeValue::Type::Int);
+}
+
+BOOST_AUTO_TEST_CASE(PurityAnalysisTest) {
+  std::string program =
+      "fn fib(var n) { if (n <= 1) { return n; } return fib(n - 1) + fib(n - "
+      "2); } fn loud(var n) { print(string(n)); if (n > 0) { return loud(n - "
+      "1); } return 0; } fn calls(var n) { if (n > 0) { return calls(n - 1) + "
+      "loud(0); } return 0; } fn count(mut var n) { n = n - 1; if (n > 0) { "
+      "return count(n); } return n; } fn twice(var x) { return int(x) * 2; } "
+      "fn main() { return fib(3); }";
+  auto parser = configureParser(program);
+  Program *parsedProgram = parser->parseProgram();
+  PurityAnalysis purityAnalysis;
+  purityAnalysis.analyze(*parsedProgram);
+
+  const auto &functions = parsedProgram->getFunctions();
+  BOOST_CHECK(purityAnalysis.isPure(*functions[0]));
+  BOOST_CHECK(functions[0]->isMemoized());
+  BOOST_CHECK(!purityAnalysis.isPure(*functions[1]));
+  BOOST_CHECK(!purityAnalysis.isPure(*functions[2]));
+  BOOST_CHECK(!purityAnalysis.isPure(*functions[3]));
+  BOOST_CHECK(purityAnalysis.isPure(*functions[4]));
+  BOOST_CHECK(!functions[4]->isMemoized());
+}
+
+BOOST_AUTO_TEST_CASE(MemoizedRecursionTest) {
+  std::string program = "fn fib(var n) { if (n <= 1) { return n; } return "
+                        "fib(n - 1) + fib(n - 2); } fn main() { return "
+                        "fib(40); }";
+  auto interpreter =
+      std::make_unique<VisitorInterpreterImpl>(configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 102334155);
+  BOOST_CHECK_EQUAL(interpreter->getMemoizedCallCount(), 38);
+}
+
+BOOST_AUTO_TEST_CASE(MemoTableEvictionTest) {
+  MemoTable table(2);
+  MemoTable::Key one, two, three, text;
+  BOOST_CHECK(MemoTable::appendKey(RuntimeValue(1), one));
+  BOOST_CHECK(MemoTable::appendKey(RuntimeValue(2), two));
+  BOOST_CHECK(MemoTable::appendKey(RuntimeValue(3), three));
+  BOOST_CHECK(!MemoTable::appendKey(RuntimeValue(std::string("3")), text));
+
+  table.insert(one, RuntimeValue(10));
+  table.insert(two, RuntimeValue(20));
+  BOOST_CHECK_EQUAL(table.find(one)->getInt(), 10);
+  table.insert(three, RuntimeValue(30));
+
+  BOOST_CHECK_EQUAL(table.getSize(), 2);
+  BOOST_CHECK(table.find(two) == nullptr);
+  BOOST_CHECK_EQUAL(table.find(one)->getInt(), 10);
+  BOOST_CHECK_EQUAL(table.find(three)->getInt(), 30);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(TailCallTest, InterpreterType, Interpreters) {
+  std::string program =
+      "fn count(var n, mut var total) { if (n == 0) { return total; } total = "
+      "total + 2; return count(n - 1, total); } fn even(var n) { if (n == 0) "
+      "{ return true; } return odd(n - 1); } fn odd(var n) { if (n == 0) { "
+      "return false; } return even(n - 1); } fn main() { if (even(100001)) { "
+      "return 0; } return count(3000000, 0); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 6000000);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(DeepRecursionTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn depth(var n) { if (n == 0) { return 0; } return 1 "
+                        "+ depth(n - 1); } fn main() { return depth(200000); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 200000);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(MaxCallDepthTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn text(var n) { if (n == 0) { return \"\"; } return "
+                        "\"a\" + text(n - 1); } fn main() { return text(1000); "
+                        "}";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+  interpreter->setMaxCallDepth(100);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Maximum call depth of 100 exceeded!";
+                        });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(NestedBuiltinRecursionTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn f(var n) { if (n == 0) { return 0; } return "
+                        "int(string(int(string(f(n - 1) + 1)))); } fn main() "
+                        "{ return f(2999); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+  interpreter->setMaxCallDepth(3000);
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2999);
+
+  program = "fn f(var n) { if (n == 0) { return 0; } print(string(int(f(n - "
+            "1)))); return n; } fn main() { return f(3000); }";
+  interpreter = configureInterpreter<InterpreterType>(program);
+  interpreter->setMaxCallDepth(3000);
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Maximum call depth of 3000 exceeded!";
+                        });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(BuiltinCallDepthTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn f(var n) { if (n == 0) { return int(string(n)); "
+                        "} return 1 + f(n - 1); } fn main() { return f(9); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+  interpreter->setMaxCallDepth(10);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 9);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(TailCallWithoutValueTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn nothing(var n) { var x = n; } fn main() { return "
+                        "nothing(1); }";
+  auto interpreter = configureInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "FunctionCallExpression has to return value";
+                        });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(BYTECODE)
+
+BOOST_AUTO_TEST_CASE(CompiledLoopTest) {
+  std::string program = "fn main() { mut var a = 0; while (a < 3) { a = a + "
+                        "1; } return a; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 3);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("TestLess 0") != std::string::npos);
+  BOOST_CHECK(listing.find("DeclareMutableLocal") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedExecutionTest) {
+  std::string program =
+      "fn main() { var a = 5; return a * 2; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 10);
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 10);
+}
+
+BOOST_AUTO_TEST_CASE(QuickenedLoopTest) {
+  std::string program = "fn main() { mut var a = 0; mut var b = a < 20; while "
+                        "(b) { a = a + 1; b = a < 20; } return a; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 20);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("LessInt") != std::string::npos);
+  BOOST_CHECK(listing.find("SumInt") != std::string::npos);
+  BOOST_CHECK_EQUAL(interpreter->getQuickenedInstructionCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(DeoptimizationTest) {
+  std::string program =
+      "fn half(var x, var y) { return x / y; } fn main() { mut var i = 0; mut "
+      "var a = 0; while (i < 10) { i = i + 1; a = half(8, 2); } var b = "
+      "half(3.0, 2.0); var c = half(\"a\", \"b\"); return b; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Cannot calculate (/)!";
+                        });
+  BOOST_CHECK_EQUAL(interpreter->getDeoptimizedInstructionCount(), 1);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("DivisionInt") == std::string::npos);
+  BOOST_CHECK(listing.find("Division " + std::to_string(Unquickenable)) !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(BranchChainTest) {
+  std::string program = "fn main() { mut var a = 0; var b = false; while (b "
+                        "|| (a < 3)) { a = a + 1; } return a; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 3);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("JumpIfTrue") != std::string::npos);
+  BOOST_CHECK(listing.find("TestLess 0") != std::string::npos);
+  BOOST_CHECK(listing.find("LogicalOr") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(StringMatchSwitchTest) {
+  std::string program = "fn main() { var s = \"b\"; match (s) { case \"a\": { "
+                        "return 1; } case \"b\": { return 2; } case s == "
+                        "\"c\": { return 3; } } return 0; }";
+  auto interpreter = std::make_unique<BytecodeInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2);
+  BOOST_CHECK(interpreter->getProgram()->toString().find("Switch") ==
+              std::string::npos);
+
+  program = "fn main() { var s = \"b\"; match (s) { case \"a\": { return 1; "
+            "} case \"b\": { return 2; } } return 0; }";
+  interpreter = std::make_unique<BytecodeInterpreter>(configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 2);
+  BOOST_CHECK(interpreter->getProgram()->toString().find(
+                  "(perfect hash of 4)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(REGISTER)
+
+BOOST_AUTO_TEST_CASE(CompiledLoopTest) {
+  std::string program = "fn main() { mut var a = 0; while (a < 3) { a = a + "
+                        "1; } return a; }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 3);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("TestLess r0, k") != std::string::npos);
+  BOOST_CHECK(listing.find("JumpIfLoopFalse") == std::string::npos);
+  BOOST_CHECK(listing.find("CheckAssignable") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(ShortCircuitValueTest) {
+  std::string program = "fn main() { var a = 2; var b = (a > 1) || ((a / 0) "
+                        "> 1); return b; }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<bool>(interpreter->execute()->first), true);
+  BOOST_CHECK(interpreter->getProgram()->toString().find("ShortCircuitOr") !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LiteralMatchSwitchTest) {
+  std::string program = "fn main() { var n = 5; match (n) { case 1: { return "
+                        "1; } case 2: { return 2; } case 4: { return 4; } case "
+                        "true: { return 0; } } }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 0);
+  const std::string listing = interpreter->getProgram()->toString();
+  BOOST_CHECK(listing.find("Switch r0, 0 (jump table of 4, default 3)") !=
+              std::string::npos);
+  BOOST_CHECK(listing.find("MatchCase") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(RegisterReuseTest) {
+  std::string program = "fn main() { var a = 1; var b = a + 1; var c = b + 1; "
+                        "var d = c + 1; return d; }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 4);
+  BOOST_CHECK(interpreter->getProgram()->toString().find(
+                  "fn main (frame: 2)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(PhiCycleTest) {
+  std::string program = "fn main() { mut var a = 1; mut var b = 2; mut var t = "
+                        "0; mut var i = 0; while (i < 3) { t = a; a = b; b = "
+                        "t; i = i + 1; } return (a * 10) + b; }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 21);
+}
+
+BOOST_AUTO_TEST_CASE(NestedCallArgumentsTest) {
+  std::string program = "fn add(var a, var b) { return a + b; } fn main() { return "
+                        "add(add(1, 2), add(3, add(4, 5))); }";
+  auto interpreter = std::make_unique<RegisterInterpreter>(
+      configureParser(program));
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 15);
+  BOOST_CHECK_LT(interpreter->getExecutedInstructionCount(), 30);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(JIT)
+
+BOOST_AUTO_TEST_CASE(CompiledRecursionTest) {
+  std::string program = "fn fib(var n) { if (n <= 1) { return n; } return "
+                        "fib(n - 1) + fib(n - 2); } fn main() { return "
+                        "fib(20); }";
+  auto interpreter = std::make_unique<VisitorInterpreterImpl>(
+      configureParser(program), 1);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 6765);
+  BOOST_CHECK_EQUAL(interpreter->getJit()->getCompiledCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CompiledFloatLoopTest) {
+  std::string program =
+      "fn scale(var x, var n) { mut var i = 0; mut var sum = 0.0; while (i < "
+      "n) { sum = sum + (x * 1.5); i = i + 1; } if (sum > 10.0) { return -sum; "
+      "} return sum % 4.0; } fn main() { return scale(2.0, 3) + scale(2.0, "
+      "4); }";
+  auto interpreter = std::make_unique<VisitorInterpreterImpl>(
+      configureParser(program), 1);
+
+  BOOST_CHECK_EQUAL(std::get<float>(interpreter->execute()->first), -11.0f);
+  BOOST_CHECK_EQUAL(interpreter->getJit()->getCompiledCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(NativeErrorFallbackTest) {
+  std::string program = "fn divide(var a, var b) { return a / b; } fn main() "
+                        "{ var x = divide(6, 3); return divide(x, 0); }";
+  auto interpreter = std::make_unique<VisitorInterpreterImpl>(
+      configureParser(program), 1);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Cannot divide by 0!";
+                        });
+}
+
+BOOST_AUTO_TEST_CASE(CompiledMaxCallDepthTest) {
+  std::string program = "fn f(var x) { if (x == 0) { return 0; } return 1 + "
+                        "f(x - 1); } fn main() { return f(200000); }";
+  auto interpreter = std::make_unique<VisitorInterpreterImpl>(
+      configureParser(program), 1);
+  interpreter->setMaxCallDepth(1000);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Maximum call depth of 1000 exceeded!";
+                        });
+  BOOST_CHECK_EQUAL(interpreter->getJit()->getCompiledCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(UnsupportedFunctionTest) {
+  std::string program = "fn greet(var name) { return \"hi \" + name; } fn "
+                        "count(mut var n) { while (n > 0) { var x = n; n = n "
+                        "- 1; } return n; } fn main() { count(2); return "
+                        "greet(\"you\"); }";
+  auto interpreter = std::make_unique<VisitorInterpreterImpl>(
+      configureParser(program), 1);
 
   BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+  BOOST_CHECK_EQUAL(interpreter->getJit()->getCompiledCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(AOT)
+
+BOOST_AUTO_TEST_CASE(EmitFunctionsTest) {
+  std::string program = "fn twice(var x) { return x * 2; } fn main(var a) { "
+                        "print(\"a\tb\"); return twice(a); }";
+  auto parser = configureParser(program);
+  CEmitter emitter;
+  std::string code = emitter.emit(*parser->parseProgram());
+
+  BOOST_CHECK(code.find("static tkom::Value f_twice(std::array<tkom::Value, "
+                        "1> arguments);") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::Op::Multiplication") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::print(tkom::Value(std::string(\"a\\tb\")))") !=
+              std::string::npos);
+  BOOST_CHECK(code.find("tkom::call(f_main, std::array<tkom::Value, "
+                        "1>{tkom::Value(0)})") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(EmitCallDepthTest) {
+  std::string program =
+      "fn sum(var n, var acc) { if (n == 0) { return acc; } "
+      "return sum(n - 1, acc + n); } "
+      "fn depth(var n) { if (n == 0) { return 0; } return 1 + depth(n - 1); } "
+      "fn main() { return sum(300000, depth(100000)); }";
+  auto parser = configureParser(program);
+  CEmitter emitter(100);
+  std::string code = emitter.emit(*parser->parseProgram());
+
+  BOOST_CHECK(code.find("tkom::run(100, [] {") != std::string::npos);
+  BOOST_CHECK(code.find("Maximum call depth of ") != std::string::npos);
+  /* Only the returned call of sum to itself reuses its frame */
+  BOOST_CHECK(code.find("goto tailCall;") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::call(f_sum") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::call(f_depth") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::Value f_sum(std::array<tkom::Value, 2> "
+                        "arguments) {\n  bool bTailCalled = false;\n"
+                        "tailCall:\n") != std::string::npos);
+  BOOST_CHECK(code.find("tkom::Value f_depth(std::array<tkom::Value, 1> "
+                        "arguments) {\n  std::array") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(EmitUnknownFunctionTest) {
+  std::string program = "fn main() { return missing(1); }";
+  auto parser = configureParser(program);
+  CEmitter emitter;
+  std::string code = emitter.emit(*parser->parseProgram());
+
+  BOOST_CHECK(code.find("No function found with such name: missing!") !=
+              std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(EmitRedefinitionTest) {
+  std::string program = "fn main() { return 1; } fn main() { return 2; }";
+  auto parser = configureParser(program);
+  CEmitter emitter;
+
+  BOOST_CHECK_THROW(emitter.emit(*parser->parseProgram()), InterpreterError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(OPTIMIZER)
+
+BOOST_AUTO_TEST_CASE(FoldConstantsTest) {
+  std::string program = "fn main() { var a = 2 * 3; mut var b = (a + 1) * a; "
+                        "var c = string(float(a)) + \"!\"; return -b; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->toString(),
+                    "fn main(){var a=6;mut var b=42;var c=\"6.000000!\";return -b;}");
+}
+
+BOOST_AUTO_TEST_CASE(FoldShortCircuitTest) {
+  std::string program = "fn pick(var a, var b) { return a || b; } fn main() { "
+                        "var t = true || (1 / 0); var x = 0; return pick(x "
+                        "== 1, (10 / x) == 1) && t; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  const std::string optimized = parser->getParsedProgram()->toString();
+  BOOST_CHECK(optimized.find("var t=true;") != std::string::npos);
+  BOOST_CHECK(optimized.find("pick(") != std::string::npos);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_CASE(KeepFailingOperationsTest) {
+  std::string program = "fn main() { var a = 0; var b = 1 / a; var c = -\"x\"; "
+                        "return int(\"y\"); }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+
+  BOOST_CHECK_NO_THROW(optimizer.optimize(*parser->parseProgram()));
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->toString(),
+                    "fn main(){var a=0;var b=1/0;var c=-\"x\";return int(\"y\");;}");
+}
+
+BOOST_AUTO_TEST_CASE(PropagateDeclaredOnlyTest) {
+  std::string program = "fn f(var c) { if (c) { var x = 1; return x; } "
+                        "return x; } fn main() { return f(false); }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->toString(),
+                    "fn f(var c){if(c){var x=1;return 1;}return x;}fn main(){return f(false);;}");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedResultTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn twice(var x) { var two = 2; return x * two; } fn main() { "
+      "var a = 4; mut var b = 0; while (b < (a * 10)) { b = b + twice(a - 1); "
+      "} return string(b) + string(a % 3); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "421");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedDivisionByZeroTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn main() { var a = 0; if (a > 0) { return 1 / a; } return 10 % a; }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedDivisionOverflowTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn main() { var m = (0 - 2147483647) - 1; if (m > 0) { return m / (0 - "
+      "1); } var x = 7; if (x == 7) { return x; } return m % (0 - 1); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 7);
+
+  program = "fn main() { var m = (0 - 2147483647) - 1; return m / (0 - 1); }";
+  interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Integer overflow in division!";
+                        });
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedSignedZeroTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn main() { mut var a = -0.0; mut var b = 0.0; "
+                        "return string(a) + string(b); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "-0.0000000.000000");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedUndeclaredTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn f(var c) { if (c) { var x = 1; } return x; } "
+                        "fn main() { return f(false); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE(EliminateDeadCodeTest) {
+  std::string program =
+      "fn unused() { return 1; } fn used(var a) { print(a); return a; } "
+      "fn main() { var debug = false; if (debug) { print(\"x\"); } else { "
+      "mut var b = used(1); } while (debug) { b = 2; } match (b) { case 2: "
+      "{ b = 3; } "
+      "case true: { b = 4; } case 5: { b = 5; } } return b; b = 6; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->toString(),
+                    "fn used(var a){print(a);return a;}fn main(){var debug="
+                    "false;mut var b=used(1);;match(b){case 2:{b=3;}case "
+                    "true:{b=4;}}return b;}");
+}
+
+BOOST_AUTO_TEST_CASE(KeepRedefinedFunctionsTest) {
+  std::string program = "fn f() { return 1; } fn f() { return 2; } "
+                        "fn print(var a) { } fn main() { return 3; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->getFunctions().size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(OptimizedBranchesTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn sign(var x) { if (x < 0) { return -1; } else { return 1; } "
+      "return 0; } fn main() { var n = 3; mut var r = 0; if (n > 2) { r = "
+      "sign(0 - n); } match (n) { case 1: { r = 10; } case 3: { r = r * 2; } "
+      "case _ > 0: { r = 20; } } return r; }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), -2);
+}
+
+BOOST_AUTO_TEST_CASE(InlineCallsTest) {
+  std::string program =
+      "fn mul(var a, var b) { return a * b; } fn square(var x) { return "
+      "mul(x, x); } fn fact(var n) { if (n < 2) { return 1; } return n * "
+      "fact(n - 1); } fn main(var n) { mut var r = square(n) + mul(n, 2); "
+      "r = mul(fact(n), 3); return mul(n + 1, n); }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(parser->getParsedProgram()->toString(),
+                    "fn mul(var a,var b){return a*b;}fn fact(var n){if(n<2){"
+                    "return 1;}return n*fact(n-1);;}fn main(var n){mut var "
+                    "r=n*n=n*2;r=mul(fact(n);,3);;return n=1*n;}");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(InlinedResultTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn inc(mut var a) { return a + 1; } fn twice(var a) { return a + a; } "
+      "fn main() { mut var s = 0; mut var i = 0; while (i < 5) { s = s + "
+      "twice(inc(i)); i = inc(i); } return s; }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 30);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(InlinedUnusedArgumentTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn first(var a, var b) { return a; } fn main() { "
+                        "var zero = 0; return first(1, 1 / zero); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_THROW(interpreter->execute(), InterpreterError);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(InlinedArgumentOrderTest, InterpreterType,
+                              Interpreters) {
+  std::string program = "fn g(var a, var b) { return b + a; } fn main() { var "
+                        "z = 0; return g(1 / z, 2 % z); }";
+  std::string nestedProgram =
+      "fn g(var a, var b) { return b + a; } fn inv(var x) { return 1 / x; } "
+      "fn rem(var x) { return 2 % x; } fn main() { var z = 0; return "
+      "g(inv(z), rem(z)); }";
+  auto message = [](std::unique_ptr<Interpreter> inInterpreter) {
+    try {
+      inInterpreter->execute();
+    } catch (const InterpreterError &error) {
+      return std::string(error.what());
+    }
+    return std::string();
+  };
+
+  /* The body reads b first, the arguments still fail in call order */
+  BOOST_CHECK_EQUAL(message(configureInterpreter<InterpreterType>(program)),
+                    "Cannot divide by 0!");
+  BOOST_CHECK_EQUAL(
+      message(configureOptimizedInterpreter<InterpreterType>(program)),
+      "Cannot divide by 0!");
+  BOOST_CHECK_EQUAL(
+      message(configureInterpreter<InterpreterType>(nestedProgram)),
+      "Cannot divide by 0!");
+  BOOST_CHECK_EQUAL(
+      message(configureOptimizedInterpreter<InterpreterType>(nestedProgram)),
+      "Cannot divide by 0!");
+}
+
+BOOST_AUTO_TEST_CASE(HoistInvariantsTest) {
+  std::string program =
+      "fn main(var n) { var limit = n + 10; mut var i = 0; mut var j = 0; "
+      "mut var s = \"\"; while (i < (limit * 2)) { j = 0; while (j < (i / "
+      "2)) { s = string(limit) + string(-i); j = j + 1; } i = i + 1; } "
+      "return s; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(
+      parser->getParsedProgram()->toString(),
+      "fn main(var n){mut var @invariant0;mut var @invariant1;mut var "
+      "@invariant2;var limit=n=10;mut var i=0;mut var j=0;mut var s=\"\";"
+      "@invariant0=limit*2;while(i<@invariant0){j=0;@invariant1=i/2;"
+      "@invariant2=string(limit);=string(-i);;while(j<@invariant1){s="
+      "@invariant2;j=j=1;}i=i=1;}return s;}");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(HoistedResultTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn f(var c, var n) { if (c) { var x = 2; } mut var i = 0; mut var s = "
+      "0; while (i < (n * 3)) { if (c) { s = s + (x * n); } i = i + 1; } "
+      "while (i < 0) { s = s / n; } return s; } fn main() { return f(false, "
+      "0) + f(true, 2); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 24);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(HoistedDivisionOverflowTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn f(var m) { mut var i = 0; mut var s = 0; while (i < 0) { s = m / (0 "
+      "- 1); i = i + 1; } var x = 7; if (x > 0) { return s; } return (m % (0 "
+      "- 1)) + (m % (0 - 1)); } fn main() { return f((0 - 2147483647) - 1); "
+      "}";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<int>(interpreter->execute()->first), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReuseCommonSubexpressionsTest) {
+  std::string program =
+      "fn main(var a, var b, var s) { var x = (a + b) * (a + b); print(int(s) "
+      "- int(s)); mut var y = int(s) * x; y = (a + b) * y; return a + b; }";
+  auto parser = configureParser(program);
+  Optimizer optimizer;
+  optimizer.optimize(*parser->parseProgram());
+
+  BOOST_CHECK_EQUAL(
+      parser->getParsedProgram()->toString(),
+      "fn main(var a,var b,var s){mut var @common0;mut var @common1;"
+      "@common0=a=b;var x=@common0*@common0;@common1=int(s);;print(@common1-"
+      "@common1);mut var y=@common1*x;y=@common0*y;return @common0;}");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReusedResultTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn f(mut var a, var b) { var x = (a - b) * (a - b); a = a + 1; mut var "
+      "y = (a - b) * (a - b); return string(y) + (string(x) + string(x)); } "
+      "fn main() { return f(3, 1); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EQUAL(std::get<std::string>(interpreter->execute()->first),
+                    "944");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ReusedFailingOrderTest, InterpreterType,
+                              Interpreters) {
+  std::string program =
+      "fn f(var s, var a, var b) { mut var r = \"\"; r = string(bool(s)) + "
+      "string((a / b) + (a / b)); return r; } fn main() { return f(\"x\", 1, "
+      "0); }";
+  auto interpreter = configureOptimizedInterpreter<InterpreterType>(program);
+
+  BOOST_CHECK_EXCEPTION(interpreter->execute(), InterpreterError,
+                        [](const InterpreterError &error) {
+                          return std::string(error.what()) ==
+                                 "Cannot convert string to bool!";
+                        });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(IR)
+
+std::unique_ptr<IrProgram> buildIr(const std::string_view &program) {
+  auto parser = configureParser(program);
+  return IrBuilder().build(*parser->parseProgram());
+}
+
+BOOST_AUTO_TEST_CASE(IrDumpTest) {
+  std::string program = "fn f(var c, mut var n) { if (c) { var x = 1; } mut var "
+                        "s = 0; while (0 < n) { s = s + x; n = n - 1; } return "
+                        "s; }";
+  auto ir = buildIr(program);
+
+  BOOST_CHECK_NO_THROW(IrVerifier().verify(*ir));
+  BOOST_CHECK_EQUAL(ir->toString(), "fn f(c, mut n)\n"
+                                    "bb0:\n"
+                                    "  %0 = Parameter 0 c\n"
+                                    "  %1: bool = Constant false\n"
+                                    "  %2 = Parameter 1 n\n"
+                                    "  %3: bool = Constant true\n"
+                                    "  %4 = Undefined\n"
+                                    "  %5: int = Constant 1\n"
+                                    "  %6: int = Constant 0\n"
+                                    "  Branch %0, bb1, bb2\n"
+                                    "bb1: ; from bb0\n"
+                                    "  Jump bb2\n"
+                                    "bb2: ; from bb0 bb1\n"
+                                    "  %7: bool = Phi [bb0: %4], [bb1: %1]\n"
+                                    "  %8: int = Phi [bb0: %4], [bb1: %5]\n"
+                                    "  Jump bb3\n"
+                                    "bb3: ; from bb2 bb4\n"
+                                    "  %9: int = Phi [bb2: %6], [bb4: %12]\n"
+                                    "  %10 = Phi [bb2: %2], [bb4: %13]\n"
+                                    "  %11: bool = Less %6, %10\n"
+                                    "  LoopBranch %11, bb4, bb5\n"
+                                    "bb4: ; from bb3\n"
+                                    "  CheckDeclared x, %7\n"
+                                    "  %12: int = Sum %9, %8\n"
+                                    "  %13 = Substraction %10, %5\n"
+                                    "  Jump bb3\n"
+                                    "bb5: ; from bb3\n"
+                                    "  Return %9\n");
+}
+
+BOOST_AUTO_TEST_CASE(IrShortCircuitTest) {
+  std::string program = "fn f(var a, var b) { return a && b; }";
+  auto ir = buildIr(program);
+
+  BOOST_CHECK_NO_THROW(IrVerifier().verify(*ir));
+  BOOST_CHECK_EQUAL(ir->toString(), "fn f(a, b)\n"
+                                    "bb0:\n"
+                                    "  %0 = Parameter 0 a\n"
+                                    "  %1: bool = Constant false\n"
+                                    "  %2 = Parameter 1 b\n"
+                                    "  ShortCircuitAnd %0, bb2, bb1\n"
+                                    "bb1: ; from bb0\n"
+                                    "  %3: bool = LogicalAnd %0, %2\n"
+                                    "  Jump bb2\n"
+                                    "bb2: ; from bb0 bb1\n"
+                                    "  %4: bool = Phi [bb0: %1], [bb1: %3]\n"
+                                    "  Return %4\n");
+}
+
+BOOST_AUTO_TEST_CASE(IrOptimizedDumpTest) {
+  std::string program = "fn f(var a) { var debug = false; var x = (a * 2) + (a "
+                        "* 2); if (debug) { print(x); } return string(1 + 2) + "
+                        "string(x); }";
+  auto ir = buildIr(program);
+  IrOptimizer optimizer;
+  optimizer.optimize(*ir);
+
+  BOOST_CHECK_EQUAL(ir->toString(), "fn f(a)\n"
+                                    "bb0:\n"
+                                    "  %0: string = Constant \"3\"\n"
+                                    "  %1 = Parameter 0 a\n"
+                                    "  %2: int = Constant 2\n"
+                                    "  %3 = Multiplication %1, %2\n"
+                                    "  %4 = Sum %3, %3\n"
+                                    "  %5: string = ToString %4\n"
+                                    "  %6: string = Sum %0, %5\n"
+                                    "  Return %6\n");
+  BOOST_CHECK_GT(optimizer.getFoldedCount(), 0);
+  BOOST_CHECK_GT(optimizer.getNumberedCount(), 0);
+  BOOST_CHECK_GT(optimizer.getEliminatedCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(IrDivisionOverflowTest) {
+  std::string program = "fn f(var a) { var m = (0 - 2147483647) - 1; var q = "
+                        "m / (0 - 1); var r = a % (0 - 1); return 7; }";
+  auto ir = buildIr(program);
+  IrOptimizer optimizer;
+  BOOST_CHECK_NO_THROW(optimizer.optimize(*ir));
+
+  const std::string optimized = ir->toString();
+  BOOST_CHECK(optimized.find("= Division") != std::string::npos);
+  BOOST_CHECK(optimized.find("= Modulo") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(IrVerifierTest) {
+  IrFunction function("f");
+  function.createBlock()->append(
+      std::make_unique<IrInstruction>(IrOpCode::Undefined));
+
+  BOOST_CHECK_THROW(IrVerifier().verify(function), InterpreterError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()